@@ -0,0 +1,262 @@
+/****************************************************************************
+ * Copyright (c) 2018-2022 by the Cabana authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the Cabana library. Cabana is distributed under a   *
+ * BSD 3-clause license. For the licensing terms see the LICENSE file in    *
+ * the top-level directory.                                                 *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#include "../Cabana_BenchmarkUtils.hpp"
+
+#include <Cabana_Core.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifdef Cabana_ENABLE_ARBORX
+//---------------------------------------------------------------------------//
+// Nearest neighbor queries for every particle in a slice.
+template <class Slice>
+struct NearestQueries
+{
+    using slice_type = Slice;
+    using memory_space = typename Slice::memory_space;
+    using size_type = typename Slice::size_type;
+    Slice slice;
+    int k;
+};
+
+namespace ArborX
+{
+template <class Slice>
+struct AccessTraits<NearestQueries<Slice>, PredicatesTag>
+{
+    using memory_space = typename Slice::memory_space;
+    using size_type = typename Slice::size_type;
+    static KOKKOS_FUNCTION size_type size( NearestQueries<Slice> const& q )
+    {
+        return q.slice.size();
+    }
+    static KOKKOS_FUNCTION auto get( NearestQueries<Slice> const& q,
+                                     size_type i )
+    {
+        auto const point =
+            AccessTraits<Slice, PrimitivesTag>::get( q.slice, i );
+        // The query particle is found as its own nearest neighbor.
+        return nearest( point, q.k + 1 );
+    }
+};
+} // namespace ArborX
+#endif
+
+//---------------------------------------------------------------------------//
+// Performance test.
+template <class Device>
+void performanceTest( std::ostream& stream, const std::string& test_prefix,
+                      std::vector<int> problem_sizes,
+                      std::vector<int> num_neighbors )
+{
+    using exec_space = typename Device::execution_space;
+    using memory_space = typename Device::memory_space;
+
+    // Declare problem sizes.
+    int num_problem_size = problem_sizes.size();
+    std::vector<double> x_min( num_problem_size );
+    std::vector<double> x_max( num_problem_size );
+
+    // Number of runs in the test loops.
+    int num_run = 10;
+
+    // Define the aosoa.
+    using member_types = Cabana::MemberTypes<double[3]>;
+    using aosoa_type = Cabana::AoSoA<member_types, Device>;
+    std::vector<aosoa_type> aosoas( num_problem_size );
+
+    // Create aosoas. Particles are sorted for spatial locality.
+    for ( int p = 0; p < num_problem_size; ++p )
+    {
+        int num_p = problem_sizes[p];
+
+        // Define problem grid with a density of roughly one particle per
+        // unit volume.
+        x_min[p] = 0.0;
+        x_max[p] = std::pow( num_p, 1.0 / 3.0 );
+        aosoas[p].resize( num_p );
+        auto x = Cabana::slice<0>( aosoas[p], "position" );
+        Cabana::createRandomParticles( x, x.size(), x_min[p], x_max[p] );
+
+        double sort_delta[3] = { 1.0, 1.0, 1.0 };
+        double grid_min[3] = { x_min[p], x_min[p], x_min[p] };
+        double grid_max[3] = { x_max[p], x_max[p], x_max[p] };
+        Cabana::LinkedCellList<Device> linked_cell_list( x, sort_delta,
+                                                         grid_min, grid_max );
+        Cabana::permute( linked_cell_list, aosoas[p] );
+    }
+
+    // Loop over the number of neighbors per particle.
+    for ( std::size_t c = 0; c < num_neighbors.size(); ++c )
+    {
+        int k = num_neighbors[c];
+
+        // Create timers.
+        std::stringstream create_time_name;
+        create_time_name << test_prefix << "knn_create_" << k;
+        Cabana::Benchmark::Timer create_timer( create_time_name.str(),
+                                               num_problem_size );
+        std::stringstream iteration_time_name;
+        iteration_time_name << test_prefix << "knn_iteration_" << k;
+        Cabana::Benchmark::Timer iteration_timer( iteration_time_name.str(),
+                                                  num_problem_size );
+#ifdef Cabana_ENABLE_ARBORX
+        std::stringstream arborx_time_name;
+        arborx_time_name << test_prefix << "knn_arborx_create_" << k;
+        Cabana::Benchmark::Timer arborx_timer( arborx_time_name.str(),
+                                               num_problem_size );
+#endif
+
+        // Loop over the problem sizes.
+        std::vector<int> psizes;
+        for ( int p = 0; p < num_problem_size; ++p )
+        {
+            int num_p = problem_sizes[p];
+            std::cout << "Running k = " << k << " for " << num_p
+                      << " total particles" << std::endl;
+
+            // Track the problem size.
+            psizes.push_back( problem_sizes[p] );
+
+            auto x = Cabana::slice<0>( aosoas[p], "position" );
+
+            // Cells containing on the order of k particles.
+            double delta = std::cbrt( static_cast<double>( k ) );
+            double grid_delta[3] = { delta, delta, delta };
+            double grid_min[3] = { x_min[p], x_min[p], x_min[p] };
+            double grid_max[3] = { x_max[p], x_max[p], x_max[p] };
+
+            // Setup for neighbor iteration.
+            Kokkos::View<int*, memory_space> per_particle_result( "result",
+                                                                  num_p );
+            auto count_op = KOKKOS_LAMBDA( const int i, const int n )
+            {
+                Kokkos::atomic_add( &per_particle_result( i ), n );
+            };
+            Kokkos::RangePolicy<exec_space> policy( 0, num_p );
+
+            // Run tests and time the ensemble.
+            for ( int t = 0; t < num_run; ++t )
+            {
+                // Create the neighbor list.
+                create_timer.start( p );
+                Cabana::KNearestNeighborList<memory_space> nlist(
+                    x, 0, num_p, k, grid_delta, grid_min, grid_max );
+                create_timer.stop( p );
+
+                // Iterate through the neighbor list.
+                iteration_timer.start( p );
+                Cabana::neighbor_parallel_for(
+                    policy, count_op, nlist, Cabana::FirstNeighborsTag(),
+                    Cabana::SerialOpTag(), "test_iteration" );
+                Kokkos::fence();
+                iteration_timer.stop( p );
+
+#ifdef Cabana_ENABLE_ARBORX
+                // Build the tree and query the same neighbors with ArborX.
+                arborx_timer.start( p );
+                exec_space space{};
+                ArborX::BVH<memory_space> bvh( space, x );
+                Kokkos::View<int*, Device> indices(
+                    Kokkos::view_alloc( "indices",
+                                        Kokkos::WithoutInitializing ),
+                    0 );
+                Kokkos::View<int*, Device> offsets(
+                    Kokkos::view_alloc( "offsets",
+                                        Kokkos::WithoutInitializing ),
+                    0 );
+                bvh.query( space, NearestQueries<decltype( x )>{ x, k },
+                           indices, offsets );
+                Kokkos::fence();
+                arborx_timer.stop( p );
+#endif
+            }
+        }
+
+        // Output results.
+        outputResults( stream, "problem_size", psizes, create_timer );
+        outputResults( stream, "problem_size", psizes, iteration_timer );
+#ifdef Cabana_ENABLE_ARBORX
+        outputResults( stream, "problem_size", psizes, arborx_timer );
+#endif
+    }
+}
+
+//---------------------------------------------------------------------------//
+// main
+int main( int argc, char* argv[] )
+{
+    // Initialize environment
+    Kokkos::initialize( argc, argv );
+
+    // Check arguments.
+    if ( argc < 2 )
+        throw std::runtime_error( "Incorrect number of arguments. \n \
+             First argument -  file name for output \n \
+             Optional second argument - run size (small or large) \n \
+             \n \
+             Example: \n \
+             $/: ./KNearestNeighborPerformance test_results.txt\n" );
+
+    // Get the name of the output file.
+    std::string filename = argv[1];
+
+    // Define run sizes.
+    std::string run_type = "";
+    if ( argc > 2 )
+        run_type = argv[2];
+    std::vector<int> problem_sizes = { 100, 1000 };
+    std::vector<int> num_neighbors = { 8, 16 };
+    if ( run_type == "large" )
+    {
+        problem_sizes = { 1000, 10000, 100000, 1000000 };
+        num_neighbors = { 8, 16, 32, 64 };
+    }
+
+    // Open the output file on rank 0.
+    std::fstream file;
+    file.open( filename, std::fstream::out );
+
+    // Do everything on the default CPU.
+    using host_exec_space = Kokkos::DefaultHostExecutionSpace;
+    using host_device_type = host_exec_space::device_type;
+    // Do everything on the default device with default memory.
+    using exec_space = Kokkos::DefaultExecutionSpace;
+    using device_type = exec_space::device_type;
+
+    // Don't run twice on the CPU if only host enabled.
+    if ( !std::is_same<device_type, host_device_type>{} )
+    {
+        performanceTest<device_type>( file, "device_", problem_sizes,
+                                      num_neighbors );
+    }
+    performanceTest<host_device_type>( file, "host_", problem_sizes,
+                                       num_neighbors );
+
+    // Close the output file on rank 0.
+    file.close();
+
+    // Finalize
+    Kokkos::finalize();
+    return 0;
+}
+
+//---------------------------------------------------------------------------//
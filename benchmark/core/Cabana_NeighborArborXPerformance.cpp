@@ -98,6 +98,11 @@ void performanceTest( std::ostream& stream, const std::string& test_prefix,
                             << cutoff_ratios[c];
         Cabana::Benchmark::Timer iteration_timer( iteration_time_name.str(),
                                                   num_problem_size );
+        std::stringstream reuse_time_name;
+        reuse_time_name << test_prefix << "neigh_reuse_create_"
+                        << cutoff_ratios[c];
+        Cabana::Benchmark::Timer reuse_timer( reuse_time_name.str(),
+                                              num_problem_size );
 
         // Loop over the problem sizes.
         int pid = 0;
@@ -120,6 +125,17 @@ void performanceTest( std::ostream& stream, const std::string& test_prefix,
             };
             Kokkos::RangePolicy<exec_space> policy( 0, num_p );
 
+            // Persistent search which keeps the tree while particles stay
+            // within half of the skin of their positions at the last build.
+            double skin = 0.1 * cutoff_ratios[c];
+            Cabana::Experimental::NeighborSearch<Device, ListTag> search(
+                ListTag{}, skin );
+            auto x = Cabana::slice<0>( aosoas[p], "position" );
+            auto drift_op = KOKKOS_LAMBDA( const int i )
+            {
+                x( i, 0 ) += 0.1 * skin;
+            };
+
             // Run tests and time the ensemble
             for ( int t = 0; t < num_run; ++t )
             {
@@ -139,6 +155,16 @@ void performanceTest( std::ostream& stream, const std::string& test_prefix,
                                                IterTag(), "test_iteration" );
                 Kokkos::fence();
                 iteration_timer.stop( pid );
+
+                // Move the particles slightly and create the neighbor list
+                // again, rebuilding the tree only when needed.
+                Kokkos::parallel_for( "drift", policy, drift_op );
+                Kokkos::fence();
+                reuse_timer.start( pid );
+                auto const reuse_nlist = search.make2DNeighborList(
+                    x, 0, num_p, cutoff );
+                Kokkos::fence();
+                reuse_timer.stop( pid );
             }
 
             // Increment the problem id.
@@ -148,6 +174,7 @@ void performanceTest( std::ostream& stream, const std::string& test_prefix,
         // Output results.
         outputResults( stream, "problem_size", psizes, create_timer );
         outputResults( stream, "problem_size", psizes, iteration_timer );
+        outputResults( stream, "problem_size", psizes, reuse_timer );
     }
 }
 
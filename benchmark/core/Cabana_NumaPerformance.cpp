@@ -0,0 +1,212 @@
+/****************************************************************************
+ * Copyright (c) 2018-2022 by the Cabana authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the Cabana library. Cabana is distributed under a   *
+ * BSD 3-clause license. For the licensing terms see the LICENSE file in    *
+ * the top-level directory.                                                 *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#include "../Cabana_BenchmarkUtils.hpp"
+
+#include <Cabana_Core.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#if defined( KOKKOS_ENABLE_OPENMP )
+#include <omp.h>
+#endif
+
+//---------------------------------------------------------------------------//
+// Get the OpenMP place of the calling thread. Run with OMP_PLACES=sockets
+// (and OMP_PROC_BIND=close or spread) to get one place per socket.
+template <class ExecutionSpace>
+int threadPlace()
+{
+#if defined( KOKKOS_ENABLE_OPENMP )
+    if ( std::is_same<ExecutionSpace, Kokkos::OpenMP>::value )
+        return std::max( omp_get_place_num(), 0 );
+#endif
+    return 0;
+}
+
+//---------------------------------------------------------------------------//
+// Performance test. Triad bandwidth of a host AoSoA initialized serially,
+// as after reading input or a serial copy, with and without first touch
+// placement at allocation.
+template <class Device>
+void performanceTest( std::ostream& stream, const std::string& test_prefix,
+                      std::vector<int> problem_sizes )
+{
+    using exec_space = typename Device::execution_space;
+    using member_types = Cabana::MemberTypes<double, double, double>;
+    using aosoa_type = Cabana::AoSoA<member_types, Device>;
+
+    // Declare problem sizes.
+    int num_problem_size = problem_sizes.size();
+
+    // Number of runs in the test loops.
+    int num_run = 10;
+
+    // One work item per thread so each thread streams the same contiguous
+    // range a static schedule would give it.
+    int num_thread = exec_space().concurrency();
+
+    // Allocation modes.
+    std::vector<std::string> modes = { "default", "first_touch",
+                                       "first_touch_huge_pages" };
+
+    for ( std::size_t m = 0; m < modes.size(); ++m )
+    {
+        Cabana::Benchmark::Timer triad_timer(
+            test_prefix + "triad_" + modes[m], num_problem_size );
+
+        // Bandwidth per place and problem size in GB/s.
+        std::map<int, std::vector<double>> place_bandwidth;
+
+        for ( int p = 0; p < num_problem_size; ++p )
+        {
+            int num_p = problem_sizes[p];
+
+            // Allocate with the placement options.
+            aosoa_type aosoa( "aosoa" );
+            aosoa.setFirstTouch( m > 0 );
+            aosoa.setHugePages( m > 1 );
+            aosoa.resize( num_p );
+
+            // Initialize on the master thread.
+            auto a = Cabana::slice<0>( aosoa );
+            auto b = Cabana::slice<1>( aosoa );
+            auto c = Cabana::slice<2>( aosoa );
+            for ( int i = 0; i < num_p; ++i )
+            {
+                a( i ) = 0.0;
+                b( i ) = 1.0;
+                c( i ) = 2.0;
+            }
+
+            // Per thread timings.
+            std::vector<double> thread_time( num_thread );
+            std::vector<int> thread_place( num_thread );
+            double* time_data = thread_time.data();
+            int* place_data = thread_place.data();
+            double scalar = 3.0;
+            auto triad_op = [=]( const int t )
+            {
+                int begin = static_cast<long>( num_p ) * t / num_thread;
+                int end = static_cast<long>( num_p ) * ( t + 1 ) / num_thread;
+                auto start = std::chrono::steady_clock::now();
+                for ( int i = begin; i < end; ++i )
+                    a( i ) = b( i ) + scalar * c( i );
+                std::chrono::duration<double> elapsed =
+                    std::chrono::steady_clock::now() - start;
+                time_data[t] = std::min( time_data[t], elapsed.count() );
+                place_data[t] = threadPlace<exec_space>();
+            };
+            Kokkos::RangePolicy<exec_space, Kokkos::Schedule<Kokkos::Static>>
+                policy( 0, num_thread );
+
+            std::fill( thread_time.begin(), thread_time.end(), 1.0e30 );
+            for ( int t = 0; t < num_run; ++t )
+            {
+                triad_timer.start( p );
+                Kokkos::parallel_for( "triad", policy, triad_op );
+                Kokkos::fence();
+                triad_timer.stop( p );
+            }
+
+            // A place streams its threads' ranges in the time of its
+            // slowest thread. Two loads and one store per tuple.
+            std::map<int, double> place_bytes;
+            std::map<int, double> place_time;
+            for ( int t = 0; t < num_thread; ++t )
+            {
+                int begin = static_cast<long>( num_p ) * t / num_thread;
+                int end = static_cast<long>( num_p ) * ( t + 1 ) / num_thread;
+                place_bytes[thread_place[t]] +=
+                    3.0 * sizeof( double ) * ( end - begin );
+                place_time[thread_place[t]] =
+                    std::max( place_time[thread_place[t]], thread_time[t] );
+            }
+            for ( auto& pb : place_bytes )
+            {
+                auto& bw = place_bandwidth[pb.first];
+                bw.resize( num_problem_size, 0.0 );
+                bw[p] = pb.second / place_time[pb.first] / 1.0e9;
+            }
+        }
+
+        // Output results.
+        outputResults( stream, "problem_size", problem_sizes, triad_timer );
+        stream << "\n"
+               << test_prefix << "triad_bandwidth_" << modes[m] << "\n"
+               << "problem_size";
+        for ( auto& pb : place_bandwidth )
+            stream << " place_" << pb.first << "_GB/s";
+        stream << "\n";
+        for ( int p = 0; p < num_problem_size; ++p )
+        {
+            stream << problem_sizes[p];
+            for ( auto& pb : place_bandwidth )
+                stream << " " << pb.second[p];
+            stream << "\n";
+        }
+    }
+}
+
+//---------------------------------------------------------------------------//
+// main
+int main( int argc, char* argv[] )
+{
+    // Initialize environment
+    Kokkos::initialize( argc, argv );
+
+    // Check arguments.
+    if ( argc < 2 )
+        throw std::runtime_error( "Incorrect number of arguments. \n \
+             First argument -  file name for output \n \
+             Optional second argument - run size (small or large) \n \
+             \n \
+             Example: \n \
+             $/: ./NumaPerformance test_results.txt large\n" );
+
+    // Get the name of the output file.
+    std::string filename = argv[1];
+
+    // Define run sizes.
+    std::string run_type = "";
+    if ( argc > 2 )
+        run_type = argv[2];
+    std::vector<int> problem_sizes = { 100000, 1000000 };
+    if ( run_type == "large" )
+        problem_sizes = { 1000000, 10000000, 100000000 };
+
+    // Open the output file on rank 0.
+    std::fstream file;
+    file.open( filename, std::fstream::out );
+
+    // Page placement only applies to host memory.
+    using host_exec_space = Kokkos::DefaultHostExecutionSpace;
+    using host_device_type = host_exec_space::device_type;
+    performanceTest<host_device_type>( file, "host_", problem_sizes );
+
+    // Close the output file on rank 0.
+    file.close();
+
+    // Finalize
+    Kokkos::finalize();
+    return 0;
+}
+
+//---------------------------------------------------------------------------//
@@ -0,0 +1,307 @@
+/****************************************************************************
+ * Copyright (c) 2018-2022 by the Cabana authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the Cabana library. Cabana is distributed under a   *
+ * BSD 3-clause license. For the licensing terms see the LICENSE file in    *
+ * the top-level directory.                                                 *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#include "../Cabana_BenchmarkUtils.hpp"
+
+#include <Cabana_Core.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+//---------------------------------------------------------------------------//
+// Particle members: position, velocity, force, mass, type.
+using member_types =
+    Cabana::MemberTypes<double[3], double[3], double[3], double, int>;
+
+//---------------------------------------------------------------------------//
+// Data shared by all vector lengths for one problem size.
+template <class Device>
+struct ProblemData
+{
+    using memory_space = typename Device::memory_space;
+    using reference_aosoa_type = Cabana::AoSoA<member_types, Device>;
+    using list_type =
+        Cabana::VerletList<memory_space, Cabana::FullNeighborTag,
+                           Cabana::VerletLayout2D, Cabana::TeamVectorOpTag>;
+
+    reference_aosoa_type particles;
+    list_type neighbors;
+    Kokkos::View<unsigned long*, Device> keys;
+    Kokkos::View<int*, Device> steering;
+};
+
+//---------------------------------------------------------------------------//
+// Stream positions and forces into velocities. Used both in the sweep and as
+// the tuning kernel.
+template <class Device>
+struct StreamKernel
+{
+    template <class AoSoAType>
+    void operator()( AoSoAType& aosoa ) const
+    {
+        using exec_space = typename Device::execution_space;
+        auto x = Cabana::slice<0>( aosoa );
+        auto v = Cabana::slice<1>( aosoa );
+        auto f = Cabana::slice<2>( aosoa );
+        auto m = Cabana::slice<3>( aosoa );
+        double dt = 1.0e-3;
+        auto stream_op = KOKKOS_LAMBDA( const int s, const int a )
+        {
+            double dt_m = dt / m.access( s, a );
+            for ( int d = 0; d < 3; ++d )
+            {
+                v.access( s, a, d ) += dt_m * f.access( s, a, d );
+                x.access( s, a, d ) += dt * v.access( s, a, d );
+            }
+        };
+        Cabana::SimdPolicy<AoSoAType::vector_length, exec_space> policy(
+            0, aosoa.size() );
+        Cabana::simd_parallel_for( policy, stream_op, "stream" );
+        Kokkos::fence();
+    }
+};
+
+//---------------------------------------------------------------------------//
+// Time the representative kernels for one vector length.
+template <class Device, int VectorLength>
+void vectorLengthTest( std::ostream& stream, const std::string& test_prefix,
+                       const std::vector<int>& problem_sizes,
+                       std::vector<ProblemData<Device>>& problems,
+                       const int num_run )
+{
+    using exec_space = typename Device::execution_space;
+    using aosoa_type = Cabana::AoSoA<member_types, Device, VectorLength>;
+
+    int num_problem_size = problem_sizes.size();
+
+    // Create timers.
+    std::stringstream suffix;
+    suffix << "_vl_" << VectorLength;
+    Cabana::Benchmark::Timer stream_timer(
+        test_prefix + "stream" + suffix.str(), num_problem_size );
+    Cabana::Benchmark::Timer neighbor_timer(
+        test_prefix + "neighbor" + suffix.str(), num_problem_size );
+    Cabana::Benchmark::Timer permute_timer(
+        test_prefix + "permute" + suffix.str(), num_problem_size );
+    Cabana::Benchmark::Timer pack_timer( test_prefix + "pack" + suffix.str(),
+                                         num_problem_size );
+
+    for ( int p = 0; p < num_problem_size; ++p )
+    {
+        int num_p = problem_sizes[p];
+
+        // Copy the reference particles into this layout.
+        aosoa_type aosoa( "aosoa", num_p );
+        Cabana::deep_copy( aosoa, problems[p].particles );
+
+        auto x = Cabana::slice<0>( aosoa );
+        auto f = Cabana::slice<2>( aosoa );
+        auto nlist = problems[p].neighbors;
+        auto force_op = KOKKOS_LAMBDA( const int i, const int j )
+        {
+            for ( int d = 0; d < 3; ++d )
+                f( i, d ) += x( i, d ) - x( j, d );
+        };
+        Kokkos::RangePolicy<exec_space> linear_policy( 0, num_p );
+
+        auto steering = problems[p].steering;
+        aosoa_type buffer( "buffer", steering.size() );
+        auto pack_op = KOKKOS_LAMBDA( const int i )
+        {
+            buffer.setTuple( i, aosoa.getTuple( steering( i ) ) );
+        };
+        Kokkos::RangePolicy<exec_space> pack_policy( 0, steering.size() );
+
+        auto bin_data = Cabana::sortByKey( problems[p].keys );
+
+        StreamKernel<Device> stream_kernel;
+
+        for ( int t = 0; t < num_run; ++t )
+        {
+            // Slice streaming.
+            stream_timer.start( p );
+            stream_kernel( aosoa );
+            stream_timer.stop( p );
+
+            // Neighbor loop.
+            neighbor_timer.start( p );
+            Cabana::neighbor_parallel_for(
+                linear_policy, force_op, nlist, Cabana::FirstNeighborsTag(),
+                Cabana::SerialOpTag(), "neighbor" );
+            Kokkos::fence();
+            neighbor_timer.stop( p );
+
+            // Sort permutation.
+            permute_timer.start( p );
+            Cabana::permute( bin_data, aosoa );
+            Kokkos::fence();
+            permute_timer.stop( p );
+
+            // Migration buffer packing.
+            pack_timer.start( p );
+            Kokkos::parallel_for( "pack", pack_policy, pack_op );
+            Kokkos::fence();
+            pack_timer.stop( p );
+        }
+    }
+
+    // Output results.
+    outputResults( stream, "problem_size", problem_sizes, stream_timer );
+    outputResults( stream, "problem_size", problem_sizes, neighbor_timer );
+    outputResults( stream, "problem_size", problem_sizes, permute_timer );
+    outputResults( stream, "problem_size", problem_sizes, pack_timer );
+}
+
+//---------------------------------------------------------------------------//
+// Performance test.
+template <class Device, int... VectorLengths>
+void performanceTest( std::ostream& stream, const std::string& test_prefix,
+                      std::vector<int> problem_sizes,
+                      Cabana::VectorLengthList<VectorLengths...> candidates )
+{
+    using memory_space = typename Device::memory_space;
+
+    // Declare problem sizes.
+    int num_problem_size = problem_sizes.size();
+
+    // Number of runs in the test loops.
+    int num_run = 10;
+
+    // Neighbor cutoff and cell ratio.
+    double cutoff = 1.0;
+    double cell_ratio = 1.0;
+
+    // Create the data shared by all vector lengths.
+    std::vector<ProblemData<Device>> problems( num_problem_size );
+    std::minstd_rand0 generator( 3439203991 );
+    for ( int p = 0; p < num_problem_size; ++p )
+    {
+        int num_p = problem_sizes[p];
+
+        // Random positions at a fixed density, unit mass.
+        double x_min = 0.0;
+        double x_max = 1.3 * std::pow( num_p, 1.0 / 3.0 );
+        problems[p].particles.resize( num_p );
+        auto x = Cabana::slice<0>( problems[p].particles, "position" );
+        Cabana::createRandomParticles( x, x.size(), x_min, x_max );
+        auto v = Cabana::slice<1>( problems[p].particles, "velocity" );
+        auto f = Cabana::slice<2>( problems[p].particles, "force" );
+        auto m = Cabana::slice<3>( problems[p].particles, "mass" );
+        Cabana::deep_copy( v, 0.0 );
+        Cabana::deep_copy( f, 0.0 );
+        Cabana::deep_copy( m, 1.0 );
+
+        double grid_min[3] = { x_min, x_min, x_min };
+        double grid_max[3] = { x_max, x_max, x_max };
+        problems[p].neighbors = typename ProblemData<Device>::list_type(
+            x, 0, num_p, cutoff, cell_ratio, grid_min, grid_max );
+
+        // Random sort keys.
+        auto host_keys = Kokkos::View<unsigned long*, Kokkos::HostSpace>(
+            Kokkos::ViewAllocateWithoutInitializing( "host_keys" ), num_p );
+        for ( int n = 0; n < num_p; ++n )
+            host_keys( n ) = generator();
+        problems[p].keys = Kokkos::create_mirror_view_and_copy(
+            memory_space(), host_keys );
+
+        // Export a random tenth of the particles.
+        int num_export = num_p / 10;
+        auto host_steering = Kokkos::View<int*, Kokkos::HostSpace>(
+            Kokkos::ViewAllocateWithoutInitializing( "host_steering" ),
+            num_export );
+        for ( int n = 0; n < num_export; ++n )
+            host_steering( n ) = generator() % num_p;
+        problems[p].steering = Kokkos::create_mirror_view_and_copy(
+            memory_space(), host_steering );
+    }
+
+    // Sweep the vector lengths.
+    ( vectorLengthTest<Device, VectorLengths>( stream, test_prefix,
+                                               problem_sizes, problems,
+                                               num_run ),
+      ... );
+
+    // Select the vector length of this particle type at startup using the
+    // streaming kernel on the largest problem.
+    Cabana::VectorLengthTuner<member_types, Device, decltype( candidates )>
+        tuner( test_prefix + "stream" );
+    tuner.tune( problem_sizes.back(), StreamKernel<Device>(), num_run );
+    stream << "\n";
+    tuner.report( stream );
+    tuner.report( std::cout );
+}
+
+//---------------------------------------------------------------------------//
+// main
+int main( int argc, char* argv[] )
+{
+    // Initialize environment
+    Kokkos::initialize( argc, argv );
+
+    // Check arguments.
+    if ( argc < 2 )
+        throw std::runtime_error( "Incorrect number of arguments. \n \
+             First argument -  file name for output \n \
+             Optional second argument - run size (small or large) \n \
+             \n \
+             Example: \n \
+             $/: ./VectorLengthPerformance test_results.txt large\n" );
+
+    // Get the name of the output file.
+    std::string filename = argv[1];
+
+    // Define run sizes.
+    std::string run_type = "";
+    if ( argc > 2 )
+        run_type = argv[2];
+    std::vector<int> problem_sizes = { 1000, 10000 };
+    if ( run_type == "large" )
+        problem_sizes = { 1000, 10000, 100000, 1000000 };
+
+    // Candidate inner array sizes.
+    Cabana::VectorLengthList<1, 4, 8, 16, 32, 64> candidates;
+
+    // Open the output file on rank 0.
+    std::fstream file;
+    file.open( filename, std::fstream::out );
+
+    // Do everything on the default CPU.
+    using host_exec_space = Kokkos::DefaultHostExecutionSpace;
+    using host_device_type = host_exec_space::device_type;
+    // Do everything on the default device with default memory.
+    using exec_space = Kokkos::DefaultExecutionSpace;
+    using device_type = exec_space::device_type;
+
+    // Don't run twice on the CPU if only host enabled.
+    if ( !std::is_same<device_type, host_device_type>{} )
+    {
+        performanceTest<device_type>( file, "device_", problem_sizes,
+                                      candidates );
+    }
+    performanceTest<host_device_type>( file, "host_", problem_sizes,
+                                       candidates );
+
+    // Close the output file on rank 0.
+    file.close();
+
+    // Finalize
+    Kokkos::finalize();
+    return 0;
+}
+
+//---------------------------------------------------------------------------//
@@ -20,6 +20,7 @@
 
 #include <Cajita_Array.hpp>
 #include <Cajita_BovWriter.hpp>
+#include <Cajita_Checkpoint.hpp>
 #include <Cajita_GlobalGrid.hpp>
 #include <Cajita_GlobalMesh.hpp>
 #include <Cajita_Halo.hpp>
@@ -32,11 +33,13 @@
 #include <Cajita_MpiTraits.hpp>
 #include <Cajita_Parallel.hpp>
 #include <Cajita_ParticleGridDistributor.hpp>
+#include <Cajita_ParticleInit.hpp>
 #include <Cajita_ParticleList.hpp>
 #include <Cajita_Partitioner.hpp>
 #include <Cajita_ReferenceStructuredSolver.hpp>
 #ifndef KOKKOS_ENABLE_SYCL // FIXME_SYCL
 #include <Cajita_SparseArray.hpp>
+#include <Cajita_SparseArrayIO.hpp>
 #include <Cajita_SparseDimPartitioner.hpp>
 #include <Cajita_SparseHalo.hpp>
 #include <Cajita_SparseIndexSpace.hpp>
@@ -26,12 +26,16 @@
 
 #include <mpi.h>
 
+#include <algorithm>
 #include <array>
+#include <cstddef>
 #include <fstream>
 #include <iomanip>
 #include <sstream>
 #include <string>
 #include <type_traits>
+#include <utility>
+#include <vector>
 
 namespace Cajita
 {
@@ -164,39 +168,115 @@ reorderView( TargetView& target, const SourceView& source,
 
 //---------------------------------------------------------------------------//
 /*!
-  \brief Write a grid array to a VisIt BOV.
-
-  This version writes a single output and does not use bricklets. We will do
-  this in the future to improve parallel visualization.
+  \brief BOV collective output settings.
+*/
+struct BovConfig
+{
+    //! Number of ranks aggregating file writes. Zero uses the MPI-IO default.
+    int num_aggregators = 0;
+
+    //! Bytes of the collective buffer of each aggregator. Zero uses the
+    //! MPI-IO default.
+    std::size_t cb_buffer_bytes = 0;
+
+    //! Maximum bytes of each staged chunk of the owned data. The owned data
+    //! is written in chunks of whole slabs of the slowest file dimension
+    //! with at least one slab per chunk.
+    std::size_t chunk_bytes = 64 * 1024 * 1024;
+
+    //! Return as soon as all chunks are staged and their writes started. The
+    //! whole owned field is then staged on the host until the write
+    //! completes. Otherwise at most two chunks are staged at a time and the
+    //! write completes before returning.
+    bool async = false;
+};
 
-  \param time_step_index The index of the time step we are writing.
-  \param time The current time
-  \param array The array to write
-  \param gather_array Gather the array before writing to make parallel
-  consistent.
+//---------------------------------------------------------------------------//
+/*!
+  \brief Handle to a BOV data file write in progress. The write is completed
+  on destruction if it has not been waited on.
 */
-template <class Array_t>
-void writeTimeStep( const int time_step_index, const double time,
-                    const Array_t& array, const bool gather_array = true )
+class WriteRequest
 {
-    static_assert( isUniformMesh<typename Array_t::mesh_type>::value,
-                   "ViSIT BOV writer can only be used with uniform mesh" );
+  public:
+    //! Create a completed request.
+    WriteRequest()
+        : _file( MPI_FILE_NULL )
+        , _subarray( MPI_DATATYPE_NULL )
+    {
+    }
 
-    // Types
+    //! Move constructor.
+    WriteRequest( WriteRequest&& other )
+        : _file( other._file )
+        , _subarray( other._subarray )
+        , _requests( std::move( other._requests ) )
+        , _buffers( std::move( other._buffers ) )
+    {
+        other._file = MPI_FILE_NULL;
+        other._subarray = MPI_DATATYPE_NULL;
+    }
+
+    //! Move assignment.
+    WriteRequest& operator=( WriteRequest&& other )
+    {
+        if ( this != &other )
+        {
+            wait();
+            std::swap( _file, other._file );
+            std::swap( _subarray, other._subarray );
+            std::swap( _requests, other._requests );
+            std::swap( _buffers, other._buffers );
+        }
+        return *this;
+    }
+
+    WriteRequest( const WriteRequest& ) = delete;
+    WriteRequest& operator=( const WriteRequest& ) = delete;
+
+    //! Complete the write.
+    ~WriteRequest() { wait(); }
+
+    /*!
+      \brief Wait for the write to complete and close the file. This is
+      collective over the grid communicator.
+    */
+    void wait()
+    {
+        if ( !_requests.empty() )
+            MPI_Waitall( _requests.size(), _requests.data(),
+                         MPI_STATUSES_IGNORE );
+        _requests.clear();
+        _buffers.clear();
+        if ( MPI_FILE_NULL != _file )
+            MPI_File_close( &_file );
+        if ( MPI_DATATYPE_NULL != _subarray )
+            MPI_Type_free( &_subarray );
+    }
+
+    //! \cond Impl
+    MPI_File _file;
+    MPI_Datatype _subarray;
+    std::vector<MPI_Request> _requests;
+    std::vector<Kokkos::View<char*, Kokkos::HostSpace>> _buffers;
+    //! \endcond
+};
+
+//---------------------------------------------------------------------------//
+//! \cond Impl
+namespace Impl
+{
+//---------------------------------------------------------------------------//
+// Get the global extents of the array in the BOV file. Node fields include
+// the last node of periodic dimensions.
+template <class Array_t>
+std::array<long, Array_t::num_space_dim + 1>
+globalExtents( const Array_t& array )
+{
     using entity_type = typename Array_t::entity_type;
-    using value_type = typename Array_t::value_type;
-    using device_type = typename Array_t::device_type;
-    using execution_space = typename device_type::execution_space;
     const std::size_t num_space_dim = Array_t::num_space_dim;
-
-    // Get the global grid.
     const auto& global_grid = array.layout()->localGrid()->globalGrid();
 
-    // Get the global mesh.
-    const auto& global_mesh = global_grid.globalMesh();
-
-    // If this is a node field, determine periodicity so we can add the last
-    // node back to the visualization if needed.
     std::array<long, num_space_dim + 1> global_extents;
     for ( std::size_t i = 0; i < num_space_dim + 1; ++i )
     {
@@ -210,6 +290,19 @@ void writeTimeStep( const int time_step_index, const double time,
             global_extents[d] = global_grid.globalNumEntity( Cell(), d ) + 1;
     }
     global_extents[num_space_dim] = array.layout()->dofsPerEntity();
+    return global_extents;
+}
+
+//---------------------------------------------------------------------------//
+// Get the extents of the owned data this rank writes. The last block of a
+// periodic dimension of a node field also writes the last node.
+template <class Array_t>
+std::array<long, Array_t::num_space_dim + 1>
+ownedExtents( const Array_t& array )
+{
+    using entity_type = typename Array_t::entity_type;
+    const std::size_t num_space_dim = Array_t::num_space_dim;
+    const auto& global_grid = array.layout()->localGrid()->globalGrid();
 
     auto owned_index_space = array.layout()->indexSpace( Own(), Local() );
     std::array<long, num_space_dim + 1> owned_extents;
@@ -234,85 +327,94 @@ void writeTimeStep( const int time_step_index, const double time,
         }
     }
     owned_extents[num_space_dim] = array.layout()->dofsPerEntity();
+    return owned_extents;
+}
 
-    // Gather halo data if any dimensions are periodic.
-    if ( gather_array )
+//---------------------------------------------------------------------------//
+// Gather halo data if any dimensions are periodic.
+template <class Array_t>
+void gatherPeriodic( const Array_t& array )
+{
+    using execution_space = typename Array_t::execution_space;
+    const std::size_t num_space_dim = Array_t::num_space_dim;
+    const auto& global_grid = array.layout()->localGrid()->globalGrid();
+    for ( std::size_t d = 0; d < num_space_dim; ++d )
     {
-        for ( std::size_t d = 0; d < num_space_dim; ++d )
+        if ( global_grid.isPeriodic( d ) )
         {
-            if ( global_grid.isPeriodic( d ) )
-            {
-                auto halo =
-                    createHalo( NodeHaloPattern<num_space_dim>(), 0, array );
-                halo->gather( execution_space(), array );
-                break;
-            }
+            auto halo =
+                createHalo( NodeHaloPattern<num_space_dim>(), 0, array );
+            halo->gather( execution_space(), array );
+            break;
         }
     }
+}
 
-    // Create a contiguous array of the owned array values. Note that we
-    // reorder to KJI grid ordering to conform to the BOV format.
-    std::array<long, num_space_dim + 1> local_space_min;
-    std::array<long, num_space_dim + 1> local_space_max;
-    for ( std::size_t d = 0; d < num_space_dim; ++d )
+//---------------------------------------------------------------------------//
+// Get the local index space of the owned data this rank writes.
+template <class Array_t, std::size_t N>
+IndexSpace<N> writeSpace( const Array_t& array,
+                          const std::array<long, N>& owned_extents )
+{
+    auto owned_index_space = array.layout()->indexSpace( Own(), Local() );
+    std::array<long, N> local_space_min;
+    std::array<long, N> local_space_max;
+    for ( std::size_t d = 0; d < N - 1; ++d )
     {
         local_space_min[d] = owned_index_space.min( d );
         local_space_max[d] = owned_index_space.min( d ) + owned_extents[d];
     }
     local_space_min.back() = 0;
     local_space_max.back() = owned_extents.back();
-    IndexSpace<num_space_dim + 1> local_space( local_space_min,
-                                               local_space_max );
-    auto owned_subview = createSubview( array.view(), local_space );
+    return IndexSpace<N>( local_space_min, local_space_max );
+}
 
-    std::array<long, num_space_dim + 1> reorder_space_size;
-    for ( std::size_t d = 0; d < num_space_dim; ++d )
+//---------------------------------------------------------------------------//
+// Get the KJI ordered index space of a local index space.
+template <std::size_t N>
+IndexSpace<N> reorderSpace( const IndexSpace<N>& space )
+{
+    std::array<long, N> reorder_space_size;
+    for ( std::size_t d = 0; d < N - 1; ++d )
     {
-        reorder_space_size[d] = owned_extents[num_space_dim - d - 1];
+        reorder_space_size[d] = space.extent( N - d - 2 );
     }
-    reorder_space_size.back() = owned_extents.back();
-    IndexSpace<num_space_dim + 1> reorder_space( reorder_space_size );
-    auto owned_view = createView<value_type, Kokkos::LayoutRight, device_type>(
-        array.label(), reorder_space );
-    reorderView( owned_view, owned_subview, reorder_space, execution_space() );
+    reorder_space_size.back() = space.extent( N - 1 );
+    return IndexSpace<N>( reorder_space_size );
+}
 
-    // Compose a data file name prefix.
+//---------------------------------------------------------------------------//
+// Compose a file name prefix.
+template <class Array_t>
+std::string filePrefix( const int time_step_index, const Array_t& array )
+{
     std::stringstream file_name;
     file_name << "grid_" << array.label() << "_" << std::setfill( '0' )
               << std::setw( 6 ) << time_step_index;
+    return file_name.str();
+}
 
-    // Open a binary data file.
-    std::string data_file_name = file_name.str() + ".dat";
-    MPI_File data_file;
-    MPI_File_open( global_grid.comm(), data_file_name.c_str(),
-                   MPI_MODE_WRONLY | MPI_MODE_CREATE, MPI_INFO_NULL,
-                   &data_file );
-
-    // Create the global subarray in which we are writing the local data.
-    auto subarray = createSubarray( array, owned_extents, global_extents );
-    MPI_Type_commit( &subarray );
-
-    // Set the data in the file this process is going to write to.
-    MPI_File_set_view( data_file, 0, MpiTraits<value_type>::type(), subarray,
-                       "native", MPI_INFO_NULL );
-
-    // Write the view to binary.
-    MPI_Status status;
-    MPI_File_write_all( data_file, owned_view.data(), owned_view.size(),
-                        MpiTraits<value_type>::type(), &status );
+//---------------------------------------------------------------------------//
+// Create a VisIt BOV header with global data. Only create the header on
+// rank 0.
+template <class Array_t, std::size_t N>
+void writeHeader( const std::string& file_prefix, const double time,
+                  const Array_t& array,
+                  const std::array<long, N>& global_extents )
+{
+    using entity_type = typename Array_t::entity_type;
+    using value_type = typename Array_t::value_type;
+    const std::size_t num_space_dim = Array_t::num_space_dim;
 
-    // Clean up.
-    MPI_File_close( &data_file );
-    MPI_Type_free( &subarray );
+    const auto& global_grid = array.layout()->localGrid()->globalGrid();
+    const auto& global_mesh = global_grid.globalMesh();
 
-    // Create a VisIt BOV header with global data. Only create the header
-    // on rank 0.
     int rank;
     MPI_Comm_rank( global_grid.comm(), &rank );
     if ( 0 == rank )
     {
         // Open a file for writing.
-        std::string header_file_name = file_name.str() + ".bov";
+        std::string header_file_name = file_prefix + ".bov";
         std::fstream header;
         header.open( header_file_name, std::fstream::out );
 
@@ -320,7 +422,7 @@ void writeTimeStep( const int time_step_index, const double time,
         header << "TIME: " << time << std::endl;
 
         // Data file name.
-        header << "DATA_FILE: " << data_file_name << std::endl;
+        header << "DATA_FILE: " << file_prefix + ".dat" << std::endl;
 
         // Global data size.
         header << "DATA_SIZE: ";
@@ -384,6 +486,292 @@ void writeTimeStep( const int time_step_index, const double time,
     }
 }
 
+//---------------------------------------------------------------------------//
+// Stage a chunk of the owned data in KJI order in a host buffer.
+template <class Array_t, std::size_t N, class DeviceBuffer>
+void stageChunk(
+    const Array_t& array, const IndexSpace<N>& chunk_space,
+    DeviceBuffer& device_buffer,
+    const Kokkos::View<char*, Kokkos::HostSpace>& host_buffer,
+    typename std::enable_if<
+        Kokkos::SpaceAccessibility<typename Array_t::execution_space,
+                                   Kokkos::HostSpace>::accessible,
+        int>::type* = 0 )
+{
+    using value_type = typename Array_t::value_type;
+    using device_type = typename Array_t::device_type;
+    using execution_space = typename Array_t::execution_space;
+    (void)device_buffer;
+
+    // Reorder directly into the host buffer.
+    auto reorder_space = reorderSpace( chunk_space );
+    auto target = createView<value_type, Kokkos::LayoutRight, device_type>(
+        reorder_space, reinterpret_cast<value_type*>( host_buffer.data() ) );
+    reorderView( target, createSubview( array.view(), chunk_space ),
+                 reorder_space, execution_space() );
+}
+
+template <class Array_t, std::size_t N, class DeviceBuffer>
+void stageChunk(
+    const Array_t& array, const IndexSpace<N>& chunk_space,
+    DeviceBuffer& device_buffer,
+    const Kokkos::View<char*, Kokkos::HostSpace>& host_buffer,
+    typename std::enable_if<
+        !Kokkos::SpaceAccessibility<typename Array_t::execution_space,
+                                    Kokkos::HostSpace>::accessible,
+        int>::type* = 0 )
+{
+    using value_type = typename Array_t::value_type;
+    using device_type = typename Array_t::device_type;
+    using execution_space = typename Array_t::execution_space;
+
+    // Reorder into the device buffer and copy it to the host.
+    auto reorder_space = reorderSpace( chunk_space );
+    auto target = createView<value_type, Kokkos::LayoutRight, device_type>(
+        reorder_space, device_buffer.data() );
+    reorderView( target, createSubview( array.view(), chunk_space ),
+                 reorder_space, execution_space() );
+    auto host_target =
+        createView<value_type, Kokkos::LayoutRight, Kokkos::HostSpace>(
+            reorder_space,
+            reinterpret_cast<value_type*>( host_buffer.data() ) );
+    Kokkos::deep_copy( host_target, target );
+}
+
+} // end namespace Impl
+//! \endcond
+
+//---------------------------------------------------------------------------//
+/*!
+  \brief Write a grid array to a VisIt BOV.
+
+  This version writes a single output and does not use bricklets. We will do
+  this in the future to improve parallel visualization.
+
+  \param time_step_index The index of the time step we are writing.
+  \param time The current time
+  \param array The array to write
+  \param gather_array Gather the array before writing to make parallel
+  consistent.
+*/
+template <class Array_t>
+void writeTimeStep( const int time_step_index, const double time,
+                    const Array_t& array, const bool gather_array = true )
+{
+    static_assert( isUniformMesh<typename Array_t::mesh_type>::value,
+                   "ViSIT BOV writer can only be used with uniform mesh" );
+
+    // Types
+    using value_type = typename Array_t::value_type;
+    using device_type = typename Array_t::device_type;
+    using execution_space = typename device_type::execution_space;
+
+    // Get the global grid.
+    const auto& global_grid = array.layout()->localGrid()->globalGrid();
+
+    // If this is a node field, determine periodicity so we can add the last
+    // node back to the visualization if needed.
+    auto global_extents = Impl::globalExtents( array );
+    auto owned_extents = Impl::ownedExtents( array );
+
+    // Gather halo data if any dimensions are periodic.
+    if ( gather_array )
+        Impl::gatherPeriodic( array );
+
+    // Create a contiguous array of the owned array values. Note that we
+    // reorder to KJI grid ordering to conform to the BOV format.
+    auto local_space = Impl::writeSpace( array, owned_extents );
+    auto owned_subview = createSubview( array.view(), local_space );
+    auto reorder_space = Impl::reorderSpace( local_space );
+    auto owned_view = createView<value_type, Kokkos::LayoutRight, device_type>(
+        array.label(), reorder_space );
+    reorderView( owned_view, owned_subview, reorder_space, execution_space() );
+
+    // Compose a data file name prefix.
+    auto file_prefix = Impl::filePrefix( time_step_index, array );
+
+    // Open a binary data file.
+    std::string data_file_name = file_prefix + ".dat";
+    MPI_File data_file;
+    MPI_File_open( global_grid.comm(), data_file_name.c_str(),
+                   MPI_MODE_WRONLY | MPI_MODE_CREATE, MPI_INFO_NULL,
+                   &data_file );
+
+    // Create the global subarray in which we are writing the local data.
+    auto subarray = createSubarray( array, owned_extents, global_extents );
+    MPI_Type_commit( &subarray );
+
+    // Set the data in the file this process is going to write to.
+    MPI_File_set_view( data_file, 0, MpiTraits<value_type>::type(), subarray,
+                       "native", MPI_INFO_NULL );
+
+    // Write the view to binary.
+    MPI_Status status;
+    MPI_File_write_all( data_file, owned_view.data(), owned_view.size(),
+                        MpiTraits<value_type>::type(), &status );
+
+    // Clean up.
+    MPI_File_close( &data_file );
+    MPI_Type_free( &subarray );
+
+    // Create a VisIt BOV header with global data.
+    Impl::writeHeader( file_prefix, time, array, global_extents );
+}
+
+//---------------------------------------------------------------------------//
+/*!
+  \brief Write a grid array to a VisIt BOV with chunked collective buffered
+  writes.
+
+  The owned data is staged on the host in chunks of whole slabs of the
+  slowest file dimension. Staging a chunk overlaps the nonblocking
+  collective write of the previous one, so at most two chunks are staged at
+  a time. The MPI-IO collective buffering hints are set from the
+  configuration. Ranks without owned data take part in the collective writes
+  with empty writes. With asynchronous completion all chunks are staged and
+  their writes started before returning, and the returned request must be
+  completed on all ranks before the file is read.
+
+  \param config Output settings.
+  \param time_step_index The index of the time step we are writing.
+  \param time The current time
+  \param array The array to write
+  \param gather_array Gather the array before writing to make parallel
+  consistent.
+  \return The write request. Completed unless asynchronous completion was
+  requested.
+*/
+template <class Array_t>
+WriteRequest writeTimeStep( const BovConfig& config,
+                            const int time_step_index, const double time,
+                            const Array_t& array,
+                            const bool gather_array = true )
+{
+    static_assert( isUniformMesh<typename Array_t::mesh_type>::value,
+                   "ViSIT BOV writer can only be used with uniform mesh" );
+
+    Kokkos::Profiling::pushRegion( "Cajita::BovWriter::writeTimeStep" );
+
+    // Types
+    using value_type = typename Array_t::value_type;
+    using memory_space = typename Array_t::memory_space;
+    const std::size_t num_space_dim = Array_t::num_space_dim;
+    const std::size_t slow_dim = num_space_dim - 1;
+
+    const auto& global_grid = array.layout()->localGrid()->globalGrid();
+    auto global_extents = Impl::globalExtents( array );
+    auto owned_extents = Impl::ownedExtents( array );
+    if ( gather_array )
+        Impl::gatherPeriodic( array );
+    auto local_space = Impl::writeSpace( array, owned_extents );
+
+    // Divide the owned data into chunks of slabs of the slowest file
+    // dimension. All ranks take part in each collective write, ranks
+    // without owned data with empty writes.
+    long num_slab = local_space.extent( slow_dim );
+    long slab_size = ( num_slab > 0 ) ? local_space.size() / num_slab : 0;
+    if ( 0 == slab_size )
+        num_slab = 0;
+    long chunk_slabs =
+        ( slab_size > 0 )
+            ? std::max( 1L, static_cast<long>(
+                                config.chunk_bytes /
+                                ( slab_size * sizeof( value_type ) ) ) )
+            : 1L;
+    long local_num_chunk = ( num_slab + chunk_slabs - 1 ) / chunk_slabs;
+    long num_chunk = local_num_chunk;
+    MPI_Allreduce( MPI_IN_PLACE, &num_chunk, 1, MPI_LONG, MPI_MAX,
+                   global_grid.comm() );
+
+    // Collective buffering hints.
+    MPI_Info info;
+    MPI_Info_create( &info );
+    MPI_Info_set( info, "romio_cb_write", "enable" );
+    if ( config.cb_buffer_bytes > 0 )
+    {
+        std::string buffer_size = std::to_string( config.cb_buffer_bytes );
+        MPI_Info_set( info, "cb_buffer_size", buffer_size.c_str() );
+    }
+    if ( config.num_aggregators > 0 )
+    {
+        std::string num_aggregators = std::to_string( config.num_aggregators );
+        MPI_Info_set( info, "cb_nodes", num_aggregators.c_str() );
+    }
+
+    // Open the data file and set the view of this rank.
+    auto file_prefix = Impl::filePrefix( time_step_index, array );
+    std::string data_file_name = file_prefix + ".dat";
+    WriteRequest request;
+    MPI_File_open( global_grid.comm(), data_file_name.c_str(),
+                   MPI_MODE_WRONLY | MPI_MODE_CREATE, info, &request._file );
+    request._subarray =
+        createSubarray( array, owned_extents, global_extents );
+    MPI_Type_commit( &request._subarray );
+    MPI_File_set_view( request._file, 0, MpiTraits<value_type>::type(),
+                       request._subarray, "native", info );
+    MPI_Info_free( &info );
+
+    // Host staging buffers. Chunk c is staged in buffer c % num_buffer.
+    std::size_t chunk_bytes = chunk_slabs * slab_size * sizeof( value_type );
+    long num_buffer = config.async ? local_num_chunk
+                                   : std::min( 2L, local_num_chunk );
+    for ( long b = 0; b < num_buffer; ++b )
+        request._buffers.push_back( Kokkos::View<char*, Kokkos::HostSpace>(
+            Kokkos::ViewAllocateWithoutInitializing(
+                "Cajita::BovWriter::buffer" ),
+            chunk_bytes ) );
+    Kokkos::View<value_type*, memory_space> device_buffer;
+    if ( !Kokkos::SpaceAccessibility<typename Array_t::execution_space,
+                                     Kokkos::HostSpace>::accessible &&
+         local_num_chunk > 0 )
+        device_buffer = Kokkos::View<value_type*, memory_space>(
+            Kokkos::ViewAllocateWithoutInitializing(
+                "Cajita::BovWriter::device_buffer" ),
+            chunk_slabs * slab_size );
+
+    // Stage each chunk while the previous one is written.
+    request._requests.resize( num_chunk, MPI_REQUEST_NULL );
+    for ( long c = 0; c < num_chunk; ++c )
+    {
+        long slab_begin = std::min( c * chunk_slabs, num_slab );
+        long slab_end = std::min( slab_begin + chunk_slabs, num_slab );
+        long count = ( slab_end - slab_begin ) * slab_size;
+        void* data = nullptr;
+        if ( count > 0 )
+        {
+            if ( c >= num_buffer )
+                MPI_Wait( &request._requests[c - num_buffer],
+                          MPI_STATUS_IGNORE );
+            auto& host_buffer = request._buffers[c % num_buffer];
+            std::array<long, num_space_dim + 1> chunk_min;
+            std::array<long, num_space_dim + 1> chunk_max;
+            for ( std::size_t d = 0; d < num_space_dim + 1; ++d )
+            {
+                chunk_min[d] = local_space.min( d );
+                chunk_max[d] = local_space.max( d );
+            }
+            chunk_min[slow_dim] = local_space.min( slow_dim ) + slab_begin;
+            chunk_max[slow_dim] = local_space.min( slow_dim ) + slab_end;
+            Impl::stageChunk(
+                array, IndexSpace<num_space_dim + 1>( chunk_min, chunk_max ),
+                device_buffer, host_buffer );
+            data = host_buffer.data();
+        }
+        MPI_File_iwrite_at_all( request._file, slab_begin * slab_size, data,
+                                count, MpiTraits<value_type>::type(),
+                                &request._requests[c] );
+    }
+
+    // Create a VisIt BOV header with global data.
+    Impl::writeHeader( file_prefix, time, array, global_extents );
+
+    if ( !config.async )
+        request.wait();
+
+    Kokkos::Profiling::popRegion();
+    return request;
+}
+
 //---------------------------------------------------------------------------//
 
 } // end namespace BovWriter
@@ -0,0 +1,237 @@
+/****************************************************************************
+ * Copyright (c) 2018-2022 by the Cabana authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the Cabana library. Cabana is distributed under a   *
+ * BSD 3-clause license. For the licensing terms see the LICENSE file in    *
+ * the top-level directory.                                                 *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+/*!
+  \file Cajita_Checkpoint.hpp
+  \brief Binary checkpoint and restart of grid arrays
+*/
+#ifndef CAJITA_CHECKPOINT_HPP
+#define CAJITA_CHECKPOINT_HPP
+
+#include <Cajita_Array.hpp>
+#include <Cajita_IndexSpace.hpp>
+#include <Cajita_Types.hpp>
+
+#include <Cabana_Checkpoint.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <mpi.h>
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+namespace Cajita
+{
+namespace Experimental
+{
+namespace Checkpoint
+{
+//---------------------------------------------------------------------------//
+//! \cond Impl
+namespace Impl
+{
+// Entity names in the layout description.
+inline std::string entityName( Cell ) { return "Cell"; }
+inline std::string entityName( Node ) { return "Node"; }
+template <int D>
+std::string entityName( Face<D> )
+{
+    return "Face" + std::to_string( D );
+}
+template <int D>
+std::string entityName( Edge<D> )
+{
+    return "Edge" + std::to_string( D );
+}
+
+// Describe the array data and the global grid it is defined on. This is the
+// same on all ranks.
+template <class Array_t>
+std::string arrayLayout( const Array_t& array )
+{
+    using value_type = typename Array_t::value_type;
+    const auto& global_grid = array.layout()->localGrid()->globalGrid();
+    const auto& global_mesh = global_grid.globalMesh();
+
+    std::stringstream layout;
+    layout << std::setprecision( std::numeric_limits<double>::max_digits10 );
+    layout << "Array " << entityName( typename Array_t::entity_type() )
+           << " value "
+           << Cabana::Experimental::Checkpoint::Impl::valueKind<value_type>()
+           << sizeof( value_type ) << " dofs "
+           << array.layout()->dofsPerEntity() << " cells";
+    for ( std::size_t d = 0; d < Array_t::num_space_dim; ++d )
+        layout << " " << global_grid.globalNumEntity( Cell(), d );
+    layout << " periodic";
+    for ( std::size_t d = 0; d < Array_t::num_space_dim; ++d )
+        layout << " " << global_grid.isPeriodic( d );
+    layout << " blocks";
+    for ( std::size_t d = 0; d < Array_t::num_space_dim; ++d )
+        layout << " " << global_grid.dimNumBlock( d );
+    layout << " low";
+    for ( std::size_t d = 0; d < Array_t::num_space_dim; ++d )
+        layout << " " << global_mesh.lowCorner( d );
+    layout << " high";
+    for ( std::size_t d = 0; d < Array_t::num_space_dim; ++d )
+        layout << " " << global_mesh.highCorner( d );
+    return layout.str();
+}
+
+// Get the global offset and owned extent of the local grid in each
+// dimension.
+template <class Array_t>
+std::array<std::int64_t, 2 * Array_t::num_space_dim>
+localGridBlock( const Array_t& array )
+{
+    const auto& global_grid = array.layout()->localGrid()->globalGrid();
+    auto owned_space = array.layout()->indexSpace( Own(), Local() );
+    std::array<std::int64_t, 2 * Array_t::num_space_dim> block;
+    for ( std::size_t d = 0; d < Array_t::num_space_dim; ++d )
+    {
+        block[2 * d] = global_grid.globalOffset( d );
+        block[2 * d + 1] = owned_space.extent( d );
+    }
+    return block;
+}
+
+// Name of the section holding the local grid blocks of an array.
+template <class Array_t>
+std::string gridSectionName( const Array_t& array )
+{
+    return array.label() + ":grid";
+}
+
+// Index space of the owned array data starting at zero.
+template <class Array_t>
+IndexSpace<Array_t::num_space_dim + 1> ownedExtents( const Array_t& array )
+{
+    auto owned_space = array.layout()->indexSpace( Own(), Local() );
+    std::array<long, Array_t::num_space_dim + 1> size;
+    for ( std::size_t d = 0; d < Array_t::num_space_dim + 1; ++d )
+        size[d] = owned_space.extent( d );
+    return IndexSpace<Array_t::num_space_dim + 1>( size );
+}
+
+} // namespace Impl
+//! \endcond
+
+//---------------------------------------------------------------------------//
+/*!
+  \brief Add the owned data of an array to a checkpoint.
+
+  The owned data is written in its local ordering together with the global
+  grid description and the local grid block of each rank so that a restart
+  onto a different grid or decomposition is detected. The section is named
+  by the array label.
+
+  \param writer The checkpoint writer.
+  \param array The array.
+*/
+template <class Array_t>
+void add( Cabana::Experimental::Checkpoint::Writer& writer,
+          const Array_t& array )
+{
+    static_assert( is_array<Array_t>::value, "Cajita::Array required" );
+    using value_type = typename Array_t::value_type;
+    using memory_space = typename Array_t::memory_space;
+
+    // Local grid block.
+    auto block = Impl::localGridBlock( array );
+    Kokkos::View<char*, Kokkos::HostSpace> block_bytes(
+        Kokkos::ViewAllocateWithoutInitializing( "Cajita::Checkpoint::grid" ),
+        sizeof( block ) );
+    std::memcpy( block_bytes.data(), block.data(), sizeof( block ) );
+    writer.addSection( Impl::gridSectionName( array ), "Cajita local grid",
+                       block.size(), block_bytes );
+
+    // Copy the owned data to a contiguous host block. Host arrays are copied
+    // once directly into the block.
+    auto owned_space = Impl::ownedExtents( array );
+    Kokkos::View<char*, Kokkos::HostSpace> bytes(
+        Kokkos::ViewAllocateWithoutInitializing( array.label() ),
+        owned_space.size() * sizeof( value_type ) );
+    auto host_owned =
+        createView<value_type, Kokkos::LayoutRight, Kokkos::HostSpace>(
+            owned_space, reinterpret_cast<value_type*>( bytes.data() ) );
+    auto owned = Kokkos::create_mirror_view( Kokkos::WithoutInitializing,
+                                             memory_space(), host_owned );
+    Kokkos::deep_copy(
+        owned, createSubview( array.view(),
+                              array.layout()->indexSpace( Own(), Local() ) ) );
+    Kokkos::deep_copy( host_owned, owned );
+
+    writer.addSection( array.label(), Impl::arrayLayout( array ),
+                       owned_space.size(), bytes );
+}
+
+//---------------------------------------------------------------------------//
+/*!
+  \brief Restore the owned data of an array from a checkpoint. Ghost values
+  are not restored.
+
+  \param reader The checkpoint reader.
+  \param array The array. Must be defined on the grid and decomposition the
+  checkpoint was written from.
+*/
+template <class Array_t>
+void read( Cabana::Experimental::Checkpoint::Reader& reader, Array_t& array )
+{
+    static_assert( is_array<Array_t>::value, "Cajita::Array required" );
+    using value_type = typename Array_t::value_type;
+    using memory_space = typename Array_t::memory_space;
+
+    Kokkos::Profiling::pushRegion( "Cajita::Checkpoint::read" );
+
+    // Check the local grid block on all ranks before reading any data.
+    auto block = Impl::localGridBlock( array );
+    auto written_block = block;
+    reader.readSection( Impl::gridSectionName( array ), "Cajita local grid",
+                        written_block.data(), sizeof( written_block ) );
+    int mismatch = ( block != written_block );
+    MPI_Allreduce( MPI_IN_PLACE, &mismatch, 1, MPI_INT, MPI_MAX,
+                   array.layout()->localGrid()->globalGrid().comm() );
+    if ( mismatch )
+        throw std::runtime_error( "Checkpoint array " + array.label() +
+                                  " was written with a different grid "
+                                  "decomposition" );
+
+    // Read the owned data into a contiguous host block and copy it in.
+    auto owned_space = Impl::ownedExtents( array );
+    auto host_owned =
+        createView<value_type, Kokkos::LayoutRight, Kokkos::HostSpace>(
+            array.label(), owned_space );
+    reader.readSection( array.label(), Impl::arrayLayout( array ),
+                        host_owned.data(),
+                        owned_space.size() * sizeof( value_type ) );
+    auto owned = Kokkos::create_mirror_view_and_copy( memory_space(),
+                                                      host_owned );
+    Kokkos::deep_copy(
+        createSubview( array.view(),
+                       array.layout()->indexSpace( Own(), Local() ) ),
+        owned );
+
+    Kokkos::Profiling::popRegion();
+}
+
+//---------------------------------------------------------------------------//
+
+} // namespace Checkpoint
+} // namespace Experimental
+} // namespace Cajita
+
+#endif // end CAJITA_CHECKPOINT_HPP
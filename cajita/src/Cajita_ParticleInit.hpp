@@ -0,0 +1,426 @@
+/****************************************************************************
+ * Copyright (c) 2018-2022 by the Cabana authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the Cabana library. Cabana is distributed under a   *
+ * BSD 3-clause license. For the licensing terms see the LICENSE file in    *
+ * the top-level directory.                                                 *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+/*!
+  \file Cajita_ParticleInit.hpp
+  \brief Distributed particle creation on the owned cells of a local grid.
+*/
+#ifndef CAJITA_PARTICLEINIT_HPP
+#define CAJITA_PARTICLEINIT_HPP
+
+#include <Cajita_LocalGrid.hpp>
+#include <Cajita_LocalMesh.hpp>
+#include <Cajita_Types.hpp>
+
+#include <Cabana_ParticleInit.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <cstdint>
+#include <type_traits>
+
+namespace Cajita
+{
+//---------------------------------------------------------------------------//
+// Lattice tags.
+//---------------------------------------------------------------------------//
+//! Simple cubic lattice: one particle at the center of each lattice cell.
+struct SimpleCubicLattice
+{
+    //! Number of particles per lattice cell.
+    static constexpr int num_basis = 1;
+
+    //! Offset of a particle within the lattice cell in units of its size.
+    KOKKOS_INLINE_FUNCTION
+    static double offset( const int, const int ) { return 0.5; }
+};
+
+//! Body-centered cubic lattice: two particles per lattice cell.
+struct BodyCenteredCubicLattice
+{
+    //! Number of particles per lattice cell.
+    static constexpr int num_basis = 2;
+
+    //! Offset of a particle within the lattice cell in units of its size.
+    KOKKOS_INLINE_FUNCTION
+    static double offset( const int b, const int ) { return 0.25 + 0.5 * b; }
+};
+
+//! Face-centered cubic lattice: four particles per lattice cell. 3D only.
+struct FaceCenteredCubicLattice
+{
+    //! Number of particles per lattice cell.
+    static constexpr int num_basis = 4;
+
+    //! Offset of a particle within the lattice cell in units of its size.
+    KOKKOS_INLINE_FUNCTION
+    static double offset( const int b, const int d )
+    {
+        return ( 0 == b || b - 1 == d ) ? 0.25 : 0.75;
+    }
+};
+
+//---------------------------------------------------------------------------//
+//! \cond Impl
+namespace Impl
+{
+//---------------------------------------------------------------------------//
+// Local index of an owned cell from its linear index. The last dimension is
+// the fastest.
+template <std::size_t NumSpaceDim>
+KOKKOS_INLINE_FUNCTION void
+ownedCellIndex( long n, const Kokkos::Array<long, NumSpaceDim>& min,
+                const Kokkos::Array<long, NumSpaceDim>& extent,
+                int index[NumSpaceDim] )
+{
+    for ( int d = NumSpaceDim - 1; d >= 0; --d )
+    {
+        index[d] = min[d] + n % extent[d];
+        n /= extent[d];
+    }
+}
+
+// Physical bounds of a cell.
+template <class LocalMeshType>
+KOKKOS_INLINE_FUNCTION void
+cellBounds( const LocalMeshType& local_mesh, const int* index,
+            typename LocalMeshType::scalar_type* low,
+            typename LocalMeshType::scalar_type* high )
+{
+    int upper[LocalMeshType::num_space_dim];
+    for ( std::size_t d = 0; d < LocalMeshType::num_space_dim; ++d )
+        upper[d] = index[d] + 1;
+    local_mesh.coordinates( Node(), index, low );
+    local_mesh.coordinates( Node(), upper, high );
+}
+
+// Scalar cell value of an array view.
+template <class ViewType>
+KOKKOS_INLINE_FUNCTION std::enable_if_t<4 == ViewType::rank, double>
+cellValue( const ViewType& view, const int index[3] )
+{
+    return view( index[0], index[1], index[2], 0 );
+}
+
+template <class ViewType>
+KOKKOS_INLINE_FUNCTION std::enable_if_t<3 == ViewType::rank, double>
+cellValue( const ViewType& view, const int index[2] )
+{
+    return view( index[0], index[1], 0 );
+}
+
+//---------------------------------------------------------------------------//
+// Owned cell iteration data.
+template <std::size_t NumSpaceDim>
+struct OwnedCells
+{
+    Kokkos::Array<long, NumSpaceDim> min;
+    Kokkos::Array<long, NumSpaceDim> extent;
+    long size;
+};
+
+template <class LocalGridType>
+OwnedCells<LocalGridType::num_space_dim>
+ownedCells( const LocalGridType& local_grid )
+{
+    auto own_space = local_grid.indexSpace( Own(), Cell(), Local() );
+    OwnedCells<LocalGridType::num_space_dim> owned;
+    for ( std::size_t d = 0; d < LocalGridType::num_space_dim; ++d )
+    {
+        owned.min[d] = own_space.min( d );
+        owned.extent[d] = own_space.extent( d );
+    }
+    owned.size = own_space.size();
+    return owned;
+}
+
+//---------------------------------------------------------------------------//
+// Particle sampling proportional to a cell density. Random numbers are
+// hashed from the global cell index so the particles do not depend on the
+// decomposition.
+template <class LocalMeshType, class ViewType, std::size_t NumSpaceDim>
+struct DensitySampler
+{
+    using scalar_type = typename LocalMeshType::scalar_type;
+
+    LocalMeshType local_mesh;
+    ViewType density;
+    OwnedCells<NumSpaceDim> owned;
+    Kokkos::Array<long, NumSpaceDim> global_offset;
+    Kokkos::Array<long, NumSpaceDim> global_extent;
+    std::uint64_t seed;
+
+    KOKKOS_INLINE_FUNCTION
+    std::uint64_t cellHash( const int index[NumSpaceDim] ) const
+    {
+        long global_id = 0;
+        for ( std::size_t d = 0; d < NumSpaceDim; ++d )
+            global_id = global_id * global_extent[d] + index[d] - owned.min[d] +
+                        global_offset[d];
+        return Cabana::Impl::hashMix(
+            seed ^ Cabana::Impl::hashMix( global_id ) );
+    }
+
+    // Number of particles in an owned cell: the expected number rounded
+    // stochastically.
+    KOKKOS_INLINE_FUNCTION
+    int count( const long c, int index[NumSpaceDim] ) const
+    {
+        ownedCellIndex( c, owned.min, owned.extent, index );
+        double expected =
+            cellValue( density, index ) * local_mesh.measure( Cell(), index );
+        if ( expected <= 0.0 )
+            return 0;
+        return static_cast<int>(
+            expected + Cabana::Impl::hashUniform( cellHash( index ) ) );
+    }
+
+    // Uniformly random position of a particle in a cell.
+    KOKKOS_INLINE_FUNCTION
+    void position( const int index[NumSpaceDim], const int p,
+                   scalar_type x[NumSpaceDim] ) const
+    {
+        scalar_type low[NumSpaceDim];
+        scalar_type high[NumSpaceDim];
+        cellBounds( local_mesh, index, low, high );
+        auto h = cellHash( index );
+        for ( std::size_t d = 0; d < NumSpaceDim; ++d )
+            x[d] = low[d] + Cabana::Impl::hashUniform( Cabana::Impl::hashMix(
+                                h + 1 + p * NumSpaceDim + d ) ) *
+                                ( high[d] - low[d] );
+    }
+};
+
+//---------------------------------------------------------------------------//
+
+} // end namespace Impl
+//! \endcond
+
+//---------------------------------------------------------------------------//
+/*!
+  \brief Create particles on a regular lattice in the owned cells of a local
+  grid.
+
+  Each owned cell is divided into particles_per_cell_dim lattice cells per
+  dimension holding the lattice basis, so the particles of all ranks form a
+  single global lattice without duplicates at rank boundaries. The number of
+  particles is known up front and the particle list is resized once.
+
+  \param exec_space Kokkos execution space.
+  \param particle_list The particle list. Created particles are appended
+  after previous_num_particles.
+  \param position_tag Field tag of the particle positions.
+  \param local_grid The local grid whose owned cells are filled.
+  \param particles_per_cell_dim Lattice cells per grid cell per dimension.
+  \param previous_num_particles Number of particles to keep.
+  \return The number of particles created on this rank.
+*/
+template <class LatticeType, class ExecutionSpace, class ParticleListType,
+          class PositionTag, class LocalGridType>
+std::enable_if_t<Kokkos::is_execution_space<ExecutionSpace>::value,
+                 std::size_t>
+createLatticeParticles(
+    LatticeType, ExecutionSpace, ParticleListType& particle_list,
+    PositionTag, const LocalGridType& local_grid,
+    const int particles_per_cell_dim,
+    const std::size_t previous_num_particles = 0 )
+{
+    static constexpr std::size_t num_space_dim = LocalGridType::num_space_dim;
+    static_assert(
+        !std::is_same<LatticeType, FaceCenteredCubicLattice>::value ||
+            3 == num_space_dim,
+        "Face-centered cubic lattices are only available in 3D" );
+
+    Kokkos::Profiling::pushRegion( "Cajita::createLatticeParticles" );
+
+    auto owned = Impl::ownedCells( local_grid );
+    long per_cell = LatticeType::num_basis;
+    for ( std::size_t d = 0; d < num_space_dim; ++d )
+        per_cell *= particles_per_cell_dim;
+    const long num_create = owned.size * per_cell;
+
+    particle_list.aosoa().resize( previous_num_particles + num_create );
+    auto x = particle_list.slice( PositionTag() );
+    auto local_mesh = createLocalMesh<ExecutionSpace>( local_grid );
+    using scalar_type = typename decltype( local_mesh )::scalar_type;
+
+    Kokkos::parallel_for(
+        "Cajita::createLatticeParticles",
+        Kokkos::RangePolicy<ExecutionSpace>( 0, num_create ),
+        KOKKOS_LAMBDA( const long n ) {
+            int index[num_space_dim];
+            Impl::ownedCellIndex( n / per_cell, owned.min, owned.extent,
+                                  index );
+            scalar_type low[num_space_dim];
+            scalar_type high[num_space_dim];
+            Impl::cellBounds( local_mesh, index, low, high );
+
+            long sub = n % per_cell;
+            const int b = sub % LatticeType::num_basis;
+            sub /= LatticeType::num_basis;
+            const std::size_t pid = previous_num_particles + n;
+            for ( int d = num_space_dim - 1; d >= 0; --d )
+            {
+                const int s = sub % particles_per_cell_dim;
+                sub /= particles_per_cell_dim;
+                x( pid, d ) = low[d] + ( s + LatticeType::offset( b, d ) ) *
+                                           ( high[d] - low[d] ) /
+                                           particles_per_cell_dim;
+            }
+        } );
+    Kokkos::fence();
+
+    Kokkos::Profiling::popRegion();
+    return num_create;
+}
+
+/*!
+  \brief Create particles on a regular lattice in the owned cells of a local
+  grid. Default execution space version.
+*/
+template <class LatticeType, class ParticleListType, class PositionTag,
+          class LocalGridType>
+std::size_t createLatticeParticles(
+    LatticeType lattice, ParticleListType& particle_list,
+    PositionTag position_tag, const LocalGridType& local_grid,
+    const int particles_per_cell_dim,
+    const std::size_t previous_num_particles = 0 )
+{
+    using exec_space =
+        typename ParticleListType::memory_space::execution_space;
+    return createLatticeParticles( lattice, exec_space{}, particle_list,
+                                   position_tag, local_grid,
+                                   particles_per_cell_dim,
+                                   previous_num_particles );
+}
+
+//---------------------------------------------------------------------------//
+/*!
+  \brief Create randomly placed particles with a number density given by a
+  cell array.
+
+  The expected number of particles in each owned cell is the density times
+  the cell volume, rounded stochastically. A first pass counts the particles
+  of each cell so the particle list is resized once, and a second pass places
+  them uniformly within their cells. Random numbers are derived from the seed
+  and the global cell index, so the particles are independent of the
+  decomposition.
+
+  \param exec_space Kokkos execution space.
+  \param particle_list The particle list. Created particles are appended
+  after previous_num_particles.
+  \param position_tag Field tag of the particle positions.
+  \param density Scalar cell array of the number density.
+  \param previous_num_particles Number of particles to keep.
+  \param seed Random number seed.
+  \return The number of particles created on this rank.
+*/
+template <class ExecutionSpace, class ParticleListType, class PositionTag,
+          class ArrayType>
+std::enable_if_t<Kokkos::is_execution_space<ExecutionSpace>::value,
+                 std::size_t>
+createDensityParticles( ExecutionSpace, ParticleListType& particle_list,
+                        PositionTag, const ArrayType& density,
+                        const std::size_t previous_num_particles = 0,
+                        const std::uint64_t seed = 342343901 )
+{
+    static_assert( std::is_same<typename ArrayType::entity_type, Cell>::value,
+                   "Density must be a cell array" );
+    static constexpr std::size_t num_space_dim = ArrayType::num_space_dim;
+    using memory_space = typename ExecutionSpace::memory_space;
+
+    Kokkos::Profiling::pushRegion( "Cajita::createDensityParticles" );
+
+    const auto& local_grid = *( density.layout()->localGrid() );
+    const auto& global_grid = local_grid.globalGrid();
+    auto local_mesh = createLocalMesh<ExecutionSpace>( local_grid );
+    using sampler_type =
+        Impl::DensitySampler<decltype( local_mesh ),
+                             typename ArrayType::view_type, num_space_dim>;
+    sampler_type sampler{ local_mesh,
+                          density.view(),
+                          Impl::ownedCells( local_grid ),
+                          {},
+                          {},
+                          seed };
+    for ( std::size_t d = 0; d < num_space_dim; ++d )
+    {
+        sampler.global_offset[d] = global_grid.globalOffset( d );
+        sampler.global_extent[d] = global_grid.globalNumEntity( Cell(), d );
+    }
+
+    // Count the particles of each owned cell and compute their offsets.
+    const long num_cell = sampler.owned.size;
+    Kokkos::View<std::size_t*, memory_space> offsets(
+        Kokkos::ViewAllocateWithoutInitializing(
+            "Cajita::createDensityParticles::offsets" ),
+        num_cell );
+    std::size_t num_create = 0;
+    Kokkos::parallel_scan(
+        "Cajita::createDensityParticles::count",
+        Kokkos::RangePolicy<ExecutionSpace>( 0, num_cell ),
+        KOKKOS_LAMBDA( const long c, std::size_t& offset,
+                       const bool final_pass ) {
+            int index[num_space_dim];
+            const int count = sampler.count( c, index );
+            if ( final_pass )
+                offsets( c ) = offset;
+            offset += count;
+        },
+        num_create );
+
+    // Place the particles.
+    particle_list.aosoa().resize( previous_num_particles + num_create );
+    auto x = particle_list.slice( PositionTag() );
+    Kokkos::parallel_for(
+        "Cajita::createDensityParticles::create",
+        Kokkos::RangePolicy<ExecutionSpace>( 0, num_cell ),
+        KOKKOS_LAMBDA( const long c ) {
+            int index[num_space_dim];
+            const int count = sampler.count( c, index );
+            for ( int p = 0; p < count; ++p )
+            {
+                typename sampler_type::scalar_type px[num_space_dim];
+                sampler.position( index, p, px );
+                const std::size_t pid =
+                    previous_num_particles + offsets( c ) + p;
+                for ( std::size_t d = 0; d < num_space_dim; ++d )
+                    x( pid, d ) = px[d];
+            }
+        } );
+    Kokkos::fence();
+
+    Kokkos::Profiling::popRegion();
+    return num_create;
+}
+
+/*!
+  \brief Create randomly placed particles with a number density given by a
+  cell array. Default execution space version.
+*/
+template <class ParticleListType, class PositionTag, class ArrayType>
+std::size_t
+createDensityParticles( ParticleListType& particle_list,
+                        PositionTag position_tag, const ArrayType& density,
+                        const std::size_t previous_num_particles = 0,
+                        const std::uint64_t seed = 342343901 )
+{
+    using exec_space =
+        typename ParticleListType::memory_space::execution_space;
+    return createDensityParticles( exec_space{}, particle_list, position_tag,
+                                   density, previous_num_particles, seed );
+}
+
+//---------------------------------------------------------------------------//
+
+} // namespace Cajita
+
+#endif // end CAJITA_PARTICLEINIT_HPP
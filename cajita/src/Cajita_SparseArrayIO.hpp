@@ -0,0 +1,454 @@
+/****************************************************************************
+ * Copyright (c) 2018-2022 by the Cabana authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the Cabana library. Cabana is distributed under a   *
+ * BSD 3-clause license. For the licensing terms see the LICENSE file in    *
+ * the top-level directory.                                                 *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+/*!
+  \file Cajita_SparseArrayIO.hpp
+  \brief Output and input of the active tiles of sparse arrays
+*/
+#ifndef CAJITA_SPARSEARRAYIO_HPP
+#define CAJITA_SPARSEARRAYIO_HPP
+
+#include <Cajita_SparseArray.hpp>
+#include <Cajita_Types.hpp>
+
+#include <Cabana_AoSoA.hpp>
+#include <Cabana_BinaryParticleIO.hpp>
+#include <Cabana_DeepCopy.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <mpi.h>
+
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace Cajita
+{
+namespace Experimental
+{
+namespace SparseArrayIO
+{
+//---------------------------------------------------------------------------//
+//! \cond Impl
+namespace Impl
+{
+// File identifier.
+constexpr char magic[8] = { 'C', 'A', 'J', 'T', 'I', 'L', 'E', '1' };
+
+// Alignment of the file sections.
+constexpr std::uint64_t section_alignment = 4096;
+
+inline std::uint64_t alignSection( const std::uint64_t bytes )
+{
+    return ( bytes + section_alignment - 1 ) / section_alignment *
+           section_alignment;
+}
+
+// Compose the name of a sparse array file.
+inline std::string fileName( const std::string& prefix,
+                             const int time_step_index )
+{
+    std::stringstream filename;
+    filename << prefix << "_" << time_step_index << ".tiles";
+    return filename.str();
+}
+
+// Describe the tile data and the global grid it is defined on.
+template <class SparseArrayType>
+std::string sparseArrayLayout( SparseArrayType& array )
+{
+    using map_type = typename SparseArrayType::sparse_map_type;
+    const auto& global_grid = array.layout().localGrid()->globalGrid();
+
+    std::stringstream layout;
+    layout << "SparseArray "
+           << Cabana::Impl::aosoaLayout<
+                  typename SparseArrayType::aosoa_type>()
+           << " tile " << map_type::cell_num_per_tile_dim << " hash "
+           << static_cast<int>( map_type::hash_type ) << " key "
+           << sizeof( typename map_type::key_type ) << " cells";
+    for ( std::size_t d = 0; d < SparseArrayType::num_space_dim; ++d )
+        layout << " " << global_grid.globalNumEntity( Cell(), d );
+    return layout.str();
+}
+
+// Tiles whose first cell is owned by this rank.
+struct OwnedTiles
+{
+    Kokkos::Array<int, 3> min;
+    Kokkos::Array<int, 3> max;
+
+    KOKKOS_INLINE_FUNCTION
+    bool contains( const int tile_i, const int tile_j, const int tile_k ) const
+    {
+        return tile_i >= min[0] && tile_i < max[0] && tile_j >= min[1] &&
+               tile_j < max[1] && tile_k >= min[2] && tile_k < max[2];
+    }
+};
+
+template <class SparseArrayType>
+OwnedTiles ownedTiles( SparseArrayType& array )
+{
+    using map_type = typename SparseArrayType::sparse_map_type;
+    const long n = map_type::cell_num_per_tile_dim;
+    auto owned_cells =
+        array.layout().localGrid()->indexSpace( Own(), Cell(), Global() );
+    OwnedTiles owned;
+    for ( int d = 0; d < 3; ++d )
+    {
+        owned.min[d] = ( owned_cells.min( d ) + n - 1 ) / n;
+        owned.max[d] = ( owned_cells.max( d ) + n - 1 ) / n;
+    }
+    return owned;
+}
+
+// File header. Sections are stored at aligned offsets: the header, the keys
+// of all tiles in rank order and the SoA of each tile in the same order.
+struct FileHeader
+{
+    std::uint64_t num_tile;
+    std::uint64_t key_bytes;
+    std::uint64_t soa_bytes;
+    std::string layout;
+
+    std::uint64_t headerBytes() const
+    {
+        return alignSection( sizeof( magic ) + 4 * sizeof( std::uint64_t ) +
+                             layout.size() );
+    }
+
+    std::uint64_t keyOffset() const { return headerBytes(); }
+
+    std::uint64_t tileOffset() const
+    {
+        return keyOffset() + alignSection( num_tile * key_bytes );
+    }
+
+    std::vector<char> pack() const
+    {
+        std::vector<char> buffer( std::begin( magic ), std::end( magic ) );
+        std::uint64_t values[4] = { num_tile, key_bytes, soa_bytes,
+                                    layout.size() };
+        const char* data = reinterpret_cast<const char*>( values );
+        buffer.insert( buffer.end(), data, data + sizeof( values ) );
+        buffer.insert( buffer.end(), layout.begin(), layout.end() );
+        return buffer;
+    }
+};
+
+// Contiguous MPI type of the given size.
+inline MPI_Datatype createByteType( const std::size_t bytes )
+{
+    MPI_Datatype type;
+    MPI_Type_contiguous( static_cast<int>( bytes ), MPI_BYTE, &type );
+    MPI_Type_commit( &type );
+    return type;
+}
+
+} // namespace Impl
+//! \endcond
+
+//---------------------------------------------------------------------------//
+/*!
+  \brief Write the active tiles of a sparse array.
+
+  Each rank writes the keys and the SoA of the active tiles it owns, so the
+  output size scales with the number of active cells. Tiles are found from
+  the sparse map and are not densified. Collective over the grid
+  communicator.
+
+  \param prefix Filename prefix.
+  \param time_step_index Simulation step index.
+  \param array The sparse array.
+*/
+template <class SparseArrayType>
+void writeTimeStep( const std::string& prefix, const int time_step_index,
+                    SparseArrayType& array )
+{
+    static_assert( is_sparse_array<SparseArrayType>::value,
+                   "Cajita::SparseArray required" );
+    using map_type = typename SparseArrayType::sparse_map_type;
+    using key_type = typename map_type::key_type;
+    using aosoa_type = typename SparseArrayType::aosoa_type;
+    using memory_space = typename SparseArrayType::memory_space;
+    using execution_space = typename SparseArrayType::execution_space;
+
+    Kokkos::Profiling::pushRegion( "Cajita::SparseArrayIO::writeTimeStep" );
+
+    auto& map = array.layout().sparseMap();
+    auto data = array.aosoa();
+    auto owned = Impl::ownedTiles( array );
+    MPI_Comm comm = array.layout().localGrid()->globalGrid().comm();
+
+    // Gather the keys and data of the owned active tiles.
+    int num_local = 0;
+    Kokkos::parallel_reduce(
+        "Cajita::SparseArrayIO::count",
+        Kokkos::RangePolicy<execution_space>( 0, map.capacity() ),
+        KOKKOS_LAMBDA( const int index, int& count ) {
+            if ( map.valid_at( index ) )
+            {
+                auto key = map.key_at( index );
+                int ti, tj, tk;
+                map.key2ijk( key, ti, tj, tk );
+                if ( owned.contains( ti, tj, tk ) )
+                    ++count;
+            }
+        },
+        num_local );
+    Kokkos::View<key_type*, memory_space> keys(
+        Kokkos::ViewAllocateWithoutInitializing( "Cajita::SparseArrayIO::keys" ),
+        num_local );
+    aosoa_type tiles( "Cajita::SparseArrayIO::tiles",
+                      num_local * aosoa_type::vector_length );
+    Kokkos::parallel_scan(
+        "Cajita::SparseArrayIO::gather",
+        Kokkos::RangePolicy<execution_space>( 0, map.capacity() ),
+        KOKKOS_LAMBDA( const int index, int& offset, const bool final_pass ) {
+            if ( map.valid_at( index ) )
+            {
+                auto key = map.key_at( index );
+                int ti, tj, tk;
+                map.key2ijk( key, ti, tj, tk );
+                if ( owned.contains( ti, tj, tk ) )
+                {
+                    if ( final_pass )
+                    {
+                        keys( offset ) = map.key_at( index );
+                        tiles.access( offset ) =
+                            data.access( map.value_at( index ) );
+                    }
+                    ++offset;
+                }
+            }
+        } );
+    auto host_keys =
+        Kokkos::create_mirror_view_and_copy( Kokkos::HostSpace(), keys );
+    auto host_tiles =
+        Cabana::create_mirror_view_and_copy( Kokkos::HostSpace(), tiles );
+
+    // Tile offset of this rank and global number of tiles.
+    long long local_count = num_local;
+    long long tile_offset = 0;
+    MPI_Exscan( &local_count, &tile_offset, 1, MPI_LONG_LONG, MPI_SUM, comm );
+    int comm_rank;
+    MPI_Comm_rank( comm, &comm_rank );
+    if ( 0 == comm_rank )
+        tile_offset = 0;
+    long long num_tile = 0;
+    MPI_Allreduce( &local_count, &num_tile, 1, MPI_LONG_LONG, MPI_SUM, comm );
+
+    Impl::FileHeader header;
+    header.num_tile = num_tile;
+    header.key_bytes = sizeof( key_type );
+    header.soa_bytes = sizeof( typename aosoa_type::soa_type );
+    header.layout = Impl::sparseArrayLayout( array );
+
+    // Write the file.
+    MPI_File file;
+    auto filename = Impl::fileName( prefix, time_step_index );
+    if ( MPI_SUCCESS != MPI_File_open( comm, filename.c_str(),
+                                       MPI_MODE_WRONLY | MPI_MODE_CREATE,
+                                       MPI_INFO_NULL, &file ) )
+        throw std::runtime_error( "Could not open sparse array file " +
+                                  filename );
+    MPI_File_set_size( file, header.tileOffset() +
+                                 header.num_tile * header.soa_bytes );
+    if ( 0 == comm_rank )
+    {
+        auto buffer = header.pack();
+        MPI_File_write_at( file, 0, buffer.data(), buffer.size(), MPI_BYTE,
+                           MPI_STATUS_IGNORE );
+    }
+    auto key_type_id = Impl::createByteType( header.key_bytes );
+    auto tile_type_id = Impl::createByteType( header.soa_bytes );
+    MPI_File_write_at_all( file,
+                           header.keyOffset() + tile_offset * header.key_bytes,
+                           host_keys.data(), num_local, key_type_id,
+                           MPI_STATUS_IGNORE );
+    MPI_File_write_at_all(
+        file, header.tileOffset() + tile_offset * header.soa_bytes,
+        host_tiles.data(), num_local, tile_type_id, MPI_STATUS_IGNORE );
+    MPI_Type_free( &key_type_id );
+    MPI_Type_free( &tile_type_id );
+    MPI_File_close( &file );
+
+    Kokkos::Profiling::popRegion();
+}
+
+//---------------------------------------------------------------------------//
+/*!
+  \brief Read the active tiles of a sparse array.
+
+  Each rank reads the keys of all tiles and then only the data of the tiles
+  it owns. The tiles are inserted into the sparse map of the array in one
+  batch, the array is resized to the sparse map and the tile data is copied
+  in. Tiles already in the map are kept. The ranks do not need to have the
+  same decomposition as when the file was written but the sparse map must
+  have the capacity for the new tiles. Collective over the grid
+  communicator.
+
+  \param prefix Filename prefix.
+  \param time_step_index Simulation step index.
+  \param array The sparse array. Must have the same member types, tile size
+  and global grid as the array that was written.
+*/
+template <class SparseArrayType>
+void readTimeStep( const std::string& prefix, const int time_step_index,
+                   SparseArrayType& array )
+{
+    static_assert( is_sparse_array<SparseArrayType>::value,
+                   "Cajita::SparseArray required" );
+    using map_type = typename SparseArrayType::sparse_map_type;
+    using key_type = typename map_type::key_type;
+    using aosoa_type = typename SparseArrayType::aosoa_type;
+    using memory_space = typename SparseArrayType::memory_space;
+    using execution_space = typename SparseArrayType::execution_space;
+
+    Kokkos::Profiling::pushRegion( "Cajita::SparseArrayIO::readTimeStep" );
+
+    auto& map = array.layout().sparseMap();
+    auto owned = Impl::ownedTiles( array );
+    MPI_Comm comm = array.layout().localGrid()->globalGrid().comm();
+
+    MPI_File file;
+    auto filename = Impl::fileName( prefix, time_step_index );
+    if ( MPI_SUCCESS != MPI_File_open( comm, filename.c_str(),
+                                       MPI_MODE_RDONLY, MPI_INFO_NULL,
+                                       &file ) )
+        throw std::runtime_error( "Could not open sparse array file " +
+                                  filename );
+
+    // Read and check the header. All ranks read the same header and reach
+    // the same result.
+    Impl::FileHeader header;
+    std::vector<char> buffer( sizeof( Impl::magic ) +
+                              4 * sizeof( std::uint64_t ) );
+    MPI_File_read_at_all( file, 0, buffer.data(), buffer.size(), MPI_BYTE,
+                          MPI_STATUS_IGNORE );
+    std::uint64_t values[4];
+    std::memcpy( values, buffer.data() + sizeof( Impl::magic ),
+                 sizeof( values ) );
+    bool valid =
+        0 == std::memcmp( buffer.data(), Impl::magic, sizeof( Impl::magic ) );
+    if ( valid )
+    {
+        header.num_tile = values[0];
+        header.key_bytes = values[1];
+        header.soa_bytes = values[2];
+        header.layout.resize( values[3] );
+        MPI_File_read_at_all( file, buffer.size(), &header.layout[0],
+                              header.layout.size(), MPI_BYTE,
+                              MPI_STATUS_IGNORE );
+    }
+    auto layout = Impl::sparseArrayLayout( array );
+    if ( !valid || header.layout != layout )
+    {
+        MPI_File_close( &file );
+        throw std::runtime_error(
+            "Sparse array file " + filename + " has layout " +
+            ( valid ? header.layout : std::string( "unknown" ) ) +
+            ", expected " + layout );
+    }
+
+    // Read all keys and select the owned tiles.
+    std::vector<key_type> all_keys( header.num_tile );
+    auto key_type_id = Impl::createByteType( header.key_bytes );
+    MPI_File_read_at_all( file, header.keyOffset(), all_keys.data(),
+                          all_keys.size(), key_type_id, MPI_STATUS_IGNORE );
+    MPI_Type_free( &key_type_id );
+    std::vector<MPI_Aint> displacements;
+    std::vector<key_type> selected_keys;
+    for ( std::size_t t = 0; t < all_keys.size(); ++t )
+    {
+        int ti, tj, tk;
+        map.key2ijk( all_keys[t], ti, tj, tk );
+        if ( owned.contains( ti, tj, tk ) )
+        {
+            displacements.push_back( t * header.soa_bytes );
+            selected_keys.push_back( all_keys[t] );
+        }
+    }
+    int num_local = selected_keys.size();
+
+    // Read the data of the selected tiles.
+    Cabana::AoSoA<typename aosoa_type::member_types, Kokkos::HostSpace,
+                  aosoa_type::vector_length>
+        host_tiles( "Cajita::SparseArrayIO::tiles",
+                    num_local * aosoa_type::vector_length );
+    auto tile_type_id = Impl::createByteType( header.soa_bytes );
+    MPI_Datatype file_type = tile_type_id;
+    if ( num_local > 0 )
+    {
+        MPI_Type_create_hindexed_block( num_local, 1, displacements.data(),
+                                        tile_type_id, &file_type );
+        MPI_Type_commit( &file_type );
+    }
+    MPI_File_set_view( file, header.tileOffset(), MPI_BYTE, file_type,
+                       "native", MPI_INFO_NULL );
+    MPI_File_read_all( file, host_tiles.data(), num_local, tile_type_id,
+                       MPI_STATUS_IGNORE );
+    if ( num_local > 0 )
+        MPI_Type_free( &file_type );
+    MPI_Type_free( &tile_type_id );
+    MPI_File_close( &file );
+
+    // The new tiles must fit in the sparse map.
+    int full = ( map.capacity() < map.size() + num_local );
+    MPI_Allreduce( MPI_IN_PLACE, &full, 1, MPI_INT, MPI_MAX, comm );
+    if ( full )
+        throw std::runtime_error( "Sparse map capacity too small to read " +
+                                  filename );
+
+    // Insert the tiles in one batch and copy their data in.
+    Kokkos::View<key_type*, Kokkos::HostSpace,
+                 Kokkos::MemoryTraits<Kokkos::Unmanaged>>
+        host_keys( selected_keys.data(), num_local );
+    auto keys = Kokkos::create_mirror_view_and_copy( memory_space(),
+                                                     host_keys );
+    Kokkos::parallel_for(
+        "Cajita::SparseArrayIO::insert",
+        Kokkos::RangePolicy<execution_space>( 0, num_local ),
+        KOKKOS_LAMBDA( const int t ) {
+            auto key = keys( t );
+            int ti, tj, tk;
+            map.key2ijk( key, ti, tj, tk );
+            map.insertTile( ti, tj, tk );
+        } );
+    Kokkos::fence();
+    array.resize();
+
+    auto tiles = Cabana::create_mirror_view_and_copy( memory_space(),
+                                                      host_tiles );
+    auto data = array.aosoa();
+    Kokkos::parallel_for(
+        "Cajita::SparseArrayIO::scatter",
+        Kokkos::RangePolicy<execution_space>( 0, num_local ),
+        KOKKOS_LAMBDA( const int t ) {
+            data.access( map.queryTileFromTileKey( keys( t ) ) ) =
+                tiles.access( t );
+        } );
+    Kokkos::fence();
+
+    Kokkos::Profiling::popRegion();
+}
+
+//---------------------------------------------------------------------------//
+
+} // namespace SparseArrayIO
+} // namespace Experimental
+} // namespace Cajita
+
+#endif // end CAJITA_SPARSEARRAYIO_HPP
@@ -19,6 +19,7 @@
 #include <Cajita_Types.hpp>
 
 #include <Kokkos_Core.hpp>
+#include <Kokkos_Random.hpp>
 
 #include <gtest/gtest.h>
 
@@ -27,7 +28,10 @@
 #include <array>
 #include <cmath>
 #include <fstream>
+#include <iterator>
 #include <memory>
+#include <string>
+#include <vector>
 
 using namespace Cajita;
 
@@ -342,6 +346,74 @@ void writeTest2d()
     }
 }
 
+//---------------------------------------------------------------------------//
+// Read a whole file.
+std::vector<char> readFile( const std::string& file_name )
+{
+    std::ifstream file( file_name, std::ios::binary );
+    return std::vector<char>( std::istreambuf_iterator<char>( file ),
+                              std::istreambuf_iterator<char>() );
+}
+
+//---------------------------------------------------------------------------//
+template <std::size_t NumSpaceDim, class EntityType>
+void collectiveWriteTest( const std::string& label, const int dofs,
+                          EntityType entity_type )
+{
+    // Create the global grid.
+    DimBlockPartitioner<NumSpaceDim> partitioner;
+    std::array<int, NumSpaceDim> global_num_cell;
+    std::array<double, NumSpaceDim> global_low_corner;
+    std::array<double, NumSpaceDim> global_high_corner;
+    std::array<bool, NumSpaceDim> is_dim_periodic;
+    for ( std::size_t d = 0; d < NumSpaceDim; ++d )
+    {
+        global_num_cell[d] = 13 + 2 * d;
+        global_low_corner[d] = -1.0;
+        global_high_corner[d] = -1.0 + 0.5 * global_num_cell[d];
+        is_dim_periodic[d] = ( d != 1 );
+    }
+    auto global_mesh = createUniformGlobalMesh(
+        global_low_corner, global_high_corner, global_num_cell );
+    auto global_grid = createGlobalGrid( MPI_COMM_WORLD, global_mesh,
+                                         is_dim_periodic, partitioner );
+
+    // Fill the owned entities with a random field.
+    auto layout = createArrayLayout( global_grid, 1, dofs, entity_type );
+    auto field = createArray<double, TEST_DEVICE>( label, layout );
+    Kokkos::Random_XorShift64_Pool<TEST_EXECSPACE> pool( 1234 );
+    Kokkos::fill_random( field->view(), pool, 1.0 );
+
+    // Write with the default writer and with chunked collective writes.
+    int rank;
+    MPI_Comm_rank( MPI_COMM_WORLD, &rank );
+    Experimental::BovWriter::writeTimeStep( 0, 0.5, *field );
+
+    Experimental::BovWriter::BovConfig config;
+    config.chunk_bytes = 1;
+    config.num_aggregators = 1;
+    Experimental::BovWriter::writeTimeStep( config, 1, 0.5, *field );
+
+    config.chunk_bytes = 1024;
+    config.num_aggregators = 0;
+    config.cb_buffer_bytes = 1024 * 1024;
+    config.async = true;
+    auto request =
+        Experimental::BovWriter::writeTimeStep( config, 2, 0.5, *field );
+    request.wait();
+
+    // The files are the same.
+    if ( 0 == rank )
+    {
+        auto expected = readFile( "grid_" + label + "_000000.dat" );
+        EXPECT_FALSE( expected.empty() );
+        EXPECT_TRUE( expected == readFile( "grid_" + label + "_000001.dat" ) );
+        EXPECT_TRUE( expected == readFile( "grid_" + label + "_000002.dat" ) );
+        EXPECT_TRUE( readFile( "grid_" + label + "_000000.bov" ).size() ==
+                     readFile( "grid_" + label + "_000001.bov" ).size() );
+    }
+}
+
 //---------------------------------------------------------------------------//
 // RUN TESTS
 //---------------------------------------------------------------------------//
@@ -349,6 +421,13 @@ TEST( TEST_CATEGORY, write_test_3d ) { writeTest3d(); }
 
 TEST( TEST_CATEGORY, write_test_2d ) { writeTest2d(); }
 
+TEST( TEST_CATEGORY, collective_write_test )
+{
+    collectiveWriteTest<3>( "cell_collective_3d", 1, Cell() );
+    collectiveWriteTest<3>( "node_collective_3d", 3, Node() );
+    collectiveWriteTest<2>( "node_collective_2d", 2, Node() );
+}
+
 //---------------------------------------------------------------------------//
 
 } // end namespace Test
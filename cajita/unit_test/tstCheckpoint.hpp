@@ -0,0 +1,151 @@
+/****************************************************************************
+ * Copyright (c) 2018-2022 by the Cabana authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the Cabana library. Cabana is distributed under a   *
+ * BSD 3-clause license. For the licensing terms see the LICENSE file in    *
+ * the top-level directory.                                                 *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#include <Cajita_Array.hpp>
+#include <Cajita_Checkpoint.hpp>
+#include <Cajita_GlobalGrid.hpp>
+#include <Cajita_GlobalMesh.hpp>
+#include <Cajita_IndexSpace.hpp>
+#include <Cajita_Partitioner.hpp>
+#include <Cajita_Types.hpp>
+
+#include <Cabana_AoSoA.hpp>
+#include <Cabana_Checkpoint.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <gtest/gtest.h>
+
+#include <mpi.h>
+
+#include <array>
+#include <stdexcept>
+
+using namespace Cajita;
+
+namespace Test
+{
+//---------------------------------------------------------------------------//
+template <class ArrayType>
+void fillArray( ArrayType& array )
+{
+    const auto& global_grid = array.layout()->localGrid()->globalGrid();
+    int off_i = global_grid.globalOffset( Dim::I );
+    int off_j = global_grid.globalOffset( Dim::J );
+    int off_k = global_grid.globalOffset( Dim::K );
+    auto data = array.view();
+    int num_dof = data.extent( 3 );
+    Kokkos::parallel_for(
+        "fill", createExecutionPolicy(
+                    array.layout()->indexSpace( Own(), Local() ),
+                    TEST_EXECSPACE() ),
+        KOKKOS_LAMBDA( const int i, const int j, const int k, const int l ) {
+            data( i, j, k, l ) =
+                ( ( off_i + i ) * 1000 + ( off_j + j ) * 100 + off_k + k ) *
+                    num_dof +
+                l;
+        } );
+}
+
+//---------------------------------------------------------------------------//
+template <class ArrayType>
+void checkArray( const ArrayType& expected, const ArrayType& array )
+{
+    auto owned_space = array.layout()->indexSpace( Own(), Local() );
+    auto expected_host = Kokkos::create_mirror_view_and_copy(
+        Kokkos::HostSpace(), expected.view() );
+    auto host = Kokkos::create_mirror_view_and_copy( Kokkos::HostSpace(),
+                                                     array.view() );
+    for ( int i = owned_space.min( 0 ); i < owned_space.max( 0 ); ++i )
+        for ( int j = owned_space.min( 1 ); j < owned_space.max( 1 ); ++j )
+            for ( int k = owned_space.min( 2 ); k < owned_space.max( 2 ); ++k )
+                for ( int l = 0; l < owned_space.max( 3 ); ++l )
+                    EXPECT_EQ( host( i, j, k, l ),
+                               expected_host( i, j, k, l ) );
+}
+
+//---------------------------------------------------------------------------//
+void checkpointTest( const int num_files )
+{
+    // Create the global grid.
+    DimBlockPartitioner<3> partitioner;
+    std::array<int, 3> global_num_cell = { 12, 9, 11 };
+    std::array<double, 3> global_low_corner = { -1.0, 0.0, 2.5 };
+    std::array<double, 3> global_high_corner = { 2.0, 2.25, 5.25 };
+    std::array<bool, 3> is_dim_periodic = { true, false, true };
+    auto global_mesh = createUniformGlobalMesh(
+        global_low_corner, global_high_corner, global_num_cell );
+    auto global_grid = createGlobalGrid( MPI_COMM_WORLD, global_mesh,
+                                         is_dim_periodic, partitioner );
+
+    // Create grid arrays.
+    auto cell_layout = createArrayLayout( global_grid, 1, 2, Cell() );
+    auto cell_field =
+        createArray<double, TEST_DEVICE>( "cell_field", cell_layout );
+    fillArray( *cell_field );
+    auto node_layout = createArrayLayout( global_grid, 2, 3, Node() );
+    auto node_field =
+        createArray<int, TEST_DEVICE>( "node_field", node_layout );
+    fillArray( *node_field );
+
+    // Create particles.
+    int comm_rank;
+    MPI_Comm_rank( MPI_COMM_WORLD, &comm_rank );
+    using DataTypes = Cabana::MemberTypes<double[3], int>;
+    Cabana::AoSoA<DataTypes, TEST_DEVICE> particles( "particles",
+                                                     10 + comm_rank );
+    Cabana::deep_copy( particles, Cabana::Tuple<DataTypes>() );
+
+    // Checkpoint the grid and particle state in one operation.
+    Cabana::Experimental::Checkpoint::CheckpointConfig config;
+    config.num_files = num_files;
+    Cabana::Experimental::Checkpoint::Writer writer( MPI_COMM_WORLD, config );
+    Experimental::Checkpoint::add( writer, *cell_field );
+    Experimental::Checkpoint::add( writer, *node_field );
+    writer.add( "particles", particles );
+    writer.write( "grid_checkpoint", num_files );
+
+    // Restore into new arrays.
+    Cabana::Experimental::Checkpoint::Reader reader(
+        MPI_COMM_WORLD, "grid_checkpoint", num_files, config );
+    auto cell_read =
+        createArray<double, TEST_DEVICE>( "cell_field", cell_layout );
+    Experimental::Checkpoint::read( reader, *cell_read );
+    checkArray( *cell_field, *cell_read );
+    auto node_read = createArray<int, TEST_DEVICE>( "node_field", node_layout );
+    Experimental::Checkpoint::read( reader, *node_read );
+    checkArray( *node_field, *node_read );
+    Cabana::AoSoA<DataTypes, TEST_DEVICE> particles_read( "particles" );
+    reader.read( "particles", particles_read );
+    EXPECT_EQ( particles_read.size(), particles.size() );
+
+    // Arrays on a different grid cannot be restored.
+    auto wrong_layout = createArrayLayout( global_grid, 1, 3, Cell() );
+    auto wrong_read =
+        createArray<double, TEST_DEVICE>( "cell_field", wrong_layout );
+    EXPECT_THROW( Experimental::Checkpoint::read( reader, *wrong_read ),
+                  std::runtime_error );
+}
+
+//---------------------------------------------------------------------------//
+// RUN TESTS
+//---------------------------------------------------------------------------//
+TEST( TEST_CATEGORY, checkpoint_test )
+{
+    int comm_size;
+    MPI_Comm_size( MPI_COMM_WORLD, &comm_size );
+    checkpointTest( 1 );
+    checkpointTest( comm_size );
+}
+
+//---------------------------------------------------------------------------//
+
+} // end namespace Test
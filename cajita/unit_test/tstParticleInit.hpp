@@ -0,0 +1,217 @@
+/****************************************************************************
+ * Copyright (c) 2018-2022 by the Cabana authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the Cabana library. Cabana is distributed under a   *
+ * BSD 3-clause license. For the licensing terms see the LICENSE file in    *
+ * the top-level directory.                                                 *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#include <Cabana_DeepCopy.hpp>
+#include <Cabana_Fields.hpp>
+
+#include <Cajita_Array.hpp>
+#include <Cajita_GlobalGrid.hpp>
+#include <Cajita_GlobalMesh.hpp>
+#include <Cajita_LocalGrid.hpp>
+#include <Cajita_LocalMesh.hpp>
+#include <Cajita_ParticleInit.hpp>
+#include <Cajita_ParticleList.hpp>
+#include <Cajita_Partitioner.hpp>
+#include <Cajita_Types.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <gtest/gtest.h>
+
+#include <mpi.h>
+
+#include <array>
+#include <cmath>
+#include <vector>
+
+using namespace Cajita;
+
+namespace Test
+{
+//---------------------------------------------------------------------------//
+auto createTestLocalGrid()
+{
+    std::array<double, 3> low_corner = { -1.0, 0.0, 1.0 };
+    std::array<double, 3> high_corner = { 0.0, 1.0, 2.0 };
+    double cell_size = 0.1;
+    auto global_mesh =
+        createUniformGlobalMesh( low_corner, high_corner, cell_size );
+    DimBlockPartitioner<3> partitioner;
+    std::array<bool, 3> is_dim_periodic = { false, false, false };
+    auto global_grid = createGlobalGrid( MPI_COMM_WORLD, global_mesh,
+                                         is_dim_periodic, partitioner );
+    return createLocalGrid( global_grid, 1 );
+}
+
+//---------------------------------------------------------------------------//
+template <class LatticeType>
+void latticeTest()
+{
+    auto local_grid = createTestLocalGrid();
+    auto local_mesh = createLocalMesh<Kokkos::HostSpace>( *local_grid );
+    auto owned_cells = local_grid->indexSpace( Own(), Cell(), Local() );
+
+    using position_tag = Cabana::Field::Position<3>;
+    auto particles =
+        ParticleList<TEST_MEMSPACE, position_tag>( "lattice_particles" );
+
+    // Every owned cell gets the same number of particles.
+    int ppc = 2;
+    auto num_create = createLatticeParticles( LatticeType(), TEST_EXECSPACE(),
+                                              particles, position_tag(),
+                                              *local_grid, ppc );
+    std::size_t per_cell = ppc * ppc * ppc * LatticeType::num_basis;
+    EXPECT_EQ( num_create, owned_cells.size() * per_cell );
+    EXPECT_EQ( particles.aosoa().size(), num_create );
+
+    // All ranks together fill the global grid.
+    std::size_t global_num_create = 0;
+    MPI_Allreduce( &num_create, &global_num_create, 1, MPI_UNSIGNED_LONG,
+                   MPI_SUM, MPI_COMM_WORLD );
+    EXPECT_EQ( global_num_create, 10 * 10 * 10 * per_cell );
+
+    // Particles are on the lattice inside the owned domain.
+    auto host_aosoa = Cabana::create_mirror_view_and_copy(
+        Kokkos::HostSpace(), particles.aosoa() );
+    auto x = Cabana::slice<0>( host_aosoa );
+    double spacing = 0.1 / ppc;
+    for ( std::size_t p = 0; p < num_create; ++p )
+        for ( int d = 0; d < 3; ++d )
+        {
+            EXPECT_GE( x( p, d ), local_mesh.lowCorner( Own(), d ) );
+            EXPECT_LT( x( p, d ), local_mesh.highCorner( Own(), d ) );
+            double lattice_x =
+                ( x( p, d ) - local_mesh.lowCorner( Own(), d ) ) / spacing;
+            double offset = lattice_x - std::floor( lattice_x );
+            bool on_lattice = false;
+            for ( int b = 0; b < LatticeType::num_basis; ++b )
+                if ( std::abs( offset - LatticeType::offset( b, d ) ) < 1e-8 )
+                    on_lattice = true;
+            EXPECT_TRUE( on_lattice );
+        }
+
+    // Particles can be appended to existing ones.
+    auto num_append = createLatticeParticles(
+        LatticeType(), TEST_EXECSPACE(), particles, position_tag(),
+        *local_grid, 1, num_create );
+    EXPECT_EQ( num_append,
+               std::size_t( owned_cells.size() * LatticeType::num_basis ) );
+    EXPECT_EQ( particles.aosoa().size(), num_create + num_append );
+    auto append_aosoa = Cabana::create_mirror_view_and_copy(
+        Kokkos::HostSpace(), particles.aosoa() );
+    auto x_append = Cabana::slice<0>( append_aosoa );
+    for ( std::size_t p = 0; p < num_create; ++p )
+        for ( int d = 0; d < 3; ++d )
+            EXPECT_EQ( x_append( p, d ), x( p, d ) );
+}
+
+//---------------------------------------------------------------------------//
+void densityTest()
+{
+    auto local_grid = createTestLocalGrid();
+    auto local_mesh = createLocalMesh<Kokkos::HostSpace>( *local_grid );
+    auto owned_cells = local_grid->indexSpace( Own(), Cell(), Local() );
+    const auto& global_grid = local_grid->globalGrid();
+
+    // 2.5 particles per cell in the lower half of the domain in x.
+    auto layout = createArrayLayout( local_grid, 1, Cell() );
+    auto density = createArray<double, TEST_DEVICE>( "density", layout );
+    auto density_host = Kokkos::create_mirror_view( density->view() );
+    Kokkos::deep_copy( density_host, 0.0 );
+    for ( int i = owned_cells.min( Dim::I ); i < owned_cells.max( Dim::I );
+          ++i )
+        for ( int j = owned_cells.min( Dim::J ); j < owned_cells.max( Dim::J );
+              ++j )
+            for ( int k = owned_cells.min( Dim::K );
+                  k < owned_cells.max( Dim::K ); ++k )
+            {
+                int global_i = i - owned_cells.min( Dim::I ) +
+                               global_grid.globalOffset( Dim::I );
+                if ( global_i < 5 )
+                    density_host( i, j, k, 0 ) = 2500.0;
+            }
+    Kokkos::deep_copy( density->view(), density_host );
+
+    using position_tag = Cabana::Field::Position<3>;
+    auto particles =
+        ParticleList<TEST_MEMSPACE, position_tag>( "density_particles" );
+    auto num_create = createDensityParticles(
+        TEST_EXECSPACE(), particles, position_tag(), *density );
+    EXPECT_EQ( particles.aosoa().size(), num_create );
+
+    // Bin the particles into the owned cells.
+    auto host_aosoa = Cabana::create_mirror_view_and_copy(
+        Kokkos::HostSpace(), particles.aosoa() );
+    auto x = Cabana::slice<0>( host_aosoa );
+    std::vector<int> cell_count( owned_cells.size(), 0 );
+    for ( std::size_t p = 0; p < num_create; ++p )
+    {
+        int cell[3];
+        for ( int d = 0; d < 3; ++d )
+        {
+            EXPECT_GE( x( p, d ), local_mesh.lowCorner( Own(), d ) );
+            EXPECT_LT( x( p, d ), local_mesh.highCorner( Own(), d ) );
+            cell[d] = static_cast<int>( std::floor(
+                ( x( p, d ) - local_mesh.lowCorner( Own(), d ) ) / 0.1 ) );
+        }
+        ++cell_count[( cell[0] * owned_cells.extent( Dim::J ) + cell[1] ) *
+                         owned_cells.extent( Dim::K ) +
+                     cell[2]];
+    }
+
+    // The count of each cell is the expected count rounded up or down.
+    for ( int i = 0; i < owned_cells.extent( Dim::I ); ++i )
+        for ( int j = 0; j < owned_cells.extent( Dim::J ); ++j )
+            for ( int k = 0; k < owned_cells.extent( Dim::K ); ++k )
+            {
+                int count = cell_count[( i * owned_cells.extent( Dim::J ) +
+                                         j ) *
+                                           owned_cells.extent( Dim::K ) +
+                                       k];
+                if ( i + global_grid.globalOffset( Dim::I ) < 5 )
+                {
+                    EXPECT_GE( count, 2 );
+                    EXPECT_LE( count, 3 );
+                }
+                else
+                {
+                    EXPECT_EQ( count, 0 );
+                }
+            }
+
+    // The same seed creates the same particles.
+    auto same = ParticleList<TEST_MEMSPACE, position_tag>( "same_particles" );
+    auto num_same = createDensityParticles( TEST_EXECSPACE(), same,
+                                            position_tag(), *density );
+    ASSERT_EQ( num_same, num_create );
+    auto same_aosoa = Cabana::create_mirror_view_and_copy( Kokkos::HostSpace(),
+                                                           same.aosoa() );
+    auto x_same = Cabana::slice<0>( same_aosoa );
+    for ( std::size_t p = 0; p < num_create; ++p )
+        for ( int d = 0; d < 3; ++d )
+            EXPECT_EQ( x_same( p, d ), x( p, d ) );
+}
+
+//---------------------------------------------------------------------------//
+// RUN TESTS
+//---------------------------------------------------------------------------//
+TEST( TEST_CATEGORY, lattice_test )
+{
+    latticeTest<SimpleCubicLattice>();
+    latticeTest<BodyCenteredCubicLattice>();
+    latticeTest<FaceCenteredCubicLattice>();
+}
+
+TEST( TEST_CATEGORY, density_test ) { densityTest(); }
+
+//---------------------------------------------------------------------------//
+
+} // end namespace Test
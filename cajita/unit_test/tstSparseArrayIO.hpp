@@ -0,0 +1,204 @@
+/****************************************************************************
+ * Copyright (c) 2018-2022 by the Cabana authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the Cabana library. Cabana is distributed under a   *
+ * BSD 3-clause license. For the licensing terms see the LICENSE file in    *
+ * the top-level directory.                                                 *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#include <Cajita_SparseArray.hpp>
+#include <Cajita_SparseArrayIO.hpp>
+#include <Cajita_SparseDimPartitioner.hpp>
+#include <Cajita_SparseLocalGrid.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <gtest/gtest.h>
+
+#include <mpi.h>
+
+#include <array>
+#include <stdexcept>
+#include <vector>
+
+using namespace Cajita;
+using namespace Cajita::Experimental;
+
+namespace Test
+{
+//---------------------------------------------------------------------------//
+void sparseArrayIOTest()
+{
+    constexpr int size_tile_per_dim = 16;
+    constexpr int cell_per_tile_dim = 4;
+    constexpr int size_per_dim = size_tile_per_dim * cell_per_tile_dim;
+
+    // Create the global mesh.
+    double cell_size = 0.1;
+    std::array<int, 3> global_num_cell = { size_per_dim, size_per_dim,
+                                           size_per_dim };
+    std::array<double, 3> global_low_corner = { 0.0, -1.0, 1.0 };
+    std::array<double, 3> global_high_corner;
+    for ( int d = 0; d < 3; ++d )
+        global_high_corner[d] =
+            global_low_corner[d] + cell_size * global_num_cell[d];
+    std::array<bool, 3> is_dim_periodic = { false, false, false };
+    auto global_mesh = createSparseGlobalMesh(
+        global_low_corner, global_high_corner, global_num_cell );
+
+    // Uniform tile partition.
+    SparseDimPartitioner<TEST_DEVICE, cell_per_tile_dim> partitioner(
+        MPI_COMM_WORLD, 1.5, size_per_dim * size_per_dim * size_per_dim, 100,
+        global_num_cell );
+    auto ranks_per_dim =
+        partitioner.ranksPerDimension( MPI_COMM_WORLD, global_num_cell );
+    std::array<std::vector<int>, 3> rec_partition;
+    for ( int d = 0; d < 3; ++d )
+        for ( int r = 0; r <= ranks_per_dim[d]; ++r )
+            rec_partition[d].push_back( r * size_tile_per_dim /
+                                        ranks_per_dim[d] );
+    partitioner.initializeRecPartition( rec_partition[0], rec_partition[1],
+                                        rec_partition[2] );
+    auto global_grid = createGlobalGrid( MPI_COMM_WORLD, global_mesh,
+                                         is_dim_periodic, partitioner );
+    auto local_grid =
+        createSparseLocalGrid( global_grid, 2, cell_per_tile_dim );
+
+    // Activate every third owned tile and one tile in the halo.
+    int pre_alloc_size =
+        size_tile_per_dim * size_tile_per_dim * size_tile_per_dim;
+    auto sparse_map =
+        createSparseMap<TEST_EXECSPACE>( global_mesh, pre_alloc_size );
+    using DataTypes = Cabana::MemberTypes<double, int[3]>;
+    auto layout =
+        createSparseArrayLayout<DataTypes>( local_grid, sparse_map, Cell() );
+    auto array = createSparseArray<TEST_DEVICE>( "sparse", *layout );
+
+    auto owned_cells = local_grid->indexSpace( Own(), Cell(), Global() );
+    Kokkos::Array<int, 3> tile_min;
+    Kokkos::Array<int, 3> tile_max;
+    for ( int d = 0; d < 3; ++d )
+    {
+        tile_min[d] = owned_cells.min( d ) / cell_per_tile_dim;
+        tile_max[d] = owned_cells.max( d ) / cell_per_tile_dim;
+    }
+    Kokkos::parallel_for(
+        "activate", Kokkos::RangePolicy<TEST_EXECSPACE>( 0, 1 ),
+        KOKKOS_LAMBDA( const int ) {
+            for ( int i = tile_min[0]; i < tile_max[0]; ++i )
+                for ( int j = tile_min[1]; j < tile_max[1]; ++j )
+                    for ( int k = tile_min[2]; k < tile_max[2]; ++k )
+                        if ( 0 == ( i + j + k ) % 3 )
+                            sparse_map.insertTile( i, j, k );
+            if ( tile_min[0] > 0 )
+                sparse_map.insertTile( tile_min[0] - 1, tile_min[1],
+                                       tile_min[2] );
+        } );
+    array->resize();
+
+    // Fill the active cells with their global index.
+    auto& map = layout->sparseMap();
+    auto data = array->aosoa();
+    Kokkos::parallel_for(
+        "fill", Kokkos::RangePolicy<TEST_EXECSPACE>( 0, map.capacity() ),
+        KOKKOS_LAMBDA( const int index ) {
+            if ( map.valid_at( index ) )
+            {
+                auto tile_id = map.value_at( index );
+                auto tile_key = map.key_at( index );
+                int ti, tj, tk;
+                map.key2ijk( tile_key, ti, tj, tk );
+                for ( int ci = 0; ci < cell_per_tile_dim; ++ci )
+                    for ( int cj = 0; cj < cell_per_tile_dim; ++cj )
+                        for ( int ck = 0; ck < cell_per_tile_dim; ++ck )
+                        {
+                            int c = map.cell_local_id( ci, cj, ck );
+                            int cell[3] = { ti * cell_per_tile_dim + ci,
+                                            tj * cell_per_tile_dim + cj,
+                                            tk * cell_per_tile_dim + ck };
+                            auto& soa = data.access( tile_id );
+                            Cabana::get<0>( soa, c ) =
+                                cell[0] + 0.5 * cell[1] + 0.25 * cell[2];
+                            for ( int d = 0; d < 3; ++d )
+                                Cabana::get<1>( soa, c, d ) = cell[d];
+                        }
+            }
+        } );
+
+    // Write the active owned tiles and read them into a new array.
+    SparseArrayIO::writeTimeStep( "sparse_io", 7, *array );
+
+    auto read_map =
+        createSparseMap<TEST_EXECSPACE>( global_mesh, pre_alloc_size );
+    auto read_layout =
+        createSparseArrayLayout<DataTypes>( local_grid, read_map, Cell() );
+    auto read_array = createSparseArray<TEST_DEVICE>( "sparse", *read_layout );
+    SparseArrayIO::readTimeStep( "sparse_io", 7, *read_array );
+
+    // Only the owned active tiles are restored.
+    int num_owned = 0;
+    for ( int i = tile_min[0]; i < tile_max[0]; ++i )
+        for ( int j = tile_min[1]; j < tile_max[1]; ++j )
+            for ( int k = tile_min[2]; k < tile_max[2]; ++k )
+                if ( 0 == ( i + j + k ) % 3 )
+                    ++num_owned;
+    EXPECT_EQ( static_cast<int>( read_map.sizeTile() ), num_owned );
+    EXPECT_EQ( read_array->size(), read_map.sizeCell() );
+
+    // Check the restored data.
+    auto& restored_map = read_layout->sparseMap();
+    auto read_data = read_array->aosoa();
+    int num_error = 0;
+    Kokkos::parallel_reduce(
+        "check", Kokkos::RangePolicy<TEST_EXECSPACE>( 0, map.capacity() ),
+        KOKKOS_LAMBDA( const int index, int& error ) {
+            if ( map.valid_at( index ) )
+            {
+                auto tile_key = map.key_at( index );
+                int ti, tj, tk;
+                map.key2ijk( tile_key, ti, tj, tk );
+                if ( ti < tile_min[0] )
+                    return;
+                auto& expected = data.access( map.value_at( index ) );
+                auto& restored = read_data.access(
+                    restored_map.queryTileFromTileKey( tile_key ) );
+                for ( int c = 0; c < cell_per_tile_dim * cell_per_tile_dim *
+                                         cell_per_tile_dim;
+                      ++c )
+                {
+                    if ( Cabana::get<0>( expected, c ) !=
+                         Cabana::get<0>( restored, c ) )
+                        ++error;
+                    for ( int d = 0; d < 3; ++d )
+                        if ( Cabana::get<1>( expected, c, d ) !=
+                             Cabana::get<1>( restored, c, d ) )
+                            ++error;
+                }
+            }
+        },
+        num_error );
+    EXPECT_EQ( num_error, 0 );
+
+    // Arrays with different member types cannot be read.
+    using OtherTypes = Cabana::MemberTypes<float, int[3]>;
+    auto other_map =
+        createSparseMap<TEST_EXECSPACE>( global_mesh, pre_alloc_size );
+    auto other_layout =
+        createSparseArrayLayout<OtherTypes>( local_grid, other_map, Cell() );
+    auto other_array =
+        createSparseArray<TEST_DEVICE>( "sparse", *other_layout );
+    EXPECT_THROW( SparseArrayIO::readTimeStep( "sparse_io", 7, *other_array ),
+                  std::runtime_error );
+}
+
+//---------------------------------------------------------------------------//
+// RUN TESTS
+//---------------------------------------------------------------------------//
+TEST( TEST_CATEGORY, sparse_array_io_test ) { sparseArrayIOTest(); }
+
+//---------------------------------------------------------------------------//
+
+} // end namespace Test
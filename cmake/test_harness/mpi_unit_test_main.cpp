@@ -17,7 +17,9 @@
 
 int main( int argc, char* argv[] )
 {
-    MPI_Init( &argc, &argv );
+    // Request full thread support so tests can exercise background I/O.
+    int provided;
+    MPI_Init_thread( &argc, &argv, MPI_THREAD_MULTIPLE, &provided );
     Kokkos::initialize( argc, argv );
     ::testing::InitGoogleTest( &argc, argv );
     int return_val = RUN_ALL_TESTS();
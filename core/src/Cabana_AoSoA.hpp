@@ -17,10 +17,12 @@
 #define CABANA_AOSOA_HPP
 
 #include <Cabana_MemberTypes.hpp>
+#include <Cabana_MemoryPool.hpp>
 #include <Cabana_Slice.hpp>
 #include <Cabana_SoA.hpp>
 #include <Cabana_Tuple.hpp>
 #include <Cabana_Types.hpp>
+#include <impl/Cabana_FirstTouch.hpp>
 #include <impl/Cabana_Index.hpp>
 #include <impl/Cabana_PerformanceTraits.hpp>
 
@@ -28,6 +30,7 @@
 
 #include <cmath>
 #include <cstdlib>
+#include <stdexcept>
 #include <string>
 #include <type_traits>
 
@@ -324,8 +327,14 @@ class AoSoA
         static_assert( !memory_traits::is_unmanaged,
                        "Cannot resize unmanaged memory" );
 
-        // Reserve memory if needed.
-        reserve( n );
+        // Reserve memory if needed, growing geometrically by the growth
+        // factor to amortize repeated small increases.
+        if ( n > _capacity )
+        {
+            size_type grown =
+                static_cast<size_type>( _growth_factor * _capacity );
+            reserve( ( grown > n ) ? grown : n );
+        }
 
         // Update the sizes of the data. This is potentially different than
         // the amount of allocated data.
@@ -370,22 +379,9 @@ class AoSoA
         if ( num_soa_alloc <= _num_soa )
             return;
 
-        // Assign the new capacity.
-        _capacity = num_soa_alloc * vector_length;
-
-        // We need more SoA objects so allocate a new view and copy the
+        // We need more SoA objects so allocate new storage and copy the
         // existing data.
-        soa_view resized_data(
-            Kokkos::ViewAllocateWithoutInitializing( _data.label() ),
-            num_soa_alloc );
-        if ( _num_soa > 0 )
-            Kokkos::deep_copy(
-                Kokkos::subview(
-                    resized_data,
-                    Kokkos::pair<size_type, size_type>( 0, _num_soa ) ),
-                Kokkos::subview( _data, Kokkos::pair<size_type, size_type>(
-                                            0, _num_soa ) ) );
-        _data = resized_data;
+        reallocate( num_soa_alloc );
     }
 
     /*!
@@ -395,6 +391,10 @@ class AoSoA
       hold size() tuples. If reallocation occurs, all slices and all
       references to the elements are invalidated. If no reallocation takes
       place, no slices or references are invalidated.
+
+      No reallocation occurs unless the allocated number of SoAs exceeds the
+      number needed by more than the shrink hysteresis factor (see
+      setShrinkHysteresis()).
     */
     void shrinkToFit()
     {
@@ -408,22 +408,113 @@ class AoSoA
         if ( _data.size() == _num_soa )
             return;
 
-        // Assign the new capacity.
-        _capacity = _num_soa * vector_length;
+        // Keep the excess storage if it is within the hysteresis.
+        if ( _data.size() <= _shrink_hysteresis * _num_soa )
+            return;
 
-        // We need fewer SoA objects so allocate a new view and copy the
+        // We need fewer SoA objects so allocate new storage and copy the
         // existing data.
-        soa_view resized_data(
-            Kokkos::ViewAllocateWithoutInitializing( _data.label() ),
-            _num_soa );
-        if ( _num_soa > 0 )
-            Kokkos::deep_copy(
-                resized_data,
-                Kokkos::subview( _data, Kokkos::pair<size_type, size_type>(
-                                            0, _num_soa ) ) );
-        _data = resized_data;
+        reallocate( _num_soa );
+    }
+
+    /*!
+      \brief Set the factor by which resize() grows the capacity when it is
+      exceeded.
+
+      \param factor The growth factor. The new capacity is the larger of the
+      requested size and the current capacity times this factor. The default
+      of 1 grows the capacity to exactly the requested size.
+
+      Explicit calls to reserve() are not affected.
+    */
+    void setGrowthFactor( const double factor )
+    {
+        if ( factor < 1.0 )
+            throw std::runtime_error(
+                "AoSoA growth factor must be at least 1" );
+        _growth_factor = factor;
+    }
+
+    //! Get the capacity growth factor.
+    double growthFactor() const { return _growth_factor; }
+
+    /*!
+      \brief Set the hysteresis for shrinkToFit().
+
+      \param factor Storage is only released when the allocated number of
+      SoAs is more than this factor times the number needed. The default of 1
+      always releases excess storage.
+    */
+    void setShrinkHysteresis( const double factor )
+    {
+        if ( factor < 1.0 )
+            throw std::runtime_error(
+                "AoSoA shrink hysteresis must be at least 1" );
+        _shrink_hysteresis = factor;
+    }
+
+    //! Get the shrinkToFit() hysteresis factor.
+    double shrinkHysteresis() const { return _shrink_hysteresis; }
+
+    /*!
+      \brief Allocate future storage from a memory pool.
+
+      \param pool The pool to allocate from or nullptr to allocate directly.
+      The pool must outlive this container and all of its copies.
+
+      Current storage is moved to the pool at the next reallocation.
+    */
+    void setMemoryPool( MemoryPool<memory_space>* pool )
+    {
+        static_assert( !memory_traits::is_unmanaged,
+                       "Unmanaged memory cannot be pooled" );
+        _pool = pool;
     }
 
+    /*!
+      \brief Touch newly allocated storage in parallel before copying into it.
+
+      \param first_touch If true, each reallocation of host storage touches
+      its pages with a static RangePolicy in the execution space before the
+      existing data is copied. Under a first touch page placement policy the
+      SoAs are then placed on the NUMA domain of the thread that a static
+      RangePolicy over the tuples assigns them to, instead of wherever the
+      copy happens to run. Storage allocated from a memory pool is placed by
+      the pool (see MemoryPool::setFirstTouch()).
+
+      Takes effect at the next reallocation.
+    */
+    void setFirstTouch( const bool first_touch )
+    {
+        static_assert( !memory_traits::is_unmanaged,
+                       "Cannot place unmanaged memory" );
+        _first_touch = first_touch;
+    }
+
+    //! Check if new storage is touched in parallel.
+    bool firstTouch() const { return _first_touch; }
+
+    /*!
+      \brief Request transparent huge pages for newly allocated storage.
+
+      \param huge_pages If true, each reallocation of host storage is advised
+      to be backed by huge pages, reducing TLB misses when streaming large
+      containers. Only has an effect on Linux with transparent huge pages
+      enabled in madvise mode. Storage allocated from a memory pool is
+      advised by the pool (see MemoryPool::setHugePages()).
+
+      Takes effect at the next reallocation.
+    */
+    void setHugePages( const bool huge_pages )
+    {
+        static_assert( !memory_traits::is_unmanaged,
+                       "Cannot advise unmanaged memory" );
+        _huge_pages = huge_pages;
+    }
+
+    //! Check if huge pages are requested for new storage.
+    bool hugePages() const { return _huge_pages; }
+
     /*!
       \brief Get the number of structs-of-arrays in the container.
 
@@ -498,6 +589,47 @@ class AoSoA
     soa_type* data() const { return _data.data(); }
 
   private:
+    // Allocate storage for the given number of SoAs, copying as much of the
+    // existing data as fits.
+    void reallocate( const size_type num_soa_alloc )
+    {
+        block_type block;
+        soa_view resized_data;
+        if ( nullptr != _pool )
+        {
+            block = _pool->acquire( num_soa_alloc * sizeof( soa_type ) );
+            resized_data = soa_view(
+                reinterpret_cast<soa_type*>( block.data() ), num_soa_alloc );
+        }
+        else
+        {
+            resized_data = soa_view(
+                Kokkos::ViewAllocateWithoutInitializing( _data.label() ),
+                num_soa_alloc );
+            std::size_t bytes = num_soa_alloc * sizeof( soa_type );
+            if ( _huge_pages )
+                Impl::adviseHugePages( memory_space(), resized_data.data(),
+                                       bytes );
+            if ( _first_touch )
+                Impl::firstTouch( execution_space(), memory_space(),
+                                  resized_data.data(), bytes );
+        }
+
+        size_type num_copy =
+            ( _num_soa < num_soa_alloc ) ? _num_soa : num_soa_alloc;
+        if ( num_copy > 0 )
+            Kokkos::deep_copy(
+                Kokkos::subview(
+                    resized_data,
+                    Kokkos::pair<size_type, size_type>( 0, num_copy ) ),
+                Kokkos::subview( _data, Kokkos::pair<size_type, size_type>(
+                                            0, num_copy ) ) );
+
+        _data = resized_data;
+        _block = block;
+        _capacity = num_soa_alloc * vector_length;
+    }
+
     // Total number of tuples in the container.
     size_type _size;
 
@@ -512,6 +644,27 @@ class AoSoA
     // assignment operator for this class perform a shallow and reference
     // counted copy of the data.
     soa_view _data;
+
+    // Pool block backing the data if allocated from a memory pool. The
+    // block reference keeps it in use for as long as any copy of this
+    // container refers to it.
+    using block_type = typename MemoryPool<memory_space>::block_type;
+    block_type _block;
+
+    // Memory pool to allocate from, if any.
+    MemoryPool<memory_space>* _pool = nullptr;
+
+    // Capacity growth factor for resize.
+    double _growth_factor = 1.0;
+
+    // Excess storage factor tolerated by shrinkToFit.
+    double _shrink_hysteresis = 1.0;
+
+    // Touch new storage in parallel before copying into it.
+    bool _first_touch = false;
+
+    // Request huge pages for new storage.
+    bool _huge_pages = false;
 };
 
 //---------------------------------------------------------------------------//
@@ -0,0 +1,463 @@
+/****************************************************************************
+ * Copyright (c) 2018-2022 by the Cabana authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the Cabana library. Cabana is distributed under a   *
+ * BSD 3-clause license. For the licensing terms see the LICENSE file in    *
+ * the top-level directory.                                                 *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+/*!
+  \file Cabana_BinaryParticleIO.hpp
+  \brief Raw binary particle files with memory mapped reads
+*/
+#ifndef CABANA_BINARYPARTICLEIO_HPP
+#define CABANA_BINARYPARTICLEIO_HPP
+
+#include <Cabana_AoSoA.hpp>
+#include <Cabana_DeepCopy.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined( __unix__ ) || defined( __APPLE__ )
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define CABANA_BINARYPARTICLEIO_MMAP
+#endif
+
+namespace Cabana
+{
+//---------------------------------------------------------------------------//
+//! \cond Impl
+namespace Impl
+{
+// Type of a member value in a layout description.
+template <class T>
+char valueKind()
+{
+    if ( std::is_floating_point<T>::value )
+        return 'f';
+    else if ( std::is_signed<T>::value )
+        return 'i';
+    else if ( std::is_unsigned<T>::value )
+        return 'u';
+    return 'b';
+}
+
+// Describe the value type and extent of one AoSoA member.
+template <class AoSoAType, std::size_t M>
+std::string memberLayout()
+{
+    using value_type = typename AoSoAType::template member_value_type<M>;
+    using data_type = typename AoSoAType::template member_data_type<M>;
+    std::stringstream layout;
+    layout << " " << valueKind<value_type>() << sizeof( value_type ) << "x"
+           << sizeof( data_type ) / sizeof( value_type );
+    return layout.str();
+}
+
+// Describe the raw memory layout of an AoSoA. Data written with one layout
+// can only be read into the same layout.
+template <class AoSoAType, std::size_t... Ms>
+std::string aosoaLayout( std::index_sequence<Ms...> )
+{
+    std::stringstream layout;
+    layout << "AoSoA vector_length " << AoSoAType::vector_length << " soa "
+           << sizeof( typename AoSoAType::soa_type ) << " members";
+    ( ( layout << memberLayout<AoSoAType, Ms>() ), ... );
+    return layout.str();
+}
+
+template <class AoSoAType>
+std::string aosoaLayout()
+{
+    return aosoaLayout<AoSoAType>(
+        std::make_index_sequence<AoSoAType::number_of_members>() );
+}
+
+} // end namespace Impl
+//! \endcond
+
+namespace Experimental
+{
+namespace BinaryParticleIO
+{
+//---------------------------------------------------------------------------//
+/*!
+  \brief Description of one AoSoA member in a binary particle file.
+*/
+struct MemberInfo
+{
+    //! Value kind: 'f' floating point, 'i' signed, 'u' unsigned, 'b' other.
+    char kind;
+    //! Bytes per value.
+    std::size_t value_bytes;
+    //! Values per particle.
+    std::size_t num_values;
+    //! Byte offset of the member from the start of each SoA.
+    std::size_t soa_offset;
+};
+
+//---------------------------------------------------------------------------//
+/*!
+  \brief Header of a binary particle file.
+
+  The file starts with the 8 byte magic string "CABPART1" followed by the
+  header fields below as unsigned 64-bit integers in native byte order, each
+  member as kind, value bytes, values per particle and SoA offset, and the
+  layout and label as a 64-bit length and characters. The SoA blocks follow
+  verbatim at the page aligned data offset. Within each SoA, member m holds
+  the values of vector_length particles, with the values of each particle
+  strided by vector_length.
+*/
+struct FileHeader
+{
+    //! Byte offset of the SoA data from the start of the file.
+    std::size_t data_offset;
+    //! Number of particles.
+    std::size_t size;
+    //! Number of SoA blocks.
+    std::size_t num_soa;
+    //! Particles per SoA.
+    std::size_t vector_length;
+    //! Bytes per SoA.
+    std::size_t soa_bytes;
+    //! Members.
+    std::vector<MemberInfo> members;
+    //! AoSoA layout description.
+    std::string layout;
+    //! AoSoA label.
+    std::string label;
+};
+
+//---------------------------------------------------------------------------//
+//! \cond Impl
+namespace Impl
+{
+// File identifier.
+constexpr char magic[8] = { 'C', 'A', 'B', 'P', 'A', 'R', 'T', '1' };
+
+// Alignment of the SoA data in the file so that it is page aligned when
+// mapped.
+constexpr std::size_t data_alignment = 65536;
+
+// Serialize header values.
+inline void pack( std::vector<char>& buffer, const std::uint64_t value )
+{
+    const char* data = reinterpret_cast<const char*>( &value );
+    buffer.insert( buffer.end(), data, data + sizeof( value ) );
+}
+
+inline void pack( std::vector<char>& buffer, const std::string& value )
+{
+    pack( buffer, value.size() );
+    buffer.insert( buffer.end(), value.begin(), value.end() );
+}
+
+inline std::uint64_t unpackValue( const char* buffer, const std::size_t bytes,
+                                  std::size_t& pos )
+{
+    if ( pos + sizeof( std::uint64_t ) > bytes )
+        throw std::runtime_error( "Corrupt binary particle file header" );
+    std::uint64_t value;
+    std::memcpy( &value, buffer + pos, sizeof( value ) );
+    pos += sizeof( value );
+    return value;
+}
+
+inline std::string unpackString( const char* buffer, const std::size_t bytes,
+                                 std::size_t& pos )
+{
+    auto length = unpackValue( buffer, bytes, pos );
+    if ( pos + length > bytes )
+        throw std::runtime_error( "Corrupt binary particle file header" );
+    std::string value( buffer + pos, length );
+    pos += length;
+    return value;
+}
+
+// Describe the members of an AoSoA.
+template <class AoSoAType, std::size_t... Ms>
+std::vector<MemberInfo> memberInfo( std::index_sequence<Ms...> )
+{
+    using soa_type = typename AoSoAType::soa_type;
+    soa_type soa;
+    const char* base = reinterpret_cast<const char*>( &soa );
+    auto offset = [=]( const void* member )
+    {
+        return static_cast<std::size_t>( static_cast<const char*>( member ) -
+                                         base );
+    };
+    return { MemberInfo{
+        Cabana::Impl::valueKind<
+            typename AoSoAType::template member_value_type<Ms>>(),
+        sizeof( typename AoSoAType::template member_value_type<Ms> ),
+        sizeof( typename AoSoAType::template member_data_type<Ms> ) /
+            sizeof( typename AoSoAType::template member_value_type<Ms> ),
+        offset( Cabana::Impl::soaMemberPtr<Ms>( &soa ) ) }... };
+}
+
+// Parse a file header.
+inline FileHeader parseHeader( const char* buffer, const std::size_t bytes )
+{
+    if ( bytes < sizeof( magic ) ||
+         0 != std::memcmp( buffer, magic, sizeof( magic ) ) )
+        throw std::runtime_error( "Not a Cabana binary particle file" );
+    std::size_t pos = sizeof( magic );
+    FileHeader header;
+    header.data_offset = unpackValue( buffer, bytes, pos );
+    header.size = unpackValue( buffer, bytes, pos );
+    header.num_soa = unpackValue( buffer, bytes, pos );
+    header.vector_length = unpackValue( buffer, bytes, pos );
+    header.soa_bytes = unpackValue( buffer, bytes, pos );
+    header.members.resize( unpackValue( buffer, bytes, pos ) );
+    for ( auto& member : header.members )
+    {
+        member.kind = static_cast<char>( unpackValue( buffer, bytes, pos ) );
+        member.value_bytes = unpackValue( buffer, bytes, pos );
+        member.num_values = unpackValue( buffer, bytes, pos );
+        member.soa_offset = unpackValue( buffer, bytes, pos );
+    }
+    header.layout = unpackString( buffer, bytes, pos );
+    header.label = unpackString( buffer, bytes, pos );
+    if ( header.data_offset < pos )
+        throw std::runtime_error( "Corrupt binary particle file header" );
+    return header;
+}
+
+} // end namespace Impl
+//! \endcond
+
+//---------------------------------------------------------------------------//
+/*!
+  \brief Write an AoSoA to a binary particle file.
+
+  The SoA blocks are written verbatim after a header describing the member
+  types and vector length so that the file can be mapped directly into an
+  AoSoA of the same type (see MappedAoSoA) or read by other tools from the
+  header description. Device data is first copied to the host.
+
+  \param filename The file name.
+  \param aosoa The particles.
+*/
+template <class AoSoAType>
+void writeAoSoA( const std::string& filename, const AoSoAType& aosoa )
+{
+    static_assert( is_aosoa<AoSoAType>::value, "Only AoSoAs supported" );
+
+    Kokkos::Profiling::pushRegion( "Cabana::BinaryParticleIO::writeAoSoA" );
+
+    using soa_type = typename AoSoAType::soa_type;
+    auto members = Impl::memberInfo<AoSoAType>(
+        std::make_index_sequence<AoSoAType::number_of_members>() );
+
+    std::vector<char> header( std::begin( Impl::magic ),
+                              std::end( Impl::magic ) );
+    std::size_t offset_pos = header.size();
+    Impl::pack( header, std::uint64_t( 0 ) );
+    Impl::pack( header, aosoa.size() );
+    Impl::pack( header, aosoa.numSoA() );
+    Impl::pack( header, AoSoAType::vector_length );
+    Impl::pack( header, sizeof( soa_type ) );
+    Impl::pack( header, members.size() );
+    for ( auto& member : members )
+    {
+        Impl::pack( header, static_cast<std::uint64_t>( member.kind ) );
+        Impl::pack( header, member.value_bytes );
+        Impl::pack( header, member.num_values );
+        Impl::pack( header, member.soa_offset );
+    }
+    Impl::pack( header, Cabana::Impl::aosoaLayout<AoSoAType>() );
+    Impl::pack( header, aosoa.label() );
+
+    // Pad the header so the data is page aligned.
+    std::uint64_t data_offset =
+        ( header.size() + Impl::data_alignment - 1 ) / Impl::data_alignment *
+        Impl::data_alignment;
+    std::memcpy( header.data() + offset_pos, &data_offset,
+                 sizeof( data_offset ) );
+    header.resize( data_offset, 0 );
+
+    auto host_aosoa =
+        Cabana::create_mirror_view_and_copy( Kokkos::HostSpace(), aosoa );
+
+    std::ofstream file( filename, std::ios::binary | std::ios::trunc );
+    file.write( header.data(), header.size() );
+    file.write( reinterpret_cast<const char*>( host_aosoa.data() ),
+                aosoa.numSoA() * sizeof( soa_type ) );
+    file.close();
+    if ( !file )
+        throw std::runtime_error( "Failed to write binary particle file " +
+                                  filename );
+
+    Kokkos::Profiling::popRegion();
+}
+
+//---------------------------------------------------------------------------//
+/*!
+  \brief Read the header of a binary particle file.
+  \param filename The file name.
+*/
+inline FileHeader readHeader( const std::string& filename )
+{
+    std::ifstream file( filename, std::ios::binary );
+    std::vector<char> buffer( sizeof( Impl::magic ) + sizeof( std::uint64_t ) );
+    file.read( buffer.data(), buffer.size() );
+    if ( !file )
+        throw std::runtime_error( "Failed to read binary particle file " +
+                                  filename );
+    if ( 0 != std::memcmp( buffer.data(), Impl::magic, sizeof( Impl::magic ) ) )
+        throw std::runtime_error( "Not a Cabana binary particle file" );
+    std::size_t pos = sizeof( Impl::magic );
+    auto data_offset = Impl::unpackValue( buffer.data(), buffer.size(), pos );
+
+    buffer.resize( data_offset );
+    file.seekg( 0 );
+    file.read( buffer.data(), buffer.size() );
+    if ( !file )
+        throw std::runtime_error( "Failed to read binary particle file " +
+                                  filename );
+    return Impl::parseHeader( buffer.data(), buffer.size() );
+}
+
+//---------------------------------------------------------------------------//
+/*!
+  \brief A binary particle file mapped into memory as an unmanaged host
+  AoSoA.
+
+  \tparam DataTypes The member types the file was written with.
+  \tparam VectorLength The vector length the file was written with.
+
+  No data is read when the file is opened. Pages are read by the operating
+  system on first access, so only the parts of a large file that are used
+  are loaded. The mapping is private: particle data may be modified in
+  memory but changes are not written back to the file. The AoSoA is valid
+  for the lifetime of this object.
+*/
+template <class DataTypes,
+          int VectorLength =
+              AoSoA<DataTypes, Kokkos::HostSpace>::vector_length>
+class MappedAoSoA
+{
+  public:
+    //! Unmanaged AoSoA type of the mapped data.
+    using aosoa_type = AoSoA<DataTypes, Kokkos::HostSpace, VectorLength,
+                             Kokkos::MemoryUnmanaged>;
+
+    /*!
+      \brief Map a binary particle file.
+      \param filename The file name.
+    */
+    MappedAoSoA( const std::string& filename )
+    {
+#ifdef CABANA_BINARYPARTICLEIO_MMAP
+        _fd = open( filename.c_str(), O_RDONLY );
+        if ( _fd < 0 )
+            throw std::runtime_error( "Failed to open binary particle file " +
+                                      filename );
+        struct stat file_stat;
+        if ( 0 != fstat( _fd, &file_stat ) )
+        {
+            close( _fd );
+            throw std::runtime_error( "Failed to open binary particle file " +
+                                      filename );
+        }
+        _bytes = file_stat.st_size;
+        _data = mmap( nullptr, _bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE,
+                      _fd, 0 );
+        if ( MAP_FAILED == _data )
+        {
+            close( _fd );
+            throw std::runtime_error( "Failed to map binary particle file " +
+                                      filename );
+        }
+
+        try
+        {
+            _header = Impl::parseHeader( static_cast<char*>( _data ), _bytes );
+            if ( _header.layout != Cabana::Impl::aosoaLayout<aosoa_type>() )
+                throw std::runtime_error(
+                    "Binary particle file " + filename + " has layout " +
+                    _header.layout + ", expected " +
+                    Cabana::Impl::aosoaLayout<aosoa_type>() );
+            if ( _header.data_offset + _header.num_soa * sizeof( soa_type ) >
+                 _bytes )
+                throw std::runtime_error( "Binary particle file " + filename +
+                                          " is truncated" );
+        }
+        catch ( ... )
+        {
+            unmap();
+            throw;
+        }
+
+        _soa = reinterpret_cast<soa_type*>( static_cast<char*>( _data ) +
+                                            _header.data_offset );
+#else
+        throw std::runtime_error(
+            "Memory mapped particle files are not supported: " + filename );
+#endif
+    }
+
+    //! Unmap the file.
+    ~MappedAoSoA() { unmap(); }
+
+    MappedAoSoA( const MappedAoSoA& ) = delete;
+    MappedAoSoA& operator=( const MappedAoSoA& ) = delete;
+
+    //! Get the mapped particles.
+    aosoa_type aosoa() const
+    {
+        return aosoa_type( _soa, _header.num_soa, _header.size );
+    }
+
+    //! Get the number of particles.
+    std::size_t size() const { return _header.size; }
+
+    //! Get the file header.
+    const FileHeader& header() const { return _header; }
+
+  private:
+    using soa_type = typename aosoa_type::soa_type;
+
+    void unmap()
+    {
+#ifdef CABANA_BINARYPARTICLEIO_MMAP
+        if ( nullptr != _data && MAP_FAILED != _data )
+            munmap( _data, _bytes );
+        if ( _fd >= 0 )
+            close( _fd );
+#endif
+        _data = nullptr;
+        _fd = -1;
+    }
+
+    int _fd = -1;
+    void* _data = nullptr;
+    std::size_t _bytes = 0;
+    FileHeader _header;
+    soa_type* _soa = nullptr;
+};
+
+//---------------------------------------------------------------------------//
+
+} // end namespace BinaryParticleIO
+} // end namespace Experimental
+} // end namespace Cabana
+
+#endif // end CABANA_BINARYPARTICLEIO_HPP
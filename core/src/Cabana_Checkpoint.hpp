@@ -0,0 +1,660 @@
+/****************************************************************************
+ * Copyright (c) 2018-2022 by the Cabana authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the Cabana library. Cabana is distributed under a   *
+ * BSD 3-clause license. For the licensing terms see the LICENSE file in    *
+ * the top-level directory.                                                 *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+/*!
+  \file Cabana_Checkpoint.hpp
+  \brief Binary checkpoint and restart of particle data
+*/
+#ifndef CABANA_CHECKPOINT_HPP
+#define CABANA_CHECKPOINT_HPP
+
+#include <Cabana_AoSoA.hpp>
+#include <Cabana_BinaryParticleIO.hpp>
+#include <Cabana_ParticleList.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <mpi.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace Cabana
+{
+namespace Experimental
+{
+namespace Checkpoint
+{
+//---------------------------------------------------------------------------//
+/*!
+  \brief Checkpoint file configuration.
+
+  Ranks are aggregated into num_files groups of consecutive ranks. Each group
+  writes one shared file with MPI-IO. A checkpoint must be read with the same
+  communicator size and number of files it was written with.
+*/
+struct CheckpointConfig
+{
+    //! Number of files per checkpoint. Clamped to the communicator size.
+    int num_files = 1;
+
+    //! Use collective MPI-IO. Independent IO is used otherwise.
+    bool collective = true;
+};
+
+//---------------------------------------------------------------------------//
+//! \cond Impl
+namespace Impl
+{
+// File signature.
+constexpr char checkpoint_magic[8] = { 'C', 'A', 'B', 'C', 'K', 'P', 'T', '1' };
+
+// Largest number of bytes moved by one MPI-IO call.
+constexpr std::size_t checkpoint_io_chunk = std::size_t( 1 ) << 30;
+
+// Section data staged on the host.
+struct Section
+{
+    std::string name;
+    std::string layout;
+    std::uint64_t count;
+    Kokkos::View<char*, Kokkos::HostSpace> bytes;
+};
+
+// Get the file of this rank.
+inline int fileIndex( MPI_Comm comm, const CheckpointConfig& config )
+{
+    int comm_rank;
+    MPI_Comm_rank( comm, &comm_rank );
+    int comm_size;
+    MPI_Comm_size( comm, &comm_size );
+    long num_files = std::max( 1, std::min( config.num_files, comm_size ) );
+    return static_cast<int>( num_files * comm_rank / comm_size );
+}
+
+// Compose the name of a checkpoint file.
+inline std::string fileName( const std::string& prefix,
+                             const int time_step_index, const int file )
+{
+    std::stringstream filename;
+    filename << prefix << "_" << time_step_index << "_" << file << ".ckpt";
+    return filename.str();
+}
+
+// Memory layout descriptions shared with the binary particle files.
+using Cabana::Impl::aosoaLayout;
+using Cabana::Impl::valueKind;
+
+// Describe the layout of a particle list.
+template <class MemorySpace, class... FieldTags>
+std::string particleListLayout( const ParticleList<MemorySpace, FieldTags...>& )
+{
+    using aosoa_type =
+        typename ParticleList<MemorySpace, FieldTags...>::aosoa_type;
+    std::stringstream layout;
+    layout << aosoaLayout<aosoa_type>() << " fields";
+    ( ( layout << " " << FieldTags::label() ), ... );
+    return layout.str();
+}
+
+// Serialize header values.
+inline void pack( std::vector<char>& buffer, const std::uint64_t value )
+{
+    const char* data = reinterpret_cast<const char*>( &value );
+    buffer.insert( buffer.end(), data, data + sizeof( value ) );
+}
+
+inline void pack( std::vector<char>& buffer, const std::string& value )
+{
+    pack( buffer, value.size() );
+    buffer.insert( buffer.end(), value.begin(), value.end() );
+}
+
+inline std::uint64_t unpackValue( const std::vector<char>& buffer,
+                                  std::size_t& pos )
+{
+    if ( pos + sizeof( std::uint64_t ) > buffer.size() )
+        throw std::runtime_error( "Corrupt checkpoint header" );
+    std::uint64_t value;
+    std::memcpy( &value, buffer.data() + pos, sizeof( value ) );
+    pos += sizeof( value );
+    return value;
+}
+
+inline std::string unpackString( const std::vector<char>& buffer,
+                                 std::size_t& pos )
+{
+    std::size_t size = unpackValue( buffer, pos );
+    if ( pos + size > buffer.size() )
+        throw std::runtime_error( "Corrupt checkpoint header" );
+    std::string value( buffer.data() + pos, size );
+    pos += size;
+    return value;
+}
+
+// Number of IO calls needed for a block.
+inline std::size_t numChunk( const std::size_t bytes )
+{
+    return ( bytes + checkpoint_io_chunk - 1 ) / checkpoint_io_chunk;
+}
+
+// Write a block in chunks. With collective IO all ranks of the file must
+// make the same number of calls.
+inline void writeAt( MPI_File file, const MPI_Offset offset, const char* data,
+                     const std::size_t bytes, const std::size_t num_chunk,
+                     const bool collective )
+{
+    for ( std::size_t c = 0; c < num_chunk; ++c )
+    {
+        std::size_t begin = std::min( c * checkpoint_io_chunk, bytes );
+        int size = std::min( checkpoint_io_chunk, bytes - begin );
+        if ( collective )
+            MPI_File_write_at_all( file, offset + begin, data + begin, size,
+                                   MPI_BYTE, MPI_STATUS_IGNORE );
+        else if ( size > 0 )
+            MPI_File_write_at( file, offset + begin, data + begin, size,
+                               MPI_BYTE, MPI_STATUS_IGNORE );
+    }
+}
+
+// Read a block in chunks. With collective IO all ranks of the file must
+// make the same number of calls.
+inline void readAt( MPI_File file, const MPI_Offset offset, char* data,
+                    const std::size_t bytes, const std::size_t num_chunk,
+                    const bool collective )
+{
+    for ( std::size_t c = 0; c < num_chunk; ++c )
+    {
+        std::size_t begin = std::min( c * checkpoint_io_chunk, bytes );
+        int size = std::min( checkpoint_io_chunk, bytes - begin );
+        if ( collective )
+            MPI_File_read_at_all( file, offset + begin, data + begin, size,
+                                  MPI_BYTE, MPI_STATUS_IGNORE );
+        else if ( size > 0 )
+            MPI_File_read_at( file, offset + begin, data + begin, size,
+                              MPI_BYTE, MPI_STATUS_IGNORE );
+    }
+}
+
+} // namespace Impl
+//! \endcond
+
+//---------------------------------------------------------------------------//
+/*!
+  \brief Checkpoint writer.
+
+  Sections are added from the containers to checkpoint and then written in
+  one operation by write(). Each section stores the raw memory of a
+  container, e.g. the SoA blocks of an AoSoA, so that restoring into an
+  identical layout is a plain copy with no per-element conversion.
+
+  Host data is not copied when added and must not change before write().
+  Device data is staged on the host when added. All ranks of the
+  communicator must add the same sections in the same order.
+*/
+class Writer
+{
+  public:
+    /*!
+      \brief Constructor.
+      \param comm MPI communicator.
+      \param config Checkpoint file configuration.
+    */
+    Writer( MPI_Comm comm, const CheckpointConfig& config = {} )
+        : _comm( comm )
+        , _config( config )
+    {
+    }
+
+    /*!
+      \brief Add the raw bytes of a container.
+      \param name Section name.
+      \param layout Description of the data layout. Checked on restart.
+      Must be the same on all ranks.
+      \param count Number of elements on this rank.
+      \param bytes Data of this rank.
+    */
+    void addSection( const std::string& name, const std::string& layout,
+                     const std::size_t count,
+                     const Kokkos::View<char*, Kokkos::HostSpace>& bytes )
+    {
+        _sections.push_back( { name, layout, count, bytes } );
+    }
+
+    /*!
+      \brief Add all members of an AoSoA.
+      \param name Section name.
+      \param aosoa The AoSoA.
+    */
+    template <class AoSoAType>
+    void add( const std::string& name, const AoSoAType& aosoa,
+              typename std::enable_if<is_aosoa<AoSoAType>::value,
+                                      int>::type* = 0 )
+    {
+        using memory_space = typename AoSoAType::memory_space;
+        std::size_t bytes =
+            aosoa.numSoA() * sizeof( typename AoSoAType::soa_type );
+        Kokkos::View<char*, memory_space, Kokkos::MemoryUnmanaged> raw(
+            reinterpret_cast<char*>( aosoa.data() ), bytes );
+        auto host_raw =
+            Kokkos::create_mirror_view_and_copy( Kokkos::HostSpace(), raw );
+        addSection( name, Impl::aosoaLayout<AoSoAType>(), aosoa.size(),
+                    host_raw );
+    }
+
+    /*!
+      \brief Add all fields of a particle list. The section is named by the
+      particle list label.
+      \param particles The particle list.
+    */
+    template <class MemorySpace, class... FieldTags>
+    void add( const ParticleList<MemorySpace, FieldTags...>& particles )
+    {
+        add( particles.label(), particles.aosoa() );
+        _sections.back().layout = Impl::particleListLayout( particles );
+    }
+
+    /*!
+      \brief Write the added sections and clear them.
+      \param prefix Filename prefix.
+      \param time_step_index Simulation step index.
+    */
+    void write( const std::string& prefix, const int time_step_index )
+    {
+        Kokkos::Profiling::pushRegion( "Cabana::Checkpoint::write" );
+
+        int comm_rank;
+        MPI_Comm_rank( _comm, &comm_rank );
+        int comm_size;
+        MPI_Comm_size( _comm, &comm_size );
+        int file = Impl::fileIndex( _comm, _config );
+        MPI_Comm file_comm;
+        MPI_Comm_split( _comm, file, comm_rank, &file_comm );
+        int file_rank;
+        MPI_Comm_rank( file_comm, &file_rank );
+        int file_size;
+        MPI_Comm_size( file_comm, &file_size );
+
+        // Gather the counts and sizes of all sections in the file.
+        std::size_t num_section = _sections.size();
+        std::vector<std::uint64_t> local_sizes( 2 * num_section );
+        for ( std::size_t s = 0; s < num_section; ++s )
+        {
+            local_sizes[2 * s] = _sections[s].count;
+            local_sizes[2 * s + 1] = _sections[s].bytes.size();
+        }
+        std::vector<std::uint64_t> sizes( 2 * num_section * file_size );
+        MPI_Allgather( local_sizes.data(), 2 * num_section, MPI_UINT64_T,
+                       sizes.data(), 2 * num_section, MPI_UINT64_T,
+                       file_comm );
+        auto count = [&]( const int r, const std::size_t s )
+        { return sizes[2 * ( r * num_section + s )]; };
+        auto bytes = [&]( const int r, const std::size_t s )
+        { return sizes[2 * ( r * num_section + s ) + 1]; };
+
+        // Compose the header. Every rank builds it to find its offsets.
+        std::vector<char> table;
+        Impl::pack( table, comm_size );
+        Impl::pack( table, std::max( 1, std::min( _config.num_files,
+                                                   comm_size ) ) );
+        Impl::pack( table, file_size );
+        Impl::pack( table, num_section );
+        for ( std::size_t s = 0; s < num_section; ++s )
+        {
+            Impl::pack( table, _sections[s].name );
+            Impl::pack( table, _sections[s].layout );
+            for ( int r = 0; r < file_size; ++r )
+            {
+                Impl::pack( table, count( r, s ) );
+                Impl::pack( table, bytes( r, s ) );
+            }
+        }
+        std::vector<char> header( Impl::checkpoint_magic,
+                                  Impl::checkpoint_magic +
+                                      sizeof( Impl::checkpoint_magic ) );
+        Impl::pack( header, table.size() );
+        header.insert( header.end(), table.begin(), table.end() );
+
+        // Sections follow the header, ordered by rank within each section.
+        std::vector<MPI_Offset> offsets( num_section );
+        std::vector<std::size_t> num_chunk( num_section, 0 );
+        MPI_Offset file_bytes = header.size();
+        for ( std::size_t s = 0; s < num_section; ++s )
+            for ( int r = 0; r < file_size; ++r )
+            {
+                if ( r == file_rank )
+                    offsets[s] = file_bytes;
+                file_bytes += bytes( r, s );
+                num_chunk[s] =
+                    std::max( num_chunk[s], Impl::numChunk( bytes( r, s ) ) );
+            }
+
+        // Write the file.
+        MPI_File file_handle;
+        auto filename = Impl::fileName( prefix, time_step_index, file );
+        if ( MPI_SUCCESS != MPI_File_open( file_comm, filename.c_str(),
+                                           MPI_MODE_WRONLY | MPI_MODE_CREATE,
+                                           MPI_INFO_NULL, &file_handle ) )
+        {
+            MPI_Comm_free( &file_comm );
+            throw std::runtime_error( "Could not open checkpoint file " +
+                                      filename );
+        }
+        MPI_File_set_size( file_handle, file_bytes );
+        if ( 0 == file_rank )
+            MPI_File_write_at( file_handle, 0, header.data(), header.size(),
+                               MPI_BYTE, MPI_STATUS_IGNORE );
+        for ( std::size_t s = 0; s < num_section; ++s )
+            Impl::writeAt( file_handle, offsets[s],
+                           _sections[s].bytes.data(),
+                           _sections[s].bytes.size(), num_chunk[s],
+                           _config.collective );
+        MPI_File_close( &file_handle );
+        MPI_Comm_free( &file_comm );
+
+        _sections.clear();
+
+        Kokkos::Profiling::popRegion();
+    }
+
+  private:
+    MPI_Comm _comm;
+    CheckpointConfig _config;
+    std::vector<Impl::Section> _sections;
+};
+
+//---------------------------------------------------------------------------//
+/*!
+  \brief Checkpoint reader.
+
+  The file of this rank is opened and its header read on construction.
+  Sections are then read into containers of the layout they were written
+  from. All ranks of the communicator must read the same sections in the
+  same order.
+*/
+class Reader
+{
+  public:
+    /*!
+      \brief Constructor.
+      \param comm MPI communicator. Must have the size of the communicator
+      the checkpoint was written with.
+      \param prefix Filename prefix.
+      \param time_step_index Simulation step index.
+      \param config Checkpoint file configuration. Must have the number of
+      files the checkpoint was written with.
+
+      Collective over the communicator. If any file cannot be read, every
+      rank throws.
+    */
+    Reader( MPI_Comm comm, const std::string& prefix,
+            const int time_step_index, const CheckpointConfig& config = {} )
+        : _comm( comm )
+        , _config( config )
+    {
+        int comm_rank;
+        MPI_Comm_rank( comm, &comm_rank );
+        int comm_size;
+        MPI_Comm_size( comm, &comm_size );
+        int file = Impl::fileIndex( comm, _config );
+        MPI_Comm_split( comm, file, comm_rank, &_file_comm );
+        int file_rank;
+        MPI_Comm_rank( _file_comm, &file_rank );
+        int file_size;
+        MPI_Comm_size( _file_comm, &file_size );
+
+        auto filename = Impl::fileName( prefix, time_step_index, file );
+        std::string error;
+        if ( MPI_SUCCESS != MPI_File_open( _file_comm, filename.c_str(),
+                                           MPI_MODE_RDONLY, MPI_INFO_NULL,
+                                           &_file ) )
+            error = "Could not open checkpoint file " + filename;
+        else
+            error = readTable( filename, comm_size, file_rank, file_size );
+
+        // Ranks reading other files must throw as well, otherwise they would
+        // wait for this rank in the next collective read.
+        if ( agreeOnError( error ) )
+        {
+            close();
+            throw std::runtime_error(
+                error.empty()
+                    ? "Checkpoint could not be opened on another rank"
+                    : error );
+        }
+    }
+
+    //! Destructor. Closes the file.
+    ~Reader() { close(); }
+
+    Reader( const Reader& ) = delete;
+    Reader& operator=( const Reader& ) = delete;
+
+    //! Check if the checkpoint has a section.
+    bool contains( const std::string& name ) const
+    {
+        return _sections.count( name ) > 0;
+    }
+
+    //! Get the number of elements of this rank in a section.
+    std::size_t count( const std::string& name ) const
+    {
+        return section( name ).count;
+    }
+
+    //! Get the layout description of a section.
+    const std::string& layout( const std::string& name ) const
+    {
+        return section( name ).layout;
+    }
+
+    /*!
+      \brief Read the raw bytes of a section.
+      \param name Section name.
+      \param layout Expected layout description.
+      \param data Host destination of the data of this rank.
+      \param bytes Size of the destination. Must match the size written.
+
+      Collective over the communicator. Errors are agreed on by all ranks
+      before reading so that every rank throws.
+    */
+    void readSection( const std::string& name, const std::string& layout,
+                      void* data, const std::size_t bytes )
+    {
+        std::string error;
+        auto it = _sections.find( name );
+        if ( it == _sections.end() )
+            error = "Checkpoint has no section " + name;
+        else if ( it->second.layout != layout )
+            error = "Checkpoint section " + name + " has layout '" +
+                    it->second.layout + "', expected '" + layout + "'";
+        else if ( it->second.bytes != bytes )
+            error = "Checkpoint section " + name + " has a different size";
+        if ( agreeOnError( error ) )
+            throw std::runtime_error(
+                error.empty() ? "Checkpoint section " + name +
+                                    " could not be read on another rank"
+                              : error );
+
+        const auto& info = it->second;
+        Impl::readAt( _file, info.offset, static_cast<char*>( data ), bytes,
+                      info.num_chunk, _config.collective );
+    }
+
+    /*!
+      \brief Read all members of an AoSoA. The AoSoA is resized to the
+      number of particles written by this rank.
+      \param name Section name.
+      \param aosoa The AoSoA.
+    */
+    template <class AoSoAType>
+    void read( const std::string& name, AoSoAType& aosoa,
+               typename std::enable_if<is_aosoa<AoSoAType>::value,
+                                       int>::type* = 0 )
+    {
+        readAoSoA( name, Impl::aosoaLayout<AoSoAType>(), aosoa );
+    }
+
+    /*!
+      \brief Read all fields of a particle list from the section named by its
+      label. The list is resized to the number of particles written by this
+      rank.
+      \param particles The particle list.
+    */
+    template <class MemorySpace, class... FieldTags>
+    void read( ParticleList<MemorySpace, FieldTags...>& particles )
+    {
+        readAoSoA( particles.label(), Impl::particleListLayout( particles ),
+                   particles.aosoa() );
+    }
+
+  private:
+    struct SectionInfo
+    {
+        std::string layout;
+        std::uint64_t count;
+        std::uint64_t bytes;
+        MPI_Offset offset;
+        std::size_t num_chunk;
+    };
+
+    // Read the header and section table of the open file. Returns an error
+    // message if the file cannot be read with this rank layout.
+    std::string readTable( const std::string& filename, const int comm_size,
+                           const int file_rank, const int file_size )
+    {
+        // Read the header once and share it within the file.
+        std::vector<char> header( sizeof( Impl::checkpoint_magic ) +
+                                  sizeof( std::uint64_t ) );
+        if ( 0 == file_rank )
+            MPI_File_read_at( _file, 0, header.data(), header.size(),
+                              MPI_BYTE, MPI_STATUS_IGNORE );
+        MPI_Bcast( header.data(), header.size(), MPI_BYTE, 0, _file_comm );
+        std::size_t pos = sizeof( Impl::checkpoint_magic );
+        if ( 0 != std::memcmp( header.data(), Impl::checkpoint_magic, pos ) )
+            return filename + " is not a checkpoint file";
+        std::vector<char> table( Impl::unpackValue( header, pos ) );
+        if ( 0 == file_rank )
+            MPI_File_read_at( _file, header.size(), table.data(),
+                              table.size(), MPI_BYTE, MPI_STATUS_IGNORE );
+        MPI_Bcast( table.data(), table.size(), MPI_BYTE, 0, _file_comm );
+
+        // Check the rank layout.
+        pos = 0;
+        std::uint64_t written_comm_size = Impl::unpackValue( table, pos );
+        std::uint64_t written_num_files = Impl::unpackValue( table, pos );
+        std::uint64_t written_file_size = Impl::unpackValue( table, pos );
+        std::uint64_t num_files =
+            std::max( 1, std::min( _config.num_files, comm_size ) );
+        if ( written_comm_size != static_cast<std::uint64_t>( comm_size ) ||
+             written_num_files != num_files ||
+             written_file_size != static_cast<std::uint64_t>( file_size ) )
+            return "Checkpoint was written with a different number of ranks "
+                   "or files";
+
+        // Get the location of the data of this rank in each section.
+        MPI_Offset file_bytes = header.size() + table.size();
+        std::size_t num_section = Impl::unpackValue( table, pos );
+        for ( std::size_t s = 0; s < num_section; ++s )
+        {
+            SectionInfo info;
+            std::string name = Impl::unpackString( table, pos );
+            info.layout = Impl::unpackString( table, pos );
+            info.num_chunk = 0;
+            for ( int r = 0; r < file_size; ++r )
+            {
+                std::uint64_t count = Impl::unpackValue( table, pos );
+                std::uint64_t bytes = Impl::unpackValue( table, pos );
+                if ( r == file_rank )
+                {
+                    info.count = count;
+                    info.bytes = bytes;
+                    info.offset = file_bytes;
+                }
+                file_bytes += bytes;
+                info.num_chunk =
+                    std::max( info.num_chunk, Impl::numChunk( bytes ) );
+            }
+            _sections.emplace( name, info );
+        }
+        return "";
+    }
+
+    // Check if any rank of the communicator has an error.
+    bool agreeOnError( const std::string& error ) const
+    {
+        int local_error = !error.empty();
+        int global_error = 0;
+        MPI_Allreduce( &local_error, &global_error, 1, MPI_INT, MPI_MAX,
+                       _comm );
+        return global_error;
+    }
+
+    const SectionInfo& section( const std::string& name ) const
+    {
+        auto it = _sections.find( name );
+        if ( it == _sections.end() )
+            throw std::runtime_error( "Checkpoint has no section " + name );
+        return it->second;
+    }
+
+    template <class AoSoAType>
+    void readAoSoA( const std::string& name, const std::string& layout,
+                    AoSoAType& aosoa )
+    {
+        Kokkos::Profiling::pushRegion( "Cabana::Checkpoint::read" );
+
+        using memory_space = typename AoSoAType::memory_space;
+        if ( contains( name ) )
+            aosoa.resize( count( name ) );
+        std::size_t bytes =
+            aosoa.numSoA() * sizeof( typename AoSoAType::soa_type );
+        Kokkos::View<char*, memory_space, Kokkos::MemoryUnmanaged> raw(
+            reinterpret_cast<char*>( aosoa.data() ), bytes );
+        auto host_raw = Kokkos::create_mirror_view(
+            Kokkos::WithoutInitializing, Kokkos::HostSpace(), raw );
+        readSection( name, layout, host_raw.data(), bytes );
+        Kokkos::deep_copy( raw, host_raw );
+
+        Kokkos::Profiling::popRegion();
+    }
+
+    void close()
+    {
+        if ( MPI_FILE_NULL != _file )
+            MPI_File_close( &_file );
+        if ( MPI_COMM_NULL != _file_comm )
+            MPI_Comm_free( &_file_comm );
+    }
+
+    MPI_Comm _comm;
+    CheckpointConfig _config;
+    MPI_Comm _file_comm = MPI_COMM_NULL;
+    MPI_File _file = MPI_FILE_NULL;
+    std::map<std::string, SectionInfo> _sections;
+};
+
+//---------------------------------------------------------------------------//
+
+} // namespace Checkpoint
+} // namespace Experimental
+} // namespace Cabana
+
+#endif // end CABANA_CHECKPOINT_HPP
@@ -18,6 +18,8 @@
 
 #include <CabanaCore_config.hpp>
 
+#include <Cabana_MemoryPool.hpp>
+
 #include <Kokkos_Core.hpp>
 #include <Kokkos_ScatterView.hpp>
 
@@ -982,12 +984,26 @@ struct CommunicationDataAoSoA
     //! Resize the send buffer.
     void reallocateSend( const std::size_t num_send )
     {
-        Kokkos::realloc( _send_buffer, num_send );
+        if ( nullptr != _pool )
+        {
+            _send_block = _pool->acquire( num_send * sizeof( data_type ) );
+            _send_buffer = buffer_type(
+                reinterpret_cast<data_type*>( _send_block.data() ), num_send );
+        }
+        else
+            Kokkos::realloc( _send_buffer, num_send );
     }
     //! Resize the receive buffer.
     void reallocateReceive( const std::size_t num_recv )
     {
-        Kokkos::realloc( _recv_buffer, num_recv );
+        if ( nullptr != _pool )
+        {
+            _recv_block = _pool->acquire( num_recv * sizeof( data_type ) );
+            _recv_buffer = buffer_type(
+                reinterpret_cast<data_type*>( _recv_block.data() ), num_recv );
+        }
+        else
+            Kokkos::realloc( _recv_buffer, num_recv );
     }
 
     //! Send buffer.
@@ -998,6 +1014,12 @@ struct CommunicationDataAoSoA
     particle_data_type _particles;
     //! Slice components.
     std::size_t _num_comp = 0;
+    //! Optional memory pool for the buffers.
+    MemoryPool<memory_space>* _pool = nullptr;
+    //! Pool block backing the send buffer.
+    typename MemoryPool<memory_space>::block_type _send_block;
+    //! Pool block backing the receive buffer.
+    typename MemoryPool<memory_space>::block_type _recv_block;
 };
 
 /*!
@@ -1036,12 +1058,30 @@ struct CommunicationDataSlice
     //! Resize the send buffer.
     void reallocateSend( const std::size_t num_send )
     {
-        Kokkos::realloc( _send_buffer, num_send, _num_comp );
+        if ( nullptr != _pool )
+        {
+            _send_block = _pool->acquire( num_send * _num_comp *
+                                          sizeof( data_type ) );
+            _send_buffer =
+                buffer_type( reinterpret_cast<data_type*>( _send_block.data() ),
+                             num_send, _num_comp );
+        }
+        else
+            Kokkos::realloc( _send_buffer, num_send, _num_comp );
     }
     //! Resize the receive buffer.
     void reallocateReceive( const std::size_t num_recv )
     {
-        Kokkos::realloc( _recv_buffer, num_recv, _num_comp );
+        if ( nullptr != _pool )
+        {
+            _recv_block = _pool->acquire( num_recv * _num_comp *
+                                          sizeof( data_type ) );
+            _recv_buffer =
+                buffer_type( reinterpret_cast<data_type*>( _recv_block.data() ),
+                             num_recv, _num_comp );
+        }
+        else
+            Kokkos::realloc( _recv_buffer, num_recv, _num_comp );
     }
 
     //! Get the total number of components in the slice.
@@ -1060,6 +1100,12 @@ struct CommunicationDataSlice
     particle_data_type _particles;
     //! Slice components.
     std::size_t _num_comp;
+    //! Optional memory pool for the buffers.
+    MemoryPool<memory_space>* _pool = nullptr;
+    //! Pool block backing the send buffer.
+    typename MemoryPool<memory_space>::block_type _send_block;
+    //! Pool block backing the receive buffer.
+    typename MemoryPool<memory_space>::block_type _recv_block;
 };
 //---------------------------------------------------------------------------//
 
@@ -1107,6 +1153,18 @@ class CommunicationData
     //! Get the communication receive buffer.
     buffer_type getReceiveBuffer() const { return _comm_data._recv_buffer; }
 
+    /*!
+      \brief Allocate future communication buffers from a memory pool.
+      \param pool The pool to allocate from or nullptr to allocate directly.
+      The pool must outlive this object. A pool with first touch enabled
+      places host buffers across NUMA domains (see
+      MemoryPool::setFirstTouch()).
+    */
+    void setMemoryPool( MemoryPool<memory_space>* pool )
+    {
+        _comm_data._pool = pool;
+    }
+
     //! Get the particles to communicate.
     particle_data_type getData() const { return _comm_data._particles; }
     //! Update particles to communicate.
@@ -19,24 +19,35 @@
 #include <CabanaCore_config.hpp>
 
 #include <Cabana_AoSoA.hpp>
+#include <Cabana_BinaryParticleIO.hpp>
 #include <Cabana_DeepCopy.hpp>
 #include <Cabana_Fields.hpp>
+#include <Cabana_HotColdAoSoA.hpp>
+#include <Cabana_KNearestNeighborList.hpp>
 #include <Cabana_LinkedCellList.hpp>
 #include <Cabana_MemberTypes.hpp>
+#include <Cabana_MemoryPool.hpp>
+#include <Cabana_MixedPrecision.hpp>
 #include <Cabana_NeighborList.hpp>
 #include <Cabana_Parallel.hpp>
 #include <Cabana_ParameterPack.hpp>
+#include <Cabana_ParticleAppender.hpp>
 #include <Cabana_ParticleInit.hpp>
 #include <Cabana_ParticleList.hpp>
+#include <Cabana_ParticleSelection.hpp>
+#include <Cabana_Remove.hpp>
 #include <Cabana_Slice.hpp>
 #include <Cabana_SoA.hpp>
 #include <Cabana_Sort.hpp>
+#include <Cabana_TripletList.hpp>
 #include <Cabana_Tuple.hpp>
 #include <Cabana_Types.hpp>
+#include <Cabana_VectorLengthTuner.hpp>
 #include <Cabana_VerletList.hpp>
 #include <Cabana_Version.hpp>
 
 #ifdef Cabana_ENABLE_MPI
+#include <Cabana_Checkpoint.hpp>
 #include <Cabana_Distributor.hpp>
 #include <Cabana_Halo.hpp>
 
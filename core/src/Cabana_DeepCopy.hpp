@@ -17,6 +17,7 @@
 #define CABANA_DEEPCOPY_HPP
 
 #include <Cabana_AoSoA.hpp>
+#include <Cabana_HotColdAoSoA.hpp>
 #include <Cabana_ParticleList.hpp>
 #include <Cabana_Slice.hpp>
 #include <impl/Cabana_TypeTraits.hpp>
@@ -25,6 +26,7 @@
 
 #include <exception>
 #include <type_traits>
+#include <utility>
 
 namespace Cabana
 {
@@ -141,20 +143,191 @@ create_mirror_view_and_copy(
 
 //---------------------------------------------------------------------------//
 /*!
-  \brief Deep copy data between compatible AoSoA objects.
+  \brief Create a mirror view of the given AoSoA in the given memory space and
+  enqueue a copy of its contents on an execution space instance. Same space
+  specialization returns the input AoSoA.
+ */
+template <class ExecutionSpace, class Space, class SrcAoSoA>
+inline SrcAoSoA create_mirror_view_and_copy(
+    const ExecutionSpace&, const Space&, const SrcAoSoA& src,
+    typename std::enable_if<
+        ( Kokkos::is_execution_space<ExecutionSpace>::value &&
+          std::is_same<typename SrcAoSoA::memory_space,
+                       typename Space::memory_space>::value &&
+          is_aosoa<SrcAoSoA>::value )>::type* = 0 )
+{
+    return src;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+  \brief Create a mirror of the given AoSoA in the given memory space and
+  enqueue a copy of its contents on an execution space instance. Different
+  space specialization allocates a new AoSoA.
+
+  \param exec_space The execution space instance to enqueue the copy on. The
+  mirror must not be read until the instance has been fenced.
+
+  \param space The mirror memory space.
+
+  \param src The AoSoA to mirror.
+ */
+template <class ExecutionSpace, class Space, class SrcAoSoA>
+inline AoSoA<typename SrcAoSoA::member_types, Space, SrcAoSoA::vector_length>
+create_mirror_view_and_copy(
+    const ExecutionSpace& exec_space, const Space& space, const SrcAoSoA& src,
+    typename std::enable_if<
+        ( Kokkos::is_execution_space<ExecutionSpace>::value &&
+          !std::is_same<typename SrcAoSoA::memory_space,
+                        typename Space::memory_space>::value &&
+          is_aosoa<SrcAoSoA>::value )>::type* = 0 )
+{
+    auto dst = create_mirror( space, src );
+
+    Kokkos::deep_copy(
+        exec_space,
+        typename decltype( dst )::soa_view( dst.data(), dst.numSoA() ),
+        typename SrcAoSoA::soa_view( src.data(), src.numSoA() ) );
+
+    return dst;
+}
+
+//---------------------------------------------------------------------------//
+//! \cond Impl
+namespace Impl
+{
+// Check if a member of one type can be copied into a member of another type:
+// the extents must match and the values must be convertible.
+template <class Dst, class Src>
+struct IsMemberConvertible
+    : public std::integral_constant<
+          bool, ( std::rank<Dst>::value == std::rank<Src>::value &&
+                  std::extent<Dst, 0>::value == std::extent<Src, 0>::value &&
+                  std::extent<Dst, 1>::value == std::extent<Src, 1>::value &&
+                  std::extent<Dst, 2>::value == std::extent<Src, 2>::value &&
+                  std::is_convertible<
+                      typename std::remove_all_extents<Src>::type,
+                      typename std::remove_all_extents<Dst>::type>::value )>
+{
+};
+
+template <class Dst, class Src, bool = ( Dst::size == Src::size )>
+struct AreMemberTypesConvertible : public std::false_type
+{
+};
+
+template <class... DstTypes, class... SrcTypes>
+struct AreMemberTypesConvertible<MemberTypes<DstTypes...>,
+                                 MemberTypes<SrcTypes...>, true>
+    : public std::integral_constant<
+          bool, ( IsMemberConvertible<DstTypes, SrcTypes>::value && ... )>
+{
+};
+
+// Copy one member element by element, converting each value to the
+// destination type. Both AoSoAs must be accessible from the execution space.
+template <std::size_t M, class ExecutionSpace, class DstAoSoA, class SrcAoSoA>
+void deepCopyMember( const ExecutionSpace& exec_space, DstAoSoA& dst,
+                     const SrcAoSoA& src )
+{
+    auto dst_slice = Cabana::slice<M>( dst );
+    auto src_slice = Cabana::slice<M>( src );
+    using dst_slice_type = decltype( dst_slice );
+    using src_slice_type = decltype( src_slice );
+    using dst_value_type = typename dst_slice_type::value_type;
+
+    // Get the number of components in the member.
+    std::size_t num_comp = 1;
+    for ( std::size_t d = 2; d < dst_slice.viewRank(); ++d )
+        num_comp *= dst_slice.extent( d );
+
+    auto dst_data = dst_slice.data();
+    auto src_data = src_slice.data();
+    auto copy_func = KOKKOS_LAMBDA( const std::size_t i )
+    {
+        std::size_t dst_offset =
+            dst_slice_type::index_type::s( i ) * dst_slice.stride( 0 ) +
+            dst_slice_type::index_type::a( i );
+        std::size_t src_offset =
+            src_slice_type::index_type::s( i ) * src_slice.stride( 0 ) +
+            src_slice_type::index_type::a( i );
+        for ( std::size_t n = 0; n < num_comp; ++n )
+            dst_data[dst_offset + dst_slice_type::vector_length * n] =
+                static_cast<dst_value_type>(
+                    src_data[src_offset + src_slice_type::vector_length * n] );
+    };
+    Kokkos::RangePolicy<ExecutionSpace> exec_policy( exec_space, 0,
+                                                     dst.size() );
+    Kokkos::parallel_for( "Cabana::deep_copy::member", exec_policy,
+                          copy_func );
+}
+
+template <class ExecutionSpace, class DstAoSoA, class SrcAoSoA,
+          std::size_t... Ms>
+void deepCopyMembers( const ExecutionSpace& exec_space, DstAoSoA& dst,
+                      const SrcAoSoA& src, std::index_sequence<Ms...> )
+{
+    ( deepCopyMember<Ms>( exec_space, dst, src ), ... );
+}
+
+// Copy all members between AoSoAs of different layouts by transposing the
+// SoA blocks directly. The source is read in place if the execution space
+// can access it and otherwise is first brought to the destination memory
+// space.
+template <class ExecutionSpace, class DstAoSoA, class SrcAoSoA>
+void deepCopyTranspose( const ExecutionSpace& exec_space, DstAoSoA& dst,
+                        const SrcAoSoA& src )
+{
+    if ( !Kokkos::SpaceAccessibility<
+             ExecutionSpace, typename DstAoSoA::memory_space>::accessible )
+        throw std::runtime_error( "AoSoA layout conversion requires an "
+                                  "execution space that can access the "
+                                  "destination" );
+
+    using indices = std::make_index_sequence<DstAoSoA::member_types::size>;
+    if ( Kokkos::SpaceAccessibility<
+             ExecutionSpace, typename SrcAoSoA::memory_space>::accessible )
+    {
+        deepCopyMembers( exec_space, dst, src, indices() );
+    }
+    else
+    {
+        // The staged source is released on return so wait for it to be
+        // consumed.
+        auto src_copy_on_dst = create_mirror_view_and_copy(
+            exec_space, typename DstAoSoA::memory_space(), src );
+        deepCopyMembers( exec_space, dst, src_copy_on_dst, indices() );
+        exec_space.fence();
+    }
+}
+} // namespace Impl
+//! \endcond
+
+//---------------------------------------------------------------------------//
+/*!
+  \brief Asynchronously deep copy data between compatible AoSoA objects.
+
+  \param exec_space The execution space instance to enqueue the copy on. The
+  copy is complete once the instance has been fenced.
 
   \param dst The destination for the copied data.
 
   \param src The source of the copied data.
 
-  Only AoSoA objects with the same set of member data types and size may be
-  copied.
+  AoSoA objects must have the same size and either the same member types or
+  member types with the same extents whose values are convertible (e.g. to
+  change the storage precision of a member between double, float and
+  FixedPoint). Copies between different layouts or member types run on the
+  instance, which must be able to access the destination. If it cannot also
+  access the source, the source is staged in the destination memory space
+  and the instance is fenced before returning.
 */
-template <class DstAoSoA, class SrcAoSoA>
-inline void
-deep_copy( DstAoSoA& dst, const SrcAoSoA& src,
-           typename std::enable_if<( is_aosoa<DstAoSoA>::value &&
-                                     is_aosoa<SrcAoSoA>::value )>::type* = 0 )
+template <class ExecutionSpace, class DstAoSoA, class SrcAoSoA>
+inline void deep_copy(
+    const ExecutionSpace& exec_space, DstAoSoA& dst, const SrcAoSoA& src,
+    typename std::enable_if<
+        ( Kokkos::is_execution_space<ExecutionSpace>::value &&
+          is_aosoa<DstAoSoA>::value && is_aosoa<SrcAoSoA>::value )>::type* = 0 )
 {
     using dst_type = DstAoSoA;
     using src_type = SrcAoSoA;
@@ -163,11 +336,12 @@ deep_copy( DstAoSoA& dst, const SrcAoSoA& src,
     using dst_soa_type = typename dst_type::soa_type;
     using src_soa_type = typename src_type::soa_type;
 
-    // Check that the data types are the same.
+    // Check that the data types are the same or convertible.
     static_assert(
-        std::is_same<typename dst_type::member_types,
-                     typename src_type::member_types>::value,
-        "Attempted to deep copy AoSoA objects of different member types" );
+        Impl::AreMemberTypesConvertible<
+            typename dst_type::member_types,
+            typename src_type::member_types>::value,
+        "Attempted to deep copy AoSoA objects of inconvertible member types" );
 
     // Check for the same number of values.
     if ( dst.size() != src.size() )
@@ -201,7 +375,8 @@ deep_copy( DstAoSoA& dst, const SrcAoSoA& src,
     // of values then we can do a byte-wise copy directly.
     if ( std::is_same<dst_soa_type, src_soa_type>::value )
     {
-        Kokkos::deep_copy( Kokkos::View<char*, dst_memory_space>(
+        Kokkos::deep_copy( exec_space,
+                           Kokkos::View<char*, dst_memory_space>(
                                reinterpret_cast<char*>( dst.data() ),
                                dst.numSoA() * sizeof( dst_soa_type ) ),
                            Kokkos::View<char*, src_memory_space>(
@@ -209,27 +384,37 @@ deep_copy( DstAoSoA& dst, const SrcAoSoA& src,
                                src.numSoA() * sizeof( src_soa_type ) ) );
     }
 
-    // Otherwise copy the data element-by-element because the data layout is
-    // different.
+    // Otherwise transpose the data member-by-member because the data layout
+    // or member types are different.
     else
     {
-        // Create an AoSoA in the destination space with the same data layout
-        // as the source.
-        auto src_copy_on_dst = create_mirror_view_and_copy(
-            typename dst_type::memory_space(), src );
-
-        // Copy via tuples.
-        auto copy_func = KOKKOS_LAMBDA( const std::size_t i )
-        {
-            dst.setTuple( i, src_copy_on_dst.getTuple( i ) );
-        };
-        Kokkos::RangePolicy<typename dst_type::execution_space> exec_policy(
-            0, dst.size() );
-        Kokkos::parallel_for( "Cabana::deep_copy", exec_policy, copy_func );
-        Kokkos::fence();
+        Impl::deepCopyTranspose( exec_space, dst, src );
     }
 }
 
+//---------------------------------------------------------------------------//
+/*!
+  \brief Deep copy data between compatible AoSoA objects.
+
+  \param dst The destination for the copied data.
+
+  \param src The source of the copied data.
+
+  AoSoA objects must have the same size and either the same member types or
+  member types with the same extents whose values are convertible (e.g. to
+  change the storage precision of a member between double, float and
+  FixedPoint).
+*/
+template <class DstAoSoA, class SrcAoSoA>
+inline void
+deep_copy( DstAoSoA& dst, const SrcAoSoA& src,
+           typename std::enable_if<( is_aosoa<DstAoSoA>::value &&
+                                     is_aosoa<SrcAoSoA>::value )>::type* = 0 )
+{
+    deep_copy( typename DstAoSoA::execution_space(), dst, src );
+    Kokkos::fence();
+}
+
 //---------------------------------------------------------------------------//
 /*!
   \brief Deep copy data between compatible ParticleList objects.
@@ -249,6 +434,25 @@ inline void deep_copy( ParticleList<DstMemorySpace, FieldTags...>& dst,
     Cabana::deep_copy( aosoa_dst, aosoa_src );
 }
 
+/*!
+  \brief Asynchronously deep copy data between compatible ParticleList
+  objects.
+
+  \param exec_space The execution space instance to enqueue the copy on.
+  \param dst The destination for the copied data.
+  \param src The source of the copied data.
+*/
+template <class ExecutionSpace, class DstMemorySpace, class SrcMemorySpace,
+          class... FieldTags>
+inline void deep_copy( const ExecutionSpace& exec_space,
+                       ParticleList<DstMemorySpace, FieldTags...>& dst,
+                       const ParticleList<SrcMemorySpace, FieldTags...>& src )
+{
+    auto aosoa_src = src.aosoa();
+    auto& aosoa_dst = dst.aosoa();
+    Cabana::deep_copy( exec_space, aosoa_dst, aosoa_src );
+}
+
 //---------------------------------------------------------------------------//
 /*!
   \brief Fill an AoSoA with a tuple.
@@ -388,6 +592,86 @@ deep_copy( DstSlice& dst, const SrcSlice& src,
     Kokkos::fence();
 }
 
+//---------------------------------------------------------------------------//
+/*!
+  \brief Asynchronously deep copy data between compatible Slice objects.
+
+  \param exec_space The execution space instance to enqueue the copy on. The
+  copy is complete once the instance has been fenced.
+
+  \param dst The destination for the copied data.
+
+  \param src The source of the copied data.
+
+  The copy runs as a single kernel on the instance, which must be able to
+  access both slices. Use the AoSoA overload to stage copies between memory
+  spaces that no single execution space can access.
+*/
+template <class ExecutionSpace, class DstSlice, class SrcSlice>
+inline void deep_copy(
+    const ExecutionSpace& exec_space, DstSlice& dst, const SrcSlice& src,
+    typename std::enable_if<
+        ( Kokkos::is_execution_space<ExecutionSpace>::value &&
+          is_slice<DstSlice>::value && is_slice<SrcSlice>::value )>::type* =
+        0 )
+{
+    // Check that the data types are the same.
+    static_assert(
+        std::is_same<typename DstSlice::value_type,
+                     typename SrcSlice::value_type>::value,
+        "Attempted to deep copy Slice objects of different value types" );
+
+    // Check for the same number of elements.
+    if ( dst.size() != src.size() )
+    {
+        throw std::runtime_error(
+            "Attempted to deep copy Slice objects of different sizes" );
+    }
+
+    // Check the instance can access both slices.
+    if ( !Kokkos::SpaceAccessibility<
+             ExecutionSpace, typename DstSlice::memory_space>::accessible ||
+         !Kokkos::SpaceAccessibility<
+             ExecutionSpace, typename SrcSlice::memory_space>::accessible )
+    {
+        throw std::runtime_error( "Asynchronous slice deep copy requires an "
+                                  "execution space that can access both "
+                                  "slices" );
+    }
+
+    // Get the pointers to the beginning of the data blocks.
+    auto dst_data = dst.data();
+    const auto src_data = src.data();
+
+    // Return if the slice memory occupies the same space.
+    if ( ( dst_data == src_data ) && ( dst.numSoA() * dst.stride( 0 ) ==
+                                       src.numSoA() * src.stride( 0 ) ) )
+    {
+        return;
+    }
+
+    // Get the number of components in each slice element.
+    std::size_t num_comp = 1;
+    for ( std::size_t d = 2; d < dst.viewRank(); ++d )
+        num_comp *= dst.extent( d );
+
+    // Copy directly between the two layouts.
+    auto copy_func = KOKKOS_LAMBDA( const std::size_t i )
+    {
+        auto dst_offset = DstSlice::index_type::s( i ) * dst.stride( 0 ) +
+                          DstSlice::index_type::a( i );
+        auto src_offset = SrcSlice::index_type::s( i ) * src.stride( 0 ) +
+                          SrcSlice::index_type::a( i );
+        for ( std::size_t n = 0; n < num_comp; ++n )
+            dst_data[dst_offset + DstSlice::vector_length * n] =
+                src_data[src_offset + SrcSlice::vector_length * n];
+    };
+    Kokkos::RangePolicy<ExecutionSpace> copy_policy( exec_space, 0,
+                                                     dst.size() );
+    Kokkos::parallel_for( "Cabana::deep_copy::slice", copy_policy,
+                          copy_func );
+}
+
 //---------------------------------------------------------------------------//
 /*!
   \brief Fill a slice with a scalar.
@@ -451,6 +735,85 @@ auto create_mirror_view_and_copy(
     return ParticleList<DstMemorySpace, FieldTags...>( aosoa_dst );
 }
 
+/*!
+  \brief Create a mirror of the given ParticleList in the given memory space
+  and enqueue a copy of its contents on an execution space instance. Same
+  space specialization returns the input ParticleList.
+ */
+template <class ExecutionSpace, class DstMemorySpace, class SrcMemorySpace,
+          class... FieldTags>
+auto create_mirror_view_and_copy(
+    const ExecutionSpace&, DstMemorySpace,
+    ParticleList<SrcMemorySpace, FieldTags...> plist_src,
+    typename std::enable_if<
+        ( Kokkos::is_execution_space<ExecutionSpace>::value &&
+          std::is_same<SrcMemorySpace, DstMemorySpace>::value )>::type* = 0 )
+{
+    return plist_src;
+}
+
+/*!
+  \brief Create a mirror of the given ParticleList in the given memory space
+  and enqueue a copy of its contents on an execution space instance.
+
+  \note The mirror must not be read until the instance has been fenced.
+ */
+template <class ExecutionSpace, class DstMemorySpace, class SrcMemorySpace,
+          class... FieldTags>
+auto create_mirror_view_and_copy(
+    const ExecutionSpace& exec_space, DstMemorySpace,
+    ParticleList<SrcMemorySpace, FieldTags...> plist_src,
+    typename std::enable_if<
+        ( Kokkos::is_execution_space<ExecutionSpace>::value &&
+          !std::is_same<SrcMemorySpace, DstMemorySpace>::value )>::type* = 0 )
+{
+    auto aosoa_src = plist_src.aosoa();
+    ParticleList<DstMemorySpace, FieldTags...> plist_dst( aosoa_src.label() );
+    plist_dst.aosoa().resize( aosoa_src.size() );
+    deep_copy( exec_space, plist_dst.aosoa(), aosoa_src );
+    return plist_dst;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+  \brief Deep copy data between compatible HotColdAoSoA objects.
+
+  \param dst The destination for the copied data.
+
+  \param src The source of the copied data.
+*/
+template <class DstHotCold, class SrcHotCold>
+inline void deep_copy(
+    DstHotCold& dst, const SrcHotCold& src,
+    typename std::enable_if<( is_hot_cold_aosoa<DstHotCold>::value &&
+                              is_hot_cold_aosoa<SrcHotCold>::value )>::type* =
+        0 )
+{
+    deep_copy( dst.hot(), src.hot() );
+    deep_copy( dst.cold(), src.cold() );
+}
+
+//---------------------------------------------------------------------------//
+/*!
+  \brief Create a mirror of the given HotColdAoSoA in the given memory space
+  and copy its contents.
+
+  \note Memory allocation will only occur if the requested mirror memory space
+  is different from that of the input container.
+ */
+template <class Space, class HotTypes, class ColdTypes, class DeviceType,
+          int VectorLength>
+auto create_mirror_view_and_copy(
+    const Space& space,
+    const HotColdAoSoA<HotTypes, ColdTypes, DeviceType, VectorLength>& src )
+{
+    auto hot = create_mirror_view_and_copy( space, src.hot() );
+    auto cold = create_mirror_view_and_copy( space, src.cold() );
+    return HotColdAoSoA<HotTypes, ColdTypes,
+                        typename decltype( hot )::device_type, VectorLength>(
+        hot, cold );
+}
+
 } // end namespace Cabana
 
 #endif // end CABANA_DEEPCOPY_HPP
@@ -18,6 +18,7 @@
 
 #include <Cabana_AoSoA.hpp>
 #include <Cabana_CommunicationPlan.hpp>
+#include <Cabana_HotColdAoSoA.hpp>
 #include <Cabana_Slice.hpp>
 
 #include <Kokkos_Core.hpp>
@@ -398,6 +399,52 @@ void migrate( const Distributor_t& distributor, AoSoA_t& aosoa,
         aosoa.resize( distributor.totalNumImport() );
 }
 
+//---------------------------------------------------------------------------//
+/*!
+  \brief Synchronously migrate a HotColdAoSoA between two different
+  decompositions using the distributor forward communication plan. The hot
+  and cold members are migrated in turn.
+
+  \param distributor The distributor to use for the migration.
+
+  \param src The container holding the data to be migrated.
+
+  \param dst The container to which the migrated data will be written. Must
+  be the same size as the number of imports given by the distributor.
+*/
+template <class Distributor_t, class HotColdType>
+void migrate( const Distributor_t& distributor, const HotColdType& src,
+              HotColdType& dst,
+              typename std::enable_if<
+                  ( is_distributor<Distributor_t>::value &&
+                    is_hot_cold_aosoa<HotColdType>::value ),
+                  int>::type* = 0 )
+{
+    migrate( distributor, src.hot(), dst.hot() );
+    migrate( distributor, src.cold(), dst.cold() );
+}
+
+//---------------------------------------------------------------------------//
+/*!
+  \brief Synchronously migrate a HotColdAoSoA between two different
+  decompositions using the distributor forward communication plan. Resizes
+  the container in-place.
+
+  \param distributor The distributor to use for the migration.
+
+  \param aosoa The container holding the data to be migrated.
+*/
+template <class Distributor_t, class HotColdType>
+void migrate( const Distributor_t& distributor, HotColdType& aosoa,
+              typename std::enable_if<
+                  ( is_distributor<Distributor_t>::value &&
+                    is_hot_cold_aosoa<HotColdType>::value ),
+                  int>::type* = 0 )
+{
+    migrate( distributor, aosoa.hot() );
+    migrate( distributor, aosoa.cold() );
+}
+
 //---------------------------------------------------------------------------//
 /*!
   \brief Synchronously migrate data between two different decompositions using
@@ -231,6 +231,68 @@ struct NeighborDiscriminatorCallback2D_SecondPass
 // NOTE** Taking advantage of the knowledge that one predicate is processed by a
 // single thread.  Count increment should be atomic otherwise.
 
+// Keep candidates within the interaction distance of the current particle
+// positions. Used when the tree was built on inflated bounding boxes.
+template <typename Slice, typename Tag>
+struct NeighborDistanceFilter
+{
+    Slice x;
+    typename Slice::size_type first;
+    typename Slice::value_type radius_sqr;
+
+    KOKKOS_FUNCTION bool keep( int predicate_index, int primitive_index ) const
+    {
+        int const pid = predicate_index + first;
+        if ( !CollisionFilter<Tag>::keep( pid, primitive_index ) )
+            return false;
+        typename Slice::value_type dsqr = 0.0;
+        for ( int d = 0; d < 3; ++d )
+        {
+            auto const dx = x( pid, d ) - x( primitive_index, d );
+            dsqr += dx * dx;
+        }
+        return dsqr <= radius_sqr;
+    }
+};
+
+// Filtered output for CSR queries.
+template <typename Filter>
+struct NeighborFilterCallback
+{
+    Filter filter;
+    template <typename Predicate, typename OutputFunctor>
+    KOKKOS_FUNCTION void operator()( Predicate const& predicate,
+                                     int primitive_index,
+                                     OutputFunctor const& out ) const
+    {
+        if ( filter.keep( getData( predicate ), primitive_index ) )
+            out( primitive_index );
+    }
+};
+
+// Filtered count and fill for 2D queries. Neighbors beyond the allocated
+// width are only counted.
+template <typename Filter, typename Counts, typename Neighbors>
+struct NeighborFilterCallback2D
+{
+    Filter filter;
+    Counts counts;
+    Neighbors neighbors;
+    template <typename Predicate>
+    KOKKOS_FUNCTION void operator()( Predicate const& predicate,
+                                     int primitive_index ) const
+    {
+        int const predicate_index = getData( predicate );
+        if ( filter.keep( predicate_index, primitive_index ) )
+        {
+            auto& count = counts( predicate_index ); // WARNING see above**
+            if ( count < (int)neighbors.extent( 1 ) )
+                neighbors( predicate_index, count ) = primitive_index;
+            ++count;
+        }
+    }
+};
+
 //! \endcond
 } // namespace Impl
 
@@ -401,6 +463,270 @@ auto make2DNeighborList( Tag, Slice const& coordinate_slice,
     return Dense<MemorySpace, Tag>{ counts, neighbors, first, bvh.size() };
 }
 
+//---------------------------------------------------------------------------//
+/*!
+  \brief Persistent ArborX neighbor search reusing the tree and output
+  buffers between neighbor list builds.
+
+  \tparam DeviceType The device type to use for building and storing the
+  neighbor list.
+  \tparam Tag Tag indicating whether to build a full or half neighbor list.
+
+  The tree is built on the particle positions inflated by half of a skin
+  distance. As long as no particle has moved more than half of the skin since
+  the last build the tree still bounds every particle and is reused as is;
+  only the queries are repeated and candidates are filtered with the current
+  positions. The largest neighbor count of the previous build is used as the
+  buffer size guess for the next one so that a single query pass is usually
+  sufficient.
+
+  Neighbor lists returned by this object share storage with it and are
+  invalidated by the next call to makeNeighborList() or
+  make2DNeighborList().
+*/
+template <typename DeviceType, typename Tag>
+class NeighborSearch
+{
+  public:
+    //! Kokkos memory space.
+    using memory_space = typename DeviceType::memory_space;
+    //! Kokkos execution space.
+    using execution_space = typename DeviceType::execution_space;
+    //! ArborX tree type.
+    using bvh_type = ArborX::BVH<memory_space>;
+
+    /*!
+      \brief Constructor.
+      \param skin Distance particles may move in total (half of it in each
+      direction) before the tree is rebuilt.
+    */
+    NeighborSearch( Tag, const double skin = 0.0 )
+        : _skin( skin )
+        , _buffer_size( 0 )
+        , _num_build( 0 )
+        , _reference( "reference_positions", 0 )
+        , _indices( "indices", 0 )
+        , _offset( "offset", 0 )
+        , _counts( "counts", 0 )
+        , _neighbors( "neighbors", 0, 0 )
+    {
+        assert( skin >= 0.0 );
+    }
+
+    //! Get the number of times the tree has been built.
+    int numBuild() const { return _num_build; }
+
+    //! Get the current buffer size guess.
+    int bufferSize() const { return _buffer_size; }
+
+    /*!
+      \brief Determine whether the tree must be rebuilt for the given
+      positions.
+    */
+    template <typename Slice>
+    bool needsRebuild( Slice const& x ) const
+    {
+        if ( 0 == _num_build || _reference.extent( 0 ) != x.size() )
+            return true;
+
+        auto reference = _reference;
+        double max_dsqr = 0.0;
+        Kokkos::parallel_reduce(
+            "Cabana::Experimental::NeighborSearch::displacement",
+            Kokkos::RangePolicy<execution_space>( 0, x.size() ),
+            KOKKOS_LAMBDA( const int i, double& result ) {
+                double dsqr = 0.0;
+                for ( int d = 0; d < 3; ++d )
+                {
+                    double dx = x( i, d ) - reference( i, d );
+                    dsqr += dx * dx;
+                }
+                if ( dsqr > result )
+                    result = dsqr;
+            },
+            Kokkos::Max<double>( max_dsqr ) );
+
+        double half_skin = 0.5 * _skin;
+        return max_dsqr > half_skin * half_skin;
+    }
+
+    /*!
+      \brief Build the tree from the given positions.
+    */
+    template <typename Slice>
+    void build( Slice const& x )
+    {
+        Kokkos::Profiling::pushRegion(
+            "Cabana::Experimental::NeighborSearch::build" );
+
+        if ( _reference.extent( 0 ) != x.size() )
+            Kokkos::realloc( _reference, x.size() );
+        Kokkos::View<ArborX::Box*, DeviceType> boxes(
+            Kokkos::view_alloc( "boxes", Kokkos::WithoutInitializing ),
+            x.size() );
+
+        auto reference = _reference;
+        double half_skin = 0.5 * _skin;
+        Kokkos::parallel_for(
+            "Cabana::Experimental::NeighborSearch::inflate",
+            Kokkos::RangePolicy<execution_space>( 0, x.size() ),
+            KOKKOS_LAMBDA( const int i ) {
+                for ( int d = 0; d < 3; ++d )
+                    reference( i, d ) = x( i, d );
+                boxes( i ) = ArborX::Box{
+                    { static_cast<float>( x( i, 0 ) - half_skin ),
+                      static_cast<float>( x( i, 1 ) - half_skin ),
+                      static_cast<float>( x( i, 2 ) - half_skin ) },
+                    { static_cast<float>( x( i, 0 ) + half_skin ),
+                      static_cast<float>( x( i, 1 ) + half_skin ),
+                      static_cast<float>( x( i, 2 ) + half_skin ) } };
+            } );
+
+        _bvh = bvh_type( execution_space{}, boxes );
+        ++_num_build;
+
+        Kokkos::Profiling::popRegion();
+    }
+
+    /*!
+      \brief Rebuild the tree only if a particle moved too far since the
+      last build.
+      \return True if the tree was rebuilt.
+    */
+    template <typename Slice>
+    bool update( Slice const& x )
+    {
+        if ( !needsRebuild( x ) )
+            return false;
+        build( x );
+        return true;
+    }
+
+    /*!
+      \brief Create a neighbor list with a 1D compressed layout.
+
+      \param x The slice containing the particle positions.
+      \param first The beginning particle index to compute neighbors for.
+      \param last The end particle index to compute neighbors for.
+      \param radius The radius of the neighborhood.
+    */
+    template <typename Slice>
+    CrsGraph<memory_space, Tag>
+    makeNeighborList( Slice const& x, typename Slice::size_type first,
+                      typename Slice::size_type last,
+                      typename Slice::value_type radius )
+    {
+        assert( last >= first );
+        assert( last <= x.size() );
+
+        Kokkos::Profiling::pushRegion(
+            "Cabana::Experimental::NeighborSearch::makeNeighborList" );
+
+        update( x );
+
+        execution_space space{};
+        using filter_type = Impl::NeighborDistanceFilter<Slice, Tag>;
+        _bvh.query(
+            space, Impl::makePredicates( x, first, last, radius ),
+            Impl::NeighborFilterCallback<filter_type>{
+                filter_type{ x, first, radius * radius } },
+            _indices, _offset,
+            ArborX::Experimental::TraversalPolicy().setBufferSize(
+                _buffer_size ) );
+
+        // Keep the largest row as the guess for the next build.
+        auto offset = _offset;
+        int max_neighbors = 0;
+        Kokkos::parallel_reduce(
+            "Cabana::Experimental::NeighborSearch::max_neighbors",
+            Kokkos::RangePolicy<execution_space>( 0, last - first ),
+            KOKKOS_LAMBDA( const int i, int& result ) {
+                int n = offset( i + 1 ) - offset( i );
+                if ( n > result )
+                    result = n;
+            },
+            Kokkos::Max<int>( max_neighbors ) );
+        _buffer_size = max_neighbors;
+
+        Kokkos::Profiling::popRegion();
+
+        return CrsGraph<memory_space, Tag>{ _indices, _offset, first,
+                                            _bvh.size() };
+    }
+
+    /*!
+      \brief Create a neighbor list with a 2D layout.
+
+      \param x The slice containing the particle positions.
+      \param first The beginning particle index to compute neighbors for.
+      \param last The end particle index to compute neighbors for.
+      \param radius The radius of the neighborhood.
+    */
+    template <typename Slice>
+    Dense<memory_space, Tag>
+    make2DNeighborList( Slice const& x, typename Slice::size_type first,
+                        typename Slice::size_type last,
+                        typename Slice::value_type radius )
+    {
+        assert( last >= first );
+        assert( last <= x.size() );
+
+        Kokkos::Profiling::pushRegion(
+            "Cabana::Experimental::NeighborSearch::make2DNeighborList" );
+
+        update( x );
+
+        execution_space space{};
+        auto const n_queries = last - first;
+        if ( _counts.extent( 0 ) != n_queries )
+            Kokkos::realloc( _counts, n_queries );
+        else
+            Kokkos::deep_copy( _counts, 0 );
+        if ( _neighbors.extent( 0 ) != n_queries ||
+             (int)_neighbors.extent( 1 ) < _buffer_size )
+            Kokkos::realloc( _neighbors, n_queries, _buffer_size );
+
+        using filter_type = Impl::NeighborDistanceFilter<Slice, Tag>;
+        auto const predicates = Impl::makePredicates( x, first, last, radius );
+        filter_type filter{ x, first, radius * radius };
+        _bvh.query( space, predicates,
+                    Impl::NeighborFilterCallback2D<filter_type,
+                                                   decltype( _counts ),
+                                                   decltype( _neighbors )>{
+                        filter, _counts, _neighbors } );
+
+        // Grow the storage and fill again if the guess was too small.
+        int const max_neighbors = ArborX::max( space, _counts );
+        if ( max_neighbors > (int)_neighbors.extent( 1 ) )
+        {
+            Kokkos::realloc( _neighbors, n_queries, max_neighbors );
+            Kokkos::deep_copy( _counts, 0 );
+            _bvh.query( space, predicates,
+                        Impl::NeighborFilterCallback2D<filter_type,
+                                                       decltype( _counts ),
+                                                       decltype( _neighbors )>{
+                            filter, _counts, _neighbors } );
+        }
+        _buffer_size = max_neighbors;
+
+        Kokkos::Profiling::popRegion();
+
+        return Dense<memory_space, Tag>{ _counts, _neighbors, first,
+                                         _bvh.size() };
+    }
+
+  private:
+    double _skin;
+    int _buffer_size;
+    int _num_build;
+    bvh_type _bvh;
+    Kokkos::View<double* [3], memory_space> _reference;
+    Kokkos::View<int*, DeviceType> _indices;
+    Kokkos::View<int*, DeviceType> _offset;
+    Kokkos::View<int*, DeviceType> _counts;
+    Kokkos::View<int**, DeviceType> _neighbors;
+};
+
 } // namespace Experimental
 
 //! 1d ArborX NeighborList interface.
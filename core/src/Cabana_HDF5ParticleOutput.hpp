@@ -28,16 +28,30 @@
 #ifndef CABANA_HDF5PARTICLEOUTPUT_HPP
 #define CABANA_HDF5PARTICLEOUTPUT_HPP
 
+#include <Cabana_MemoryPool.hpp>
+#include <Cabana_MixedPrecision.hpp>
+#include <Cabana_ParticleList.hpp>
+#include <Cabana_ParticleSelection.hpp>
+#include <Cabana_Slice.hpp>
+
 #include <Kokkos_Core.hpp>
 
 #include <hdf5.h>
 #include <mpi.h>
 
+#include <condition_variable>
+#include <deque>
+#include <exception>
 #include <fstream>
 #include <iostream>
+#include <memory>
+#include <mutex>
 #include <sstream>
+#include <stdexcept>
 #include <string>
+#include <thread>
 #include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace Cabana
@@ -124,6 +138,12 @@ inline void writeXdmfFooter( const char* xml_file_name )
   File access property list alignment settings result in any file
   object &ge; threshold bytes aligned on an address which is a multiple of
   alignment.
+
+  Dataset creation settings select a chunked layout and a filter pipeline
+  (scale-offset, then shuffle, then deflate). Chunks hold whole particles so
+  that each rank writes whole chunks when the chunk size is its block size.
+  Filtered datasets require HDF5 1.10.2 or later and are always written
+  collectively.
 */
 struct HDF5Config
 {
@@ -142,6 +162,19 @@ struct HDF5Config
 
     //! Cause all metadata for an object to be evicted from the cache
     bool evict_on_close = false;
+
+    //! Store datasets in chunks (implied by any filter)
+    bool chunk = false;
+    //! Particles per chunk. Zero uses the largest per-rank block.
+    unsigned long chunk_size = 0;
+
+    //! Apply the byte shuffle filter (improves compression of numbers)
+    bool shuffle = false;
+    //! Deflate (gzip) compression level from 1 to 9. Zero disables.
+    int deflate_level = 0;
+    //! Decimal digits kept by the lossy scale-offset filter for floating
+    //! point fields. Negative disables.
+    int scale_offset_digits = -1;
 };
 
 //! \cond Impl
@@ -217,20 +250,171 @@ struct HDF5Traits<double>
 
 namespace Impl
 {
+//---------------------------------------------------------------------------//
+// Check if datasets are filtered.
+inline bool isFiltered( const HDF5Config& h5_config )
+{
+    return h5_config.shuffle || h5_config.deflate_level > 0 ||
+           h5_config.scale_offset_digits >= 0;
+}
+
+// Check that the requested filters can be applied. Called before any HDF5
+// object is created so that nothing is left open when this throws.
+inline void checkFilters( const HDF5Config& h5_config )
+{
+#if !H5_VERSION_GE( 1, 10, 2 )
+    if ( isFiltered( h5_config ) )
+        throw std::runtime_error(
+            "Parallel HDF5 filters require HDF5 1.10.2 or later" );
+#endif
+    if ( h5_config.deflate_level > 0 &&
+         H5Zfilter_avail( H5Z_FILTER_DEFLATE ) <= 0 )
+        throw std::runtime_error( "HDF5 deflate filter not available" );
+}
+
+// Create a time step file and write the simulation time.
+inline hid_t createFile( HDF5Config h5_config, const std::string& filename,
+                         MPI_Comm comm, const double time )
+{
+    checkFilters( h5_config );
+
+    hid_t plist_id = H5Pcreate( H5P_FILE_ACCESS );
+    H5Pset_fapl_mpio( plist_id, comm, MPI_INFO_NULL );
+    H5Pset_libver_bounds( plist_id, H5F_LIBVER_LATEST, H5F_LIBVER_LATEST );
+
+#if H5_VERSION_GE( 1, 10, 1 )
+    if ( h5_config.evict_on_close )
+    {
+        H5Pset_evict_on_close( plist_id, (hbool_t)1 );
+    }
+#endif
+
+#if H5_VERSION_GE( 1, 10, 0 )
+    if ( h5_config.collective )
+    {
+        H5Pset_all_coll_metadata_ops( plist_id, 1 );
+        H5Pset_coll_metadata_write( plist_id, 1 );
+    }
+#endif
+
+    if ( h5_config.align )
+        H5Pset_alignment( plist_id, h5_config.threshold, h5_config.alignment );
+
+    hid_t file_id =
+        H5Fcreate( filename.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, plist_id );
+    H5Pclose( plist_id );
+
+    // Write current simulation time
+    hid_t fspace = H5Screate( H5S_SCALAR );
+    hid_t attr_id = H5Acreate( file_id, "Time", H5T_NATIVE_DOUBLE, fspace,
+                               H5P_DEFAULT, H5P_DEFAULT );
+    H5Awrite( attr_id, H5T_NATIVE_DOUBLE, &time );
+    H5Aclose( attr_id );
+    H5Sclose( fspace );
+
+    return file_id;
+}
+
+//---------------------------------------------------------------------------//
+// Get the offset of the local particles in the global particle list.
+inline hsize_t localOffset( const std::size_t n_local, MPI_Comm comm )
+{
+    int comm_rank;
+    MPI_Comm_rank( comm, &comm_rank );
+    unsigned long long count = n_local;
+    unsigned long long offset = 0;
+    MPI_Exscan( &count, &offset, 1, MPI_UNSIGNED_LONG_LONG, MPI_SUM, comm );
+    return ( 0 == comm_rank ) ? 0 : offset;
+}
+
+// Get the global number of particles.
+inline std::size_t globalCount( const std::size_t n_local, MPI_Comm comm )
+{
+    unsigned long long count = n_local;
+    MPI_Allreduce( MPI_IN_PLACE, &count, 1, MPI_UNSIGNED_LONG_LONG, MPI_SUM,
+                   comm );
+    return count;
+}
+
+// Use the largest number of local particles as the chunk size if chunking
+// without a given chunk size.
+inline void setChunkSize( HDF5Config& h5_config, const std::size_t n_local,
+                          MPI_Comm comm )
+{
+    if ( ( h5_config.chunk || isFiltered( h5_config ) ) &&
+         0 == h5_config.chunk_size )
+    {
+        unsigned long n_max = n_local;
+        MPI_Allreduce( MPI_IN_PLACE, &n_max, 1, MPI_UNSIGNED_LONG, MPI_MAX,
+                       comm );
+        h5_config.chunk_size = n_max;
+    }
+}
+
+// Create the dataset creation property list for a dataset of the given
+// type and global extents.
+inline hid_t createDatasetPlist( const HDF5Config& h5_config, hid_t type_id,
+                                 const int rank, const hsize_t* dimsf )
+{
+    checkFilters( h5_config );
+    hid_t plist_id = H5Pcreate( H5P_DATASET_CREATE );
+    bool filtered = isFiltered( h5_config );
+    if ( !( h5_config.chunk || filtered ) || 0 == dimsf[0] )
+        return plist_id;
+
+    // Chunks of whole particles, within the dataset and the HDF5 chunk size
+    // limit of 4 GB.
+    std::vector<hsize_t> chunk( dimsf, dimsf + rank );
+    hsize_t particle_bytes = H5Tget_size( type_id );
+    for ( int d = 1; d < rank; ++d )
+        particle_bytes *= dimsf[d];
+    hsize_t max_chunk = ( ( hsize_t( 1 ) << 32 ) - 1 ) / particle_bytes;
+    if ( h5_config.chunk_size > 0 && h5_config.chunk_size < chunk[0] )
+        chunk[0] = h5_config.chunk_size;
+    if ( max_chunk > 0 && max_chunk < chunk[0] )
+        chunk[0] = max_chunk;
+    H5Pset_chunk( plist_id, rank, chunk.data() );
+
+    if ( h5_config.scale_offset_digits >= 0 &&
+         H5T_FLOAT == H5Tget_class( type_id ) )
+        H5Pset_scaleoffset( plist_id, H5Z_SO_FLOAT_DSCALE,
+                            h5_config.scale_offset_digits );
+    if ( h5_config.shuffle )
+        H5Pset_shuffle( plist_id );
+    if ( h5_config.deflate_level > 0 )
+        H5Pset_deflate( plist_id, h5_config.deflate_level );
+
+    return plist_id;
+}
+
+// Create the dataset transfer property list.
+inline hid_t createTransferPlist( const HDF5Config& h5_config )
+{
+    hid_t plist_id = H5Pcreate( H5P_DATASET_XFER );
+    // Default IO in HDF5 is independent. Filtered datasets can only be
+    // written collectively.
+    if ( h5_config.collective || isFiltered( h5_config ) )
+        H5Pset_dxpl_mpio( plist_id, H5FD_MPIO_COLLECTIVE );
+    return plist_id;
+}
+
 //---------------------------------------------------------------------------//
 // HDF5 (XDMF) Particle Field Output.
 //---------------------------------------------------------------------------//
 
 // Rank-0 field
-template <class SliceType>
+template <class SelectionType, class SliceType>
 void writeFields(
     HDF5Config h5_config, hid_t file_id, std::size_t n_local,
     std::size_t n_global, hsize_t n_offset, int comm_rank,
     const char* filename_hdf5, const char* filename_xdmf,
-    const SliceType& slice,
+    const SelectionType& selection, const SliceType& slice,
     typename std::enable_if<
         2 == SliceType::kokkos_view::traits::dimension::rank, int*>::type = 0 )
 {
+    using value_type =
+        typename ComputeType<typename SliceType::value_type>::type;
+
     hid_t plist_id;
     hid_t dset_id;
     hid_t filespace_id;
@@ -246,10 +430,9 @@ void writeFields(
     dimsf[0] = n_global;
 
     // Reorder in a contiguous blocked format.
-    Kokkos::View<typename SliceType::value_type*,
-                 typename SliceType::memory_space>
-        view( Kokkos::ViewAllocateWithoutInitializing( "field" ), n_local );
-    copySliceToView( view, slice, 0, n_local );
+    Kokkos::View<value_type*, typename SliceType::memory_space> view(
+        Kokkos::ViewAllocateWithoutInitializing( "field" ), n_local );
+    Impl::copySelectionToView( view, slice, selection );
 
     // Mirror the field to the host.
     auto host_view =
@@ -257,22 +440,20 @@ void writeFields(
 
     std::string dtype;
     uint precision = 0;
-    hid_t type_id =
-        HDF5Traits<typename SliceType::value_type>::type( &dtype, &precision );
+    hid_t type_id = HDF5Traits<value_type>::type( &dtype, &precision );
 
+    hid_t dcpl_id = Impl::createDatasetPlist( h5_config, type_id, 1, dimsf );
     filespace_id = H5Screate_simple( 1, dimsf, NULL );
     dset_id = H5Dcreate( file_id, slice.label().c_str(), type_id, filespace_id,
-                         H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT );
+                         H5P_DEFAULT, dcpl_id, H5P_DEFAULT );
+    H5Pclose( dcpl_id );
 
     H5Sselect_hyperslab( filespace_id, H5S_SELECT_SET, offset, NULL, count,
                          NULL );
 
     memspace_id = H5Screate_simple( 1, count, NULL );
 
-    plist_id = H5Pcreate( H5P_DATASET_XFER );
-    // Default IO in HDF5 is independent
-    if ( h5_config.collective )
-        H5Pset_dxpl_mpio( plist_id, H5FD_MPIO_COLLECTIVE );
+    plist_id = Impl::createTransferPlist( h5_config );
 
     H5Dwrite( dset_id, type_id, memspace_id, filespace_id, plist_id,
               host_view.data() );
@@ -292,26 +473,29 @@ void writeFields(
 }
 
 // Rank-1 field
-template <class SliceType>
+template <class SelectionType, class SliceType>
 void writeFields(
     HDF5Config h5_config, hid_t file_id, std::size_t n_local,
     std::size_t n_global, hsize_t n_offset, int comm_rank,
     const char* filename_hdf5, const char* filename_xdmf,
-    const SliceType& slice,
+    const SelectionType& selection, const SliceType& slice,
     typename std::enable_if<
         3 == SliceType::kokkos_view::traits::dimension::rank, int*>::type = 0 )
 {
+    using value_type =
+        typename ComputeType<typename SliceType::value_type>::type;
+
     hid_t plist_id;
     hid_t dset_id;
     hid_t filespace_id;
     hid_t memspace_id;
 
     // Reorder in a contiguous blocked format.
-    Kokkos::View<typename SliceType::value_type**, Kokkos::LayoutRight,
+    Kokkos::View<value_type**, Kokkos::LayoutRight,
                  typename SliceType::memory_space>
         view( Kokkos::ViewAllocateWithoutInitializing( "field" ), n_local,
               slice.extent( 2 ) );
-    copySliceToView( view, slice, 0, n_local );
+    Impl::copySelectionToView( view, slice, selection );
 
     // Mirror the field to the host.
     auto host_view =
@@ -335,21 +519,19 @@ void writeFields(
 
     std::string dtype;
     uint precision;
-    hid_t type_id =
-        HDF5Traits<typename SliceType::value_type>::type( &dtype, &precision );
+    hid_t type_id = HDF5Traits<value_type>::type( &dtype, &precision );
 
+    hid_t dcpl_id = Impl::createDatasetPlist( h5_config, type_id, 2, dimsf );
     filespace_id = H5Screate_simple( 2, dimsf, NULL );
     dset_id = H5Dcreate( file_id, slice.label().c_str(), type_id, filespace_id,
-                         H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT );
+                         H5P_DEFAULT, dcpl_id, H5P_DEFAULT );
+    H5Pclose( dcpl_id );
 
     H5Sselect_hyperslab( filespace_id, H5S_SELECT_SET, offset, NULL, count,
                          NULL );
 
     memspace_id = H5Screate_simple( 2, dimsm, NULL );
-    plist_id = H5Pcreate( H5P_DATASET_XFER );
-    // Default IO in HDF5 is independent
-    if ( h5_config.collective )
-        H5Pset_dxpl_mpio( plist_id, H5FD_MPIO_COLLECTIVE );
+    plist_id = Impl::createTransferPlist( h5_config );
 
     H5Dwrite( dset_id, type_id, memspace_id, filespace_id, plist_id,
               host_view.data() );
@@ -369,26 +551,29 @@ void writeFields(
 }
 
 // Rank-2 field
-template <class SliceType>
+template <class SelectionType, class SliceType>
 void writeFields(
     HDF5Config h5_config, hid_t file_id, std::size_t n_local,
     std::size_t n_global, hsize_t n_offset, int comm_rank,
     const char* filename_hdf5, const char* filename_xdmf,
-    const SliceType& slice,
+    const SelectionType& selection, const SliceType& slice,
     typename std::enable_if<
         4 == SliceType::kokkos_view::traits::dimension::rank, int*>::type = 0 )
 {
+    using value_type =
+        typename ComputeType<typename SliceType::value_type>::type;
+
     hid_t plist_id;
     hid_t dset_id;
     hid_t filespace_id;
     hid_t memspace_id;
 
     // Reorder in a contiguous blocked format.
-    Kokkos::View<typename SliceType::value_type***, Kokkos::LayoutRight,
+    Kokkos::View<value_type***, Kokkos::LayoutRight,
                  typename SliceType::memory_space>
         view( Kokkos::ViewAllocateWithoutInitializing( "field" ), n_local,
               slice.extent( 2 ), slice.extent( 3 ) );
-    copySliceToView( view, slice, 0, n_local );
+    Impl::copySelectionToView( view, slice, selection );
 
     // Mirror the field to the host.
     auto host_view =
@@ -416,21 +601,19 @@ void writeFields(
 
     std::string dtype;
     uint precision;
-    hid_t type_id =
-        HDF5Traits<typename SliceType::value_type>::type( &dtype, &precision );
+    hid_t type_id = HDF5Traits<value_type>::type( &dtype, &precision );
 
+    hid_t dcpl_id = Impl::createDatasetPlist( h5_config, type_id, 3, dimsf );
     filespace_id = H5Screate_simple( 3, dimsf, NULL );
     dset_id = H5Dcreate( file_id, slice.label().c_str(), type_id, filespace_id,
-                         H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT );
+                         H5P_DEFAULT, dcpl_id, H5P_DEFAULT );
+    H5Pclose( dcpl_id );
 
     H5Sselect_hyperslab( filespace_id, H5S_SELECT_SET, offset, NULL, count,
                          NULL );
 
     memspace_id = H5Screate_simple( 3, dimsm, NULL );
-    plist_id = H5Pcreate( H5P_DATASET_XFER );
-    // Default IO in HDF5 is independent
-    if ( h5_config.collective )
-        H5Pset_dxpl_mpio( plist_id, H5FD_MPIO_COLLECTIVE );
+    plist_id = Impl::createTransferPlist( h5_config );
 
     H5Dwrite( dset_id, type_id, memspace_id, filespace_id, plist_id,
               host_view.data() );
@@ -464,7 +647,8 @@ void writeFields( HDF5Config h5_config, hid_t file_id, std::size_t n_local,
                   const SliceType& slice )
 {
     Impl::writeFields( h5_config, file_id, n_local, n_global, n_offset,
-                       comm_rank, filename_hdf5, filename_xdmf, slice );
+                       comm_rank, filename_hdf5, filename_xdmf,
+                       Impl::ParticleRange{ 0, n_local }, slice );
 }
 
 //! Write particle data to HDF5 output.
@@ -475,30 +659,27 @@ void writeFields( HDF5Config h5_config, hid_t file_id, std::size_t n_local,
                   const SliceType& slice, FieldSliceTypes&&... fields )
 {
     Impl::writeFields( h5_config, file_id, n_local, n_global, n_offset,
-                       comm_rank, filename_hdf5, filename_xdmf, slice );
+                       comm_rank, filename_hdf5, filename_xdmf,
+                       Impl::ParticleRange{ 0, n_local }, slice );
     writeFields( h5_config, file_id, n_local, n_global, n_offset, comm_rank,
                  filename_hdf5, filename_xdmf, fields... );
 }
 
 //---------------------------------------------------------------------------//
-/*!
-  \brief Write particle output in HDF5 format.
-  \param h5_config HDF5 configuration settings.
-  \param prefix Filename prefix.
-  \param comm MPI communicator.
-  \param time_step_index Current simulation step index.
-  \param time Current simulation time.
-  \param n_local Number of local particles.
-  \param coords_slice Particle coordinates.
-  \param fields Variadic list of particle property fields.
-*/
-template <class CoordSliceType, class... FieldSliceTypes>
+//! \cond Impl
+namespace Impl
+{
+// Write the selected particles.
+template <class SelectionType, class CoordSliceType, class... FieldSliceTypes>
 void writeTimeStep( HDF5Config h5_config, const std::string& prefix,
                     MPI_Comm comm, const int time_step_index, const double time,
-                    const std::size_t n_local,
+                    const SelectionType& selection,
                     const CoordSliceType& coords_slice,
                     FieldSliceTypes&&... fields )
 {
+    using value_type =
+        typename ComputeType<typename CoordSliceType::value_type>::type;
+
     Kokkos::Profiling::pushRegion( "Cabana::HDF5ParticleOutput" );
 
     hid_t plist_id;
@@ -514,8 +695,6 @@ void writeTimeStep( HDF5Config h5_config, const std::string& prefix,
 
     int comm_rank;
     MPI_Comm_rank( comm, &comm_rank );
-    int comm_size;
-    MPI_Comm_size( comm, &comm_size );
 
     // Compose a data file name.
     std::stringstream filename_hdf5;
@@ -524,77 +703,25 @@ void writeTimeStep( HDF5Config h5_config, const std::string& prefix,
     std::stringstream filename_xdmf;
     filename_xdmf << prefix << "_" << time_step_index << ".xmf";
 
-    plist_id = H5Pcreate( H5P_FILE_ACCESS );
-    H5Pset_fapl_mpio( plist_id, comm, MPI_INFO_NULL );
-    H5Pset_libver_bounds( plist_id, H5F_LIBVER_LATEST, H5F_LIBVER_LATEST );
-
-#if H5_VERSION_GE( 1, 10, 1 )
-    if ( h5_config.evict_on_close )
-    {
-        H5Pset_evict_on_close( plist_id, (hbool_t)1 );
-    }
-#endif
+    file_id = createFile( h5_config, filename_hdf5.str(), comm, time );
 
-#if H5_VERSION_GE( 1, 10, 0 )
-    if ( h5_config.collective )
-    {
-        H5Pset_all_coll_metadata_ops( plist_id, 1 );
-        H5Pset_coll_metadata_write( plist_id, 1 );
-    }
-#endif
-
-    if ( h5_config.align )
-        H5Pset_alignment( plist_id, h5_config.threshold, h5_config.alignment );
-
-    file_id = H5Fcreate( filename_hdf5.str().c_str(), H5F_ACC_TRUNC,
-                         H5P_DEFAULT, plist_id );
-    H5Pclose( plist_id );
-
-    // Write current simulation time
-    hid_t fspace = H5Screate( H5S_SCALAR );
-    hid_t attr_id = H5Acreate( file_id, "Time", H5T_NATIVE_DOUBLE, fspace,
-                               H5P_DEFAULT, H5P_DEFAULT );
-    H5Awrite( attr_id, H5T_NATIVE_DOUBLE, &time );
-    H5Aclose( attr_id );
-    H5Sclose( fspace );
-
-    // Reorder the coordinates in a blocked format.
-    Kokkos::View<typename CoordSliceType::value_type**, Kokkos::LayoutRight,
+    // Reorder the selected coordinates in a blocked format.
+    std::size_t n_local = selection.size();
+    Kokkos::View<value_type**, Kokkos::LayoutRight,
                  typename CoordSliceType::memory_space>
         coords_view( Kokkos::ViewAllocateWithoutInitializing( "coords" ),
-                     coords_slice.size(), coords_slice.extent( 2 ) );
-    Kokkos::parallel_for(
-        "Cabana::HDF5ParticleOutput::writeCoords",
-        Kokkos::RangePolicy<typename CoordSliceType::execution_space>(
-            0, coords_slice.size() ),
-        KOKKOS_LAMBDA( const int i ) {
-            for ( std::size_t d0 = 0; d0 < coords_slice.extent( 2 ); ++d0 )
-                coords_view( i, d0 ) = coords_slice( i, d0 );
-        } );
+                     n_local, coords_slice.extent( 2 ) );
+    copySelectionToView( coords_view, coords_slice, selection );
 
     // Mirror the coordinates to the host.
     auto host_coords =
         Kokkos::create_mirror_view_and_copy( Kokkos::HostSpace(), coords_view );
 
-    std::vector<int> all_offsets( comm_size );
-    all_offsets[comm_rank] = n_local;
-
-    MPI_Allreduce( MPI_IN_PLACE, all_offsets.data(), comm_size, MPI_INT,
-                   MPI_SUM, comm );
-
-    offset[0] = 0;
+    offset[0] = localOffset( n_local, comm );
     offset[1] = 0;
+    std::size_t n_global = globalCount( n_local, comm );
 
-    size_t n_global = 0;
-    for ( int i = 0; i < comm_size; i++ )
-    {
-        if ( i < comm_rank )
-        {
-            offset[0] += static_cast<hsize_t>( all_offsets[i] );
-        }
-        n_global += (size_t)all_offsets[i];
-    }
-    std::vector<int>().swap( all_offsets );
+    setChunkSize( h5_config, n_local, comm );
 
     dimsf[0] = n_global;
     dimsf[1] = 3;
@@ -606,19 +733,16 @@ void writeTimeStep( HDF5Config h5_config, const std::string& prefix,
 
     memspace_id = H5Screate_simple( 2, count, NULL );
 
-    plist_id = H5Pcreate( H5P_DATASET_XFER );
-
-    // Default IO in HDF5 is independent
-    if ( h5_config.collective )
-        H5Pset_dxpl_mpio( plist_id, H5FD_MPIO_COLLECTIVE );
+    plist_id = createTransferPlist( h5_config );
 
     std::string dtype;
     uint precision;
-    hid_t type_id = HDF5Traits<typename CoordSliceType::value_type>::type(
-        &dtype, &precision );
+    hid_t type_id = HDF5Traits<value_type>::type( &dtype, &precision );
 
+    hid_t dcpl_id = createDatasetPlist( h5_config, type_id, 2, dimsf );
     dset_id = H5Dcreate( file_id, coords_slice.label().c_str(), type_id,
-                         filespace_id, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT );
+                         filespace_id, H5P_DEFAULT, dcpl_id, H5P_DEFAULT );
+    H5Pclose( dcpl_id );
 
     H5Sselect_hyperslab( filespace_id, H5S_SELECT_SET, offset, NULL, count,
                          NULL );
@@ -633,26 +757,510 @@ void writeTimeStep( HDF5Config h5_config, const std::string& prefix,
 
     if ( 0 == comm_rank )
     {
-        Impl::writeXdmfHeader( filename_xdmf.str().c_str(), dimsf[0], dimsf[1],
-                               dtype.c_str(), precision,
-                               filename_hdf5.str().c_str(),
-                               coords_slice.label().c_str() );
+        writeXdmfHeader( filename_xdmf.str().c_str(), dimsf[0], dimsf[1],
+                         dtype.c_str(), precision,
+                         filename_hdf5.str().c_str(),
+                         coords_slice.label().c_str() );
     }
 
     // Add variables.
     hsize_t n_offset = offset[0];
-    writeFields( h5_config, file_id, n_local, n_global, n_offset, comm_rank,
-                 filename_hdf5.str().c_str(), filename_xdmf.str().c_str(),
-                 fields... );
+    ( writeFields( h5_config, file_id, n_local, n_global, n_offset,
+                   comm_rank, filename_hdf5.str().c_str(),
+                   filename_xdmf.str().c_str(), selection, fields ),
+      ... );
 
     H5Fclose( file_id );
 
     if ( 0 == comm_rank )
-        Impl::writeXdmfFooter( filename_xdmf.str().c_str() );
+        writeXdmfFooter( filename_xdmf.str().c_str() );
 
     Kokkos::Profiling::popRegion();
 }
 
+} // namespace Impl
+//! \endcond
+
+//---------------------------------------------------------------------------//
+/*!
+  \brief Write particle output in HDF5 format.
+  \param h5_config HDF5 configuration settings.
+  \param prefix Filename prefix.
+  \param comm MPI communicator.
+  \param time_step_index Current simulation step index.
+  \param time Current simulation time.
+  \param n_local Number of local particles.
+  \param coords_slice Particle coordinates.
+  \param fields Variadic list of particle property fields.
+*/
+template <class CoordSliceType, class... FieldSliceTypes>
+void writeTimeStep( HDF5Config h5_config, const std::string& prefix,
+                    MPI_Comm comm, const int time_step_index, const double time,
+                    const std::size_t n_local,
+                    const CoordSliceType& coords_slice,
+                    FieldSliceTypes&&... fields )
+{
+    Impl::writeTimeStep( h5_config, prefix, comm, time_step_index, time,
+                         Impl::ParticleRange{ 0, n_local }, coords_slice,
+                         fields... );
+}
+
+//---------------------------------------------------------------------------//
+/*!
+  \brief Write a selection of the particles in HDF5 format, e.g. a sample or
+  a spatial region. The selected particles are gathered directly into the
+  output staging buffers.
+  \param h5_config HDF5 configuration settings.
+  \param prefix Filename prefix.
+  \param comm MPI communicator.
+  \param time_step_index Current simulation step index.
+  \param time Current simulation time.
+  \param selection Local particles to write.
+  \param coords_slice Particle coordinates.
+  \param fields Variadic list of particle property fields.
+*/
+template <class MemorySpace, class CoordSliceType, class... FieldSliceTypes>
+void writeTimeStep( HDF5Config h5_config, const std::string& prefix,
+                    MPI_Comm comm, const int time_step_index, const double time,
+                    const ParticleSelection<MemorySpace>& selection,
+                    const CoordSliceType& coords_slice,
+                    FieldSliceTypes&&... fields )
+{
+    Impl::writeTimeStep( h5_config, prefix, comm, time_step_index, time,
+                         selection, coords_slice, fields... );
+}
+
+//---------------------------------------------------------------------------//
+// Asynchronous HDF5 (XDMF) Particle Output.
+//---------------------------------------------------------------------------//
+//! \cond Impl
+namespace Impl
+{
+// Host copy of a field in a contiguous blocked format.
+struct StagedField
+{
+    // Dataset name.
+    std::string label;
+    // Extents of the field per particle.
+    std::vector<hsize_t> extents;
+    // HDF5 and XDMF type of the values.
+    hid_t ( *type )( std::string*, uint* ) = nullptr;
+    // Staged values.
+    Kokkos::View<char*, Kokkos::HostSpace> block;
+};
+
+// Host copy of a time step.
+struct Snapshot
+{
+    std::string prefix;
+    int time_step_index = 0;
+    double time = 0.0;
+    std::size_t n_local = 0;
+    StagedField coords;
+    std::vector<StagedField> fields;
+    // Set by the I/O thread once the files are written.
+    bool done = false;
+};
+
+// Host view over the staged values of a field. Rank-0
+template <class ValueType, class SliceType>
+auto stagingView(
+    void* ptr, const std::size_t n, const SliceType&,
+    typename std::enable_if<
+        2 == SliceType::kokkos_view::traits::dimension::rank, int*>::type = 0 )
+{
+    return Kokkos::View<ValueType*, Kokkos::HostSpace,
+                        Kokkos::MemoryUnmanaged>(
+        static_cast<ValueType*>( ptr ), n );
+}
+
+// Host view over the staged values of a field. Rank-1
+template <class ValueType, class SliceType>
+auto stagingView(
+    void* ptr, const std::size_t n, const SliceType& slice,
+    typename std::enable_if<
+        3 == SliceType::kokkos_view::traits::dimension::rank, int*>::type = 0 )
+{
+    return Kokkos::View<ValueType**, Kokkos::LayoutRight, Kokkos::HostSpace,
+                        Kokkos::MemoryUnmanaged>(
+        static_cast<ValueType*>( ptr ), n, slice.extent( 2 ) );
+}
+
+// Host view over the staged values of a field. Rank-2
+template <class ValueType, class SliceType>
+auto stagingView(
+    void* ptr, const std::size_t n, const SliceType& slice,
+    typename std::enable_if<
+        4 == SliceType::kokkos_view::traits::dimension::rank, int*>::type = 0 )
+{
+    return Kokkos::View<ValueType***, Kokkos::LayoutRight, Kokkos::HostSpace,
+                        Kokkos::MemoryUnmanaged>(
+        static_cast<ValueType*>( ptr ), n, slice.extent( 2 ),
+        slice.extent( 3 ) );
+}
+
+// Copy the first n values of a slice into a host staging block.
+template <class SliceType>
+StagedField stageField( MemoryPool<Kokkos::HostSpace>& pool,
+                        const SliceType& slice, const std::size_t n )
+{
+    using value_type =
+        typename ComputeType<typename SliceType::value_type>::type;
+
+    StagedField field;
+    field.label = slice.label();
+    field.type = &HDF5Traits<value_type>::type;
+    std::size_t num_comp = 1;
+    for ( std::size_t d = 2; d < slice.viewRank(); ++d )
+    {
+        field.extents.push_back( slice.extent( d ) );
+        num_comp *= slice.extent( d );
+    }
+    field.block = pool.acquire( n * num_comp * sizeof( value_type ) );
+
+    // Reorder in a contiguous blocked format in the memory space of the
+    // slice (directly into the staging block for host slices) and copy to
+    // the staging block.
+    auto host_view = stagingView<value_type>( field.block.data(), n, slice );
+    auto view = Kokkos::create_mirror_view(
+        Kokkos::WithoutInitializing, typename SliceType::memory_space(),
+        host_view );
+    copySliceToView( view, slice, 0, n );
+    Kokkos::deep_copy( host_view, view );
+
+    return field;
+}
+
+// Write a staged field and its XDMF entry.
+inline void writeStagedField( HDF5Config h5_config, hid_t file_id,
+                              std::size_t n_local, std::size_t n_global,
+                              hsize_t n_offset, int comm_rank,
+                              const char* filename_hdf5,
+                              const char* filename_xdmf,
+                              const StagedField& field, const bool is_coords )
+{
+    // HDF5 hyperslab parameters
+    int rank = 1 + field.extents.size();
+    std::vector<hsize_t> offset( rank, 0 );
+    std::vector<hsize_t> dimsf( rank );
+    std::vector<hsize_t> count( rank );
+    offset[0] = n_offset;
+    dimsf[0] = n_global;
+    count[0] = n_local;
+    for ( std::size_t d = 0; d < field.extents.size(); ++d )
+    {
+        dimsf[d + 1] = field.extents[d];
+        count[d + 1] = field.extents[d];
+    }
+
+    std::string dtype;
+    uint precision = 0;
+    hid_t type_id = field.type( &dtype, &precision );
+
+    hid_t dcpl_id =
+        createDatasetPlist( h5_config, type_id, rank, dimsf.data() );
+    hid_t filespace_id = H5Screate_simple( rank, dimsf.data(), NULL );
+    hid_t dset_id = H5Dcreate( file_id, field.label.c_str(), type_id,
+                               filespace_id, H5P_DEFAULT, dcpl_id,
+                               H5P_DEFAULT );
+    H5Pclose( dcpl_id );
+
+    H5Sselect_hyperslab( filespace_id, H5S_SELECT_SET, offset.data(), NULL,
+                         count.data(), NULL );
+
+    hid_t memspace_id = H5Screate_simple( rank, count.data(), NULL );
+
+    hid_t plist_id = createTransferPlist( h5_config );
+
+    H5Dwrite( dset_id, type_id, memspace_id, filespace_id, plist_id,
+              field.block.data() );
+
+    H5Pclose( plist_id );
+    H5Sclose( memspace_id );
+    H5Dclose( dset_id );
+    H5Sclose( filespace_id );
+
+    if ( 0 == comm_rank )
+    {
+        hsize_t dims1 = ( rank > 1 ) ? dimsf[1] : 0;
+        hsize_t dims2 = ( rank > 2 ) ? dimsf[2] : 0;
+        if ( is_coords )
+            writeXdmfHeader( filename_xdmf, dimsf[0], dims1, dtype.c_str(),
+                             precision, filename_hdf5, field.label.c_str() );
+        else
+            writeXdmfAttribute( filename_xdmf, field.label.c_str(), dimsf[0],
+                                dims1, dims2, dtype.c_str(), precision,
+                                filename_hdf5, field.label.c_str() );
+    }
+}
+
+// Write the files of a staged time step.
+inline void writeSnapshot( HDF5Config h5_config, MPI_Comm comm,
+                           const Snapshot& snapshot )
+{
+    int comm_rank;
+    MPI_Comm_rank( comm, &comm_rank );
+
+    // Compose a data file name.
+    std::stringstream filename_hdf5;
+    filename_hdf5 << snapshot.prefix << "_" << snapshot.time_step_index
+                  << ".h5";
+
+    std::stringstream filename_xdmf;
+    filename_xdmf << snapshot.prefix << "_" << snapshot.time_step_index
+                  << ".xmf";
+
+    hid_t file_id =
+        createFile( h5_config, filename_hdf5.str(), comm, snapshot.time );
+
+    // Offset of the local particles in the global datasets.
+    std::size_t n_local = snapshot.n_local;
+    hsize_t n_offset = localOffset( n_local, comm );
+    std::size_t n_global = globalCount( n_local, comm );
+    setChunkSize( h5_config, n_local, comm );
+
+    writeStagedField( h5_config, file_id, n_local, n_global, n_offset,
+                      comm_rank, filename_hdf5.str().c_str(),
+                      filename_xdmf.str().c_str(), snapshot.coords, true );
+    for ( auto& field : snapshot.fields )
+        writeStagedField( h5_config, file_id, n_local, n_global, n_offset,
+                          comm_rank, filename_hdf5.str().c_str(),
+                          filename_xdmf.str().c_str(), field, false );
+
+    H5Fclose( file_id );
+
+    if ( 0 == comm_rank )
+        writeXdmfFooter( filename_xdmf.str().c_str() );
+}
+} // namespace Impl
+//! \endcond
+
+//---------------------------------------------------------------------------//
+/*!
+  \brief Asynchronous particle output in HDF5 format.
+
+  write() copies the coordinates and fields of a time step into host staging
+  buffers and returns. The files (identical to those of writeTimeStep()) are
+  then written by a background I/O thread, in the order the time steps were
+  given, while the simulation continues. At most a fixed number of time
+  steps are in flight: write() first waits for the oldest to be written if
+  the limit is reached. Staging buffers are reused between time steps.
+
+  The I/O thread makes collective MPI and HDF5 calls on a duplicate of the
+  communicator, so all ranks must create the writer and call write() in the
+  same order. This requires MPI to be initialized with MPI_THREAD_MULTIPLE;
+  otherwise each time step is written before write() returns. Unless HDF5 is
+  built thread-safe, no other HDF5 calls may be made while time steps are in
+  flight - call wait() first.
+*/
+class AsyncWriter
+{
+  public:
+    /*!
+      \brief Constructor. Collective over the communicator.
+      \param h5_config HDF5 configuration settings.
+      \param comm MPI communicator.
+      \param max_in_flight Maximum number of time steps staged but not yet
+      written. Zero writes synchronously.
+    */
+    AsyncWriter( HDF5Config h5_config, MPI_Comm comm,
+                 const std::size_t max_in_flight = 2 )
+        : _h5_config( h5_config )
+        , _max_in_flight( max_in_flight )
+        , _pool( "Cabana::HDF5ParticleOutput::AsyncWriter" )
+    {
+        MPI_Comm_dup( comm, &_comm );
+
+        int provided;
+        MPI_Query_thread( &provided );
+        if ( MPI_THREAD_MULTIPLE == provided && _max_in_flight > 0 )
+            _thread = std::thread( &AsyncWriter::run, this );
+    }
+
+    //! Destructor. Waits for all time steps to be written. Errors not yet
+    //! reported by write() or wait() are discarded.
+    ~AsyncWriter()
+    {
+        retire( 0 );
+        if ( _thread.joinable() )
+        {
+            {
+                std::lock_guard<std::mutex> lock( _mutex );
+                _stop = true;
+            }
+            _condition.notify_all();
+            _thread.join();
+        }
+        MPI_Comm_free( &_comm );
+    }
+
+    AsyncWriter( const AsyncWriter& ) = delete;
+    AsyncWriter& operator=( const AsyncWriter& ) = delete;
+
+    //! Check if time steps are written by a background thread.
+    bool isAsync() const { return _thread.joinable(); }
+
+    /*!
+      \brief Stage a time step for output. Collective over the communicator.
+      \param prefix Filename prefix.
+      \param time_step_index Current simulation step index.
+      \param time Current simulation time.
+      \param n_local Number of local particles.
+      \param coords_slice Particle coordinates.
+      \param fields Variadic list of particle property fields.
+
+      The slices may be modified as soon as this returns. An error writing
+      an earlier time step in the background is rethrown here.
+    */
+    template <class CoordSliceType, class... FieldSliceTypes>
+    void write( const std::string& prefix, const int time_step_index,
+                const double time, const std::size_t n_local,
+                const CoordSliceType& coords_slice,
+                FieldSliceTypes&&... fields )
+    {
+        Kokkos::Profiling::pushRegion(
+            "Cabana::HDF5ParticleOutput::AsyncWriter::write" );
+
+        // Make room for this time step. Written time steps release their
+        // staging buffers for reuse.
+        retire( ( _max_in_flight > 0 ) ? _max_in_flight - 1 : 0 );
+        if ( auto error = takeError() )
+        {
+            Kokkos::Profiling::popRegion();
+            std::rethrow_exception( error );
+        }
+
+        auto snapshot = std::make_unique<Impl::Snapshot>();
+        snapshot->prefix = prefix;
+        snapshot->time_step_index = time_step_index;
+        snapshot->time = time;
+        snapshot->n_local = n_local;
+        snapshot->coords = Impl::stageField( _pool, coords_slice, n_local );
+        ( snapshot->fields.push_back(
+              Impl::stageField( _pool, fields, n_local ) ),
+          ... );
+        Kokkos::fence();
+
+        if ( isAsync() )
+        {
+            {
+                std::lock_guard<std::mutex> lock( _mutex );
+                _queue.push_back( snapshot.get() );
+                _in_flight.push_back( std::move( snapshot ) );
+            }
+            _condition.notify_all();
+        }
+        else
+        {
+            Impl::writeSnapshot( _h5_config, _comm, *snapshot );
+        }
+
+        Kokkos::Profiling::popRegion();
+    }
+
+    /*!
+      \brief Wait for all staged time steps to be written. An error writing a
+      time step in the background is rethrown here.
+    */
+    void wait()
+    {
+        Kokkos::Profiling::pushRegion(
+            "Cabana::HDF5ParticleOutput::AsyncWriter::wait" );
+        retire( 0 );
+        Kokkos::Profiling::popRegion();
+        if ( auto error = takeError() )
+            std::rethrow_exception( error );
+    }
+
+    //! Get the number of time steps staged but not yet written.
+    std::size_t numInFlight()
+    {
+        std::lock_guard<std::mutex> lock( _mutex );
+        std::size_t count = 0;
+        for ( auto& snapshot : _in_flight )
+            if ( !snapshot->done )
+                ++count;
+        return count;
+    }
+
+  private:
+    // Release written time steps, waiting until at most the given number
+    // remain.
+    void retire( const std::size_t max_remaining )
+    {
+        std::unique_lock<std::mutex> lock( _mutex );
+        while ( !_in_flight.empty() && ( _in_flight.size() > max_remaining ||
+                                         _in_flight.front()->done ) )
+        {
+            _condition.wait( lock, [&] { return _in_flight.front()->done; } );
+            _in_flight.pop_front();
+        }
+    }
+
+    // Take the first error of the I/O thread not yet reported, if any.
+    std::exception_ptr takeError()
+    {
+        std::lock_guard<std::mutex> lock( _mutex );
+        std::exception_ptr error;
+        std::swap( error, _error );
+        return error;
+    }
+
+    // Write staged time steps in order until stopped. Errors are kept for
+    // the calling thread since an exception escaping this thread would
+    // terminate the program.
+    void run()
+    {
+        while ( true )
+        {
+            Impl::Snapshot* snapshot;
+            {
+                std::unique_lock<std::mutex> lock( _mutex );
+                _condition.wait( lock,
+                                 [&] { return _stop || !_queue.empty(); } );
+                if ( _queue.empty() )
+                    return;
+                snapshot = _queue.front();
+                _queue.pop_front();
+            }
+
+            std::exception_ptr error;
+            try
+            {
+                Impl::writeSnapshot( _h5_config, _comm, *snapshot );
+            }
+            catch ( ... )
+            {
+                error = std::current_exception();
+            }
+
+            {
+                std::lock_guard<std::mutex> lock( _mutex );
+                if ( error && !_error )
+                    _error = error;
+                snapshot->done = true;
+            }
+            _condition.notify_all();
+        }
+    }
+
+    HDF5Config _h5_config;
+    MPI_Comm _comm;
+    std::size_t _max_in_flight;
+    MemoryPool<Kokkos::HostSpace> _pool;
+
+    // Staged time steps in order, owned by the calling thread.
+    std::deque<std::unique_ptr<Impl::Snapshot>> _in_flight;
+    // Time steps not yet taken by the I/O thread.
+    std::deque<Impl::Snapshot*> _queue;
+    std::mutex _mutex;
+    std::condition_variable _condition;
+    bool _stop = false;
+    // First error of the I/O thread not yet reported.
+    std::exception_ptr _error;
+    std::thread _thread;
+};
+
 //---------------------------------------------------------------------------//
 // HDF5 (XDMF) Particle Field Input.
 //---------------------------------------------------------------------------//
@@ -664,8 +1272,11 @@ void readField(
     typename std::enable_if<
         2 == SliceType::kokkos_view::traits::dimension::rank, int*>::type = 0 )
 {
+    using value_type =
+        typename ComputeType<typename SliceType::value_type>::type;
+
     // Read the field into a View.
-    Kokkos::View<typename SliceType::value_type*, Kokkos::HostSpace> host_view(
+    Kokkos::View<value_type*, Kokkos::HostSpace> host_view(
         Kokkos::ViewAllocateWithoutInitializing( "field" ), n_local );
     H5Dread( dset_id, dtype_id, memspace_id, filespace_id, plist_id,
              host_view.data() );
@@ -684,9 +1295,11 @@ void readField(
     typename std::enable_if<
         3 == SliceType::kokkos_view::traits::dimension::rank, int*>::type = 0 )
 {
+    using value_type =
+        typename ComputeType<typename SliceType::value_type>::type;
+
     // Read the field into a View.
-    Kokkos::View<typename SliceType::value_type**, Kokkos::LayoutRight,
-                 Kokkos::HostSpace>
+    Kokkos::View<value_type**, Kokkos::LayoutRight, Kokkos::HostSpace>
         host_view( Kokkos::ViewAllocateWithoutInitializing( "field" ), n_local,
                    slice.extent( 2 ) );
     H5Dread( dset_id, dtype_id, memspace_id, filespace_id, plist_id,
@@ -706,9 +1319,11 @@ void readField(
     typename std::enable_if<
         4 == SliceType::kokkos_view::traits::dimension::rank, int*>::type = 0 )
 {
+    using value_type =
+        typename ComputeType<typename SliceType::value_type>::type;
+
     // Read the field into a View.
-    Kokkos::View<typename SliceType::value_type***, Kokkos::LayoutRight,
-                 Kokkos::HostSpace>
+    Kokkos::View<value_type***, Kokkos::LayoutRight, Kokkos::HostSpace>
         host_view( Kokkos::ViewAllocateWithoutInitializing( "field" ), n_local,
                    slice.extent( 2 ), slice.extent( 3 ) );
     H5Dread( dset_id, dtype_id, memspace_id, filespace_id, plist_id,
@@ -721,48 +1336,41 @@ void readField(
 }
 
 //---------------------------------------------------------------------------//
-/*!
-  \brief Read particle output from an HDF5 file.
-  \param h5_config HDF5 configuration settings.
-  \param prefix Filename prefix.
-  \param comm MPI communicator.
-  \param time_step_index Current simulation step index.
-  \param n_local Number of local particles.
-  \param dataset_name Dataset name to read data from.
-  \param time Current simulation time.
-  \param field Particle property field slice.
-*/
-template <class FieldSliceType>
-void readTimeStep( HDF5Config h5_config, const std::string& prefix,
-                   MPI_Comm comm, const int time_step_index,
-                   const std::size_t n_local, const std::string& dataset_name,
-                   double& time, FieldSliceType& field )
+//! \cond Impl
+namespace Impl
 {
-    Kokkos::Profiling::pushRegion( "Cabana::HDF5ParticleInput" );
+// Close an HDF5 object when leaving scope so that handles opened for reading
+// are released when a read throws.
+class ScopedHandle
+{
+  public:
+    ScopedHandle( hid_t id, herr_t ( *close )( hid_t ) )
+        : _id( id )
+        , _close( close )
+    {
+    }
 
-    hid_t plist_id;
-    hid_t dset_id;
-    hid_t file_id;
-    hid_t dtype_id;
-    hid_t filespace_id;
-    hid_t memspace_id;
-    int ndims;
+    ~ScopedHandle()
+    {
+        if ( _id >= 0 )
+            _close( _id );
+    }
 
-    // HDF5 hyperslab parameters
-    hsize_t offset[3] = { 0, 0, 0 };
-    hsize_t dimsf[3] = { 0, 0, 0 };
-    hsize_t count[3] = { 0, 0, 0 };
+    ScopedHandle( const ScopedHandle& ) = delete;
+    ScopedHandle& operator=( const ScopedHandle& ) = delete;
 
-    int comm_rank;
-    MPI_Comm_rank( comm, &comm_rank );
-    int comm_size;
-    MPI_Comm_size( comm, &comm_size );
+    hid_t get() const { return _id; }
 
-    // Retrieve data file name.
-    std::stringstream filename_hdf5;
-    filename_hdf5 << prefix << "_" << time_step_index << ".h5";
+  private:
+    hid_t _id;
+    herr_t ( *_close )( hid_t );
+};
 
-    plist_id = H5Pcreate( H5P_FILE_ACCESS );
+// Open a time step file for reading and read the simulation time.
+inline hid_t openFile( HDF5Config h5_config, const std::string& filename,
+                       MPI_Comm comm, double& time )
+{
+    hid_t plist_id = H5Pcreate( H5P_FILE_ACCESS );
     H5Pset_fapl_mpio( plist_id, comm, MPI_INFO_NULL );
 
 #if H5_VERSION_GE( 1, 10, 0 )
@@ -773,51 +1381,71 @@ void readTimeStep( HDF5Config h5_config, const std::string& prefix,
 #endif
 
     // Open the HDF5 file.
-    file_id = H5Fopen( filename_hdf5.str().c_str(), H5F_ACC_RDONLY, plist_id );
+    hid_t file_id = H5Fopen( filename.c_str(), H5F_ACC_RDONLY, plist_id );
     H5Pclose( plist_id );
+    if ( file_id < 0 )
+        throw std::runtime_error( "Could not open HDF5 file " + filename );
 
     // Get current simulation time associated with time_step_index
     hid_t attr_id = H5Aopen( file_id, "Time", H5P_DEFAULT );
     H5Aread( attr_id, H5T_NATIVE_DOUBLE, &time );
     H5Aclose( attr_id );
 
+    return file_id;
+}
+
+// Compose the file name of a time step.
+inline std::string fileName( const std::string& prefix,
+                             const int time_step_index )
+{
+    std::stringstream filename_hdf5;
+    filename_hdf5 << prefix << "_" << time_step_index << ".h5";
+    return filename_hdf5.str();
+}
+
+// Read the block of a dataset starting at the given particle.
+template <class SliceType>
+void readDataset( HDF5Config h5_config, hid_t file_id,
+                  const std::size_t n_local, const hsize_t n_offset,
+                  const std::string& dataset_name, const SliceType& field )
+{
+    // HDF5 hyperslab parameters
+    hsize_t offset[3] = { 0, 0, 0 };
+    hsize_t dimsf[3] = { 0, 0, 0 };
+    hsize_t count[3] = { 0, 0, 0 };
+
     // Open the dataset.
-    dset_id = H5Dopen( file_id, dataset_name.c_str(), H5P_DEFAULT );
+    hid_t dset_id = H5Dopen( file_id, dataset_name.c_str(), H5P_DEFAULT );
+    if ( dset_id < 0 )
+        throw std::runtime_error( "Could not open HDF5 dataset " +
+                                  dataset_name );
+
+    ScopedHandle dset( dset_id, H5Dclose );
 
     // Get the datatype of the dataset.
-    dtype_id = H5Dget_type( dset_id );
+    hid_t dtype_id = H5Dget_type( dset_id );
+    ScopedHandle dtype( dtype_id, H5Tclose );
 
     // Get the dataspace of the dataset.
-    filespace_id = H5Dget_space( dset_id );
+    hid_t filespace_id = H5Dget_space( dset_id );
+    ScopedHandle filespace( filespace_id, H5Sclose );
 
     // Get the rank of the dataspace.
-    ndims = H5Sget_simple_extent_ndims( filespace_id );
+    int ndims = H5Sget_simple_extent_ndims( filespace_id );
 
     // Get the extents fo the file dataspace.
     H5Sget_simple_extent_dims( filespace_id, dimsf, NULL );
 
-    std::vector<int> all_offsets( comm_size );
-    all_offsets[comm_rank] = n_local;
-
-    MPI_Allreduce( MPI_IN_PLACE, all_offsets.data(), comm_size, MPI_INT,
-                   MPI_SUM, comm );
-
-    for ( int i = 0; i < comm_size; i++ )
-    {
-        if ( i < comm_rank )
-        {
-            offset[0] += static_cast<hsize_t>( all_offsets[i] );
-        }
-    }
-    std::vector<int>().swap( all_offsets );
-
+    offset[0] = n_offset;
     count[0] = n_local;
     count[1] = dimsf[1];
     count[2] = dimsf[2];
 
-    memspace_id = H5Screate_simple( ndims, count, NULL );
+    hid_t memspace_id = H5Screate_simple( ndims, count, NULL );
+    ScopedHandle memspace( memspace_id, H5Sclose );
 
-    plist_id = H5Pcreate( H5P_DATASET_XFER );
+    hid_t plist_id = H5Pcreate( H5P_DATASET_XFER );
+    ScopedHandle plist( plist_id, H5Pclose );
 
     // Default IO in HDF5 is independent
     if ( h5_config.collective )
@@ -828,16 +1456,179 @@ void readTimeStep( HDF5Config h5_config, const std::string& prefix,
 
     readField( dset_id, dtype_id, memspace_id, filespace_id, plist_id, n_local,
                field );
+}
+} // namespace Impl
+//! \endcond
 
-    H5Pclose( plist_id );
-    H5Sclose( memspace_id );
-    H5Sclose( filespace_id );
-    H5Dclose( dset_id );
-    H5Fclose( file_id );
+//---------------------------------------------------------------------------//
+/*!
+  \brief Read particle output from an HDF5 file.
+  \param h5_config HDF5 configuration settings.
+  \param prefix Filename prefix.
+  \param comm MPI communicator.
+  \param time_step_index Current simulation step index.
+  \param n_local Number of local particles.
+  \param dataset_name Dataset name to read data from.
+  \param time Current simulation time.
+  \param field Particle property field slice.
+*/
+template <class FieldSliceType>
+void readTimeStep( HDF5Config h5_config, const std::string& prefix,
+                   MPI_Comm comm, const int time_step_index,
+                   const std::size_t n_local, const std::string& dataset_name,
+                   double& time, FieldSliceType& field )
+{
+    Kokkos::Profiling::pushRegion( "Cabana::HDF5ParticleInput" );
+
+    {
+        auto filename = Impl::fileName( prefix, time_step_index );
+        Impl::ScopedHandle file(
+            Impl::openFile( h5_config, filename, comm, time ), H5Fclose );
+        Impl::readDataset( h5_config, file.get(), n_local,
+                           Impl::localOffset( n_local, comm ), dataset_name,
+                           field );
+    }
 
     Kokkos::Profiling::popRegion();
 }
 
+//---------------------------------------------------------------------------//
+/*!
+  \brief Read several particle fields from an HDF5 file at once.
+  \param h5_config HDF5 configuration settings.
+  \param prefix Filename prefix.
+  \param comm MPI communicator.
+  \param time_step_index Current simulation step index.
+  \param n_local Number of local particles.
+  \param time Current simulation time.
+  \param field Particle property field slice.
+  \param fields Further particle property field slices.
+
+  The file is opened once and each field is read from the dataset named by
+  its slice label. Each rank reads the n_local particles following those of
+  the lower ranks, so the local counts need not match those written (see
+  readNumParticles() and localBlockSize()).
+*/
+template <class FieldSliceType, class... FieldSliceTypes>
+typename std::enable_if<is_slice<FieldSliceType>::value, void>::type
+readTimeStep( HDF5Config h5_config, const std::string& prefix, MPI_Comm comm,
+              const int time_step_index, const std::size_t n_local,
+              double& time, const FieldSliceType& field,
+              const FieldSliceTypes&... fields )
+{
+    Kokkos::Profiling::pushRegion( "Cabana::HDF5ParticleInput" );
+
+    {
+        auto filename = Impl::fileName( prefix, time_step_index );
+        Impl::ScopedHandle file(
+            Impl::openFile( h5_config, filename, comm, time ), H5Fclose );
+        hsize_t n_offset = Impl::localOffset( n_local, comm );
+        Impl::readDataset( h5_config, file.get(), n_local, n_offset,
+                           field.label(), field );
+        ( Impl::readDataset( h5_config, file.get(), n_local, n_offset,
+                             fields.label(), fields ),
+          ... );
+    }
+
+    Kokkos::Profiling::popRegion();
+}
+
+//---------------------------------------------------------------------------//
+/*!
+  \brief Read particle fields from an HDF5 file into a particle list.
+  \param h5_config HDF5 configuration settings.
+  \param prefix Filename prefix.
+  \param comm MPI communicator.
+  \param time_step_index Current simulation step index.
+  \param n_local Number of local particles. The list is resized to this.
+  \param time Current simulation time.
+  \param particles Particle list to read into.
+  \param tag Tag of the first field to read.
+  \param tags Tags of further fields to read. Fields are read from the
+  datasets named by the field labels.
+*/
+template <class MemorySpace, class... FieldTags, class ReadTag,
+          class... ReadTags>
+void readTimeStep( HDF5Config h5_config, const std::string& prefix,
+                   MPI_Comm comm, const int time_step_index,
+                   const std::size_t n_local, double& time,
+                   ParticleList<MemorySpace, FieldTags...>& particles,
+                   ReadTag tag, ReadTags... tags )
+{
+    particles.aosoa().resize( n_local );
+    readTimeStep( h5_config, prefix, comm, time_step_index, n_local, time,
+                  particles.slice( tag ), particles.slice( tags )... );
+}
+
+/*!
+  \brief Read all particle fields from an HDF5 file into a particle list.
+  \param h5_config HDF5 configuration settings.
+  \param prefix Filename prefix.
+  \param comm MPI communicator.
+  \param time_step_index Current simulation step index.
+  \param n_local Number of local particles. The list is resized to this.
+  \param time Current simulation time.
+  \param particles Particle list to read into.
+*/
+template <class MemorySpace, class... FieldTags>
+void readTimeStep( HDF5Config h5_config, const std::string& prefix,
+                   MPI_Comm comm, const int time_step_index,
+                   const std::size_t n_local, double& time,
+                   ParticleList<MemorySpace, FieldTags...>& particles )
+{
+    readTimeStep( h5_config, prefix, comm, time_step_index, n_local, time,
+                  particles, FieldTags()... );
+}
+
+//---------------------------------------------------------------------------//
+/*!
+  \brief Get the number of particles in a dataset of an HDF5 file.
+  \param h5_config HDF5 configuration settings.
+  \param prefix Filename prefix.
+  \param comm MPI communicator.
+  \param time_step_index Simulation step index.
+  \param dataset_name Dataset name.
+*/
+inline std::size_t readNumParticles( HDF5Config h5_config,
+                                     const std::string& prefix, MPI_Comm comm,
+                                     const int time_step_index,
+                                     const std::string& dataset_name )
+{
+    double time;
+    Impl::ScopedHandle file(
+        Impl::openFile( h5_config, Impl::fileName( prefix, time_step_index ),
+                        comm, time ),
+        H5Fclose );
+    hid_t dset_id = H5Dopen( file.get(), dataset_name.c_str(), H5P_DEFAULT );
+    if ( dset_id < 0 )
+        throw std::runtime_error( "Could not open HDF5 dataset " +
+                                  dataset_name );
+    Impl::ScopedHandle dset( dset_id, H5Dclose );
+    Impl::ScopedHandle filespace( H5Dget_space( dset_id ), H5Sclose );
+    hsize_t dimsf[3] = { 0, 0, 0 };
+    H5Sget_simple_extent_dims( filespace.get(), dimsf, NULL );
+    return dimsf[0];
+}
+
+//---------------------------------------------------------------------------//
+/*!
+  \brief Get the number of particles of this rank in an even block split of
+  a global particle list, e.g. to restart on a different number of ranks.
+  \param n_global Global number of particles.
+  \param comm MPI communicator.
+*/
+inline std::size_t localBlockSize( const std::size_t n_global, MPI_Comm comm )
+{
+    int comm_rank;
+    MPI_Comm_rank( comm, &comm_rank );
+    int comm_size;
+    MPI_Comm_size( comm, &comm_size );
+    std::size_t n_local = n_global / comm_size;
+    if ( static_cast<std::size_t>( comm_rank ) < n_global % comm_size )
+        ++n_local;
+    return n_local;
+}
+
 //---------------------------------------------------------------------------//
 
 } // namespace HDF5ParticleOutput
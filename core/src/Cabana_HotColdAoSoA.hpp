@@ -0,0 +1,271 @@
+/****************************************************************************
+ * Copyright (c) 2018-2022 by the Cabana authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the Cabana library. Cabana is distributed under a   *
+ * BSD 3-clause license. For the licensing terms see the LICENSE file in    *
+ * the top-level directory.                                                 *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+/*!
+  \file Cabana_HotColdAoSoA.hpp
+  \brief Particle storage split into frequently and rarely accessed members
+*/
+#ifndef CABANA_HOTCOLDAOSOA_HPP
+#define CABANA_HOTCOLDAOSOA_HPP
+
+#include <Cabana_AoSoA.hpp>
+#include <Cabana_MemberTypes.hpp>
+#include <impl/Cabana_PerformanceTraits.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+namespace Cabana
+{
+//---------------------------------------------------------------------------//
+//! \cond Impl
+template <class, class>
+struct ConcatMemberTypes;
+
+template <typename... HotTypes, typename... ColdTypes>
+struct ConcatMemberTypes<MemberTypes<HotTypes...>, MemberTypes<ColdTypes...>>
+{
+    using type = MemberTypes<HotTypes..., ColdTypes...>;
+};
+//! \endcond
+
+//---------------------------------------------------------------------------//
+/*!
+  \brief Particle container storing hot and cold members in separate AoSoAs.
+
+  \tparam HotTypes Member types accessed in performance critical loops.
+
+  \tparam ColdTypes Remaining member types.
+
+  \tparam DeviceType The device type.
+
+  \tparam VectorLength The vector length of both AoSoAs.
+
+  The container behaves as a single AoSoA with the hot members followed by
+  the cold members: member M of the container is hot member M if M is less
+  than the number of hot members and cold member M minus that number
+  otherwise. Kernels that only use the hot members stream only the hot
+  AoSoA. Both AoSoAs always have the same size so particle indices are
+  shared; resizing, permuting (sort), migrating and deep copying the
+  container apply to both.
+*/
+template <class HotTypes, class ColdTypes, class DeviceType,
+          int VectorLength = Impl::PerformanceTraits<
+              typename DeviceType::execution_space>::vector_length>
+class HotColdAoSoA
+{
+  public:
+    //! Hot member AoSoA type.
+    using hot_aosoa_type = AoSoA<HotTypes, DeviceType, VectorLength>;
+
+    //! Cold member AoSoA type.
+    using cold_aosoa_type = AoSoA<ColdTypes, DeviceType, VectorLength>;
+
+    //! Member types of the full particle.
+    using member_types = typename ConcatMemberTypes<HotTypes, ColdTypes>::type;
+
+    //! Device type.
+    using device_type = DeviceType;
+
+    //! Memory space.
+    using memory_space = typename hot_aosoa_type::memory_space;
+
+    //! Execution space.
+    using execution_space = typename hot_aosoa_type::execution_space;
+
+    //! Size type.
+    using size_type = typename hot_aosoa_type::size_type;
+
+    //! Vector length.
+    static constexpr int vector_length = VectorLength;
+
+    //! Number of hot members.
+    static constexpr std::size_t number_of_hot_members = HotTypes::size;
+
+    //! Total number of members.
+    static constexpr std::size_t number_of_members = member_types::size;
+
+    /*!
+      \brief Default constructor.
+
+      \param label An optional label for the data structure.
+    */
+    HotColdAoSoA( const std::string& label = "" )
+        : _hot( label + "_hot" )
+        , _cold( label + "_cold" )
+    {
+    }
+
+    /*!
+      \brief Allocate a container with n particles.
+
+      \param label A label for the data structure.
+
+      \param n The number of particles in the container.
+    */
+    HotColdAoSoA( const std::string& label, const size_type n )
+        : _hot( label + "_hot", n )
+        , _cold( label + "_cold", n )
+    {
+    }
+
+    /*!
+      \brief Create a container from existing hot and cold AoSoAs.
+
+      \param hot The hot member AoSoA.
+
+      \param cold The cold member AoSoA. Must have the same size.
+    */
+    HotColdAoSoA( const hot_aosoa_type& hot, const cold_aosoa_type& cold )
+        : _hot( hot )
+        , _cold( cold )
+    {
+        if ( _hot.size() != _cold.size() )
+            throw std::runtime_error(
+                "Hot and cold AoSoAs must have the same size" );
+    }
+
+    //! Get the hot member AoSoA.
+    hot_aosoa_type& hot() { return _hot; }
+
+    //! Get the hot member AoSoA (const).
+    const hot_aosoa_type& hot() const { return _hot; }
+
+    //! Get the cold member AoSoA.
+    cold_aosoa_type& cold() { return _cold; }
+
+    //! Get the cold member AoSoA (const).
+    const cold_aosoa_type& cold() const { return _cold; }
+
+    //! Get the number of particles.
+    KOKKOS_FUNCTION
+    size_type size() const { return _hot.size(); }
+
+    //! Check if the container is empty.
+    KOKKOS_FUNCTION
+    bool empty() const { return _hot.empty(); }
+
+    //! Get the number of particles that fit without reallocation.
+    KOKKOS_FUNCTION
+    size_type capacity() const
+    {
+        return ( _hot.capacity() < _cold.capacity() ) ? _hot.capacity()
+                                                      : _cold.capacity();
+    }
+
+    //! Resize both AoSoAs to n particles.
+    void resize( const size_type n )
+    {
+        _hot.resize( n );
+        _cold.resize( n );
+    }
+
+    //! Reserve storage for n particles in both AoSoAs.
+    void reserve( const size_type n )
+    {
+        _hot.reserve( n );
+        _cold.reserve( n );
+    }
+
+    //! Remove unused capacity from both AoSoAs.
+    void shrinkToFit()
+    {
+        _hot.shrinkToFit();
+        _cold.shrinkToFit();
+    }
+
+  private:
+    hot_aosoa_type _hot;
+    cold_aosoa_type _cold;
+};
+
+//---------------------------------------------------------------------------//
+//! \cond Impl
+template <class>
+struct is_hot_cold_aosoa_impl : public std::false_type
+{
+};
+
+template <class HotTypes, class ColdTypes, class DeviceType, int VectorLength>
+struct is_hot_cold_aosoa_impl<
+    HotColdAoSoA<HotTypes, ColdTypes, DeviceType, VectorLength>>
+    : public std::true_type
+{
+};
+//! \endcond
+
+//! HotColdAoSoA static type checker.
+template <class T>
+struct is_hot_cold_aosoa
+    : public is_hot_cold_aosoa_impl<typename std::remove_cv<T>::type>::type
+{
+};
+
+//---------------------------------------------------------------------------//
+//! \cond Impl
+namespace Impl
+{
+// Select the hot or cold AoSoA holding member M.
+template <std::size_t M, bool IsHot>
+struct HotColdMember;
+
+template <std::size_t M>
+struct HotColdMember<M, true>
+{
+    template <class HotColdType>
+    static auto slice( const HotColdType& aosoa, const std::string& label )
+    {
+        return Cabana::slice<M>( aosoa.hot(), label );
+    }
+};
+
+template <std::size_t M>
+struct HotColdMember<M, false>
+{
+    template <class HotColdType>
+    static auto slice( const HotColdType& aosoa, const std::string& label )
+    {
+        return Cabana::slice<M - HotColdType::number_of_hot_members>(
+            aosoa.cold(), label );
+    }
+};
+} // namespace Impl
+//! \endcond
+
+/*!
+  \brief Create a slice of a member of a HotColdAoSoA.
+
+  \tparam M Member index in the full particle (hot members first).
+
+  \param aosoa The container to slice from.
+
+  \param slice_label Optional slice label.
+*/
+template <std::size_t M, class HotTypes, class ColdTypes, class DeviceType,
+          int VectorLength>
+auto slice(
+    const HotColdAoSoA<HotTypes, ColdTypes, DeviceType, VectorLength>& aosoa,
+    const std::string& slice_label = "" )
+{
+    static_assert( M < HotTypes::size + ColdTypes::size,
+                   "Member index out of range" );
+    return Impl::HotColdMember<M, ( M < HotTypes::size )>::slice(
+        aosoa, slice_label );
+}
+
+//---------------------------------------------------------------------------//
+
+} // end namespace Cabana
+
+#endif // end CABANA_HOTCOLDAOSOA_HPP
@@ -0,0 +1,388 @@
+/****************************************************************************
+ * Copyright (c) 2018-2022 by the Cabana authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the Cabana library. Cabana is distributed under a   *
+ * BSD 3-clause license. For the licensing terms see the LICENSE file in    *
+ * the top-level directory.                                                 *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+/*!
+  \file Cabana_KNearestNeighborList.hpp
+  \brief k-nearest neighbor list built with a linked cell list
+*/
+#ifndef CABANA_KNEARESTNEIGHBORLIST_HPP
+#define CABANA_KNEARESTNEIGHBORLIST_HPP
+
+#include <Cabana_LinkedCellList.hpp>
+#include <Cabana_NeighborList.hpp>
+#include <Cabana_Slice.hpp>
+#include <Cabana_Types.hpp>
+#include <impl/Cabana_CartesianGrid.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <cassert>
+#include <type_traits>
+
+namespace Cabana
+{
+namespace Impl
+{
+//! \cond Impl
+
+//---------------------------------------------------------------------------//
+// Bounded max-heap of neighbor candidates stored in one row of the dense
+// neighbor and distance arrays. The root holds the farthest candidate.
+template <class NeighborView, class DistanceView>
+struct KNearestHeap
+{
+    NeighborView neighbors;
+    DistanceView distances;
+    int row;
+    int capacity;
+    int size;
+
+    KOKKOS_INLINE_FUNCTION
+    KNearestHeap( const NeighborView& n, const DistanceView& d, const int r,
+                  const int k )
+        : neighbors( n )
+        , distances( d )
+        , row( r )
+        , capacity( k )
+        , size( 0 )
+    {
+    }
+
+    KOKKOS_INLINE_FUNCTION
+    bool full() const { return size == capacity; }
+
+    KOKKOS_INLINE_FUNCTION
+    double maxDistance() const { return distances( row, 0 ); }
+
+    // Move an entry down from the given position in the heap [0,end).
+    KOKKOS_INLINE_FUNCTION
+    void siftDown( int pos, const int end, const int nid, const double dist )
+    {
+        int child = 2 * pos + 1;
+        while ( child < end )
+        {
+            if ( child + 1 < end &&
+                 distances( row, child + 1 ) > distances( row, child ) )
+                ++child;
+            if ( distances( row, child ) <= dist )
+                break;
+            neighbors( row, pos ) = neighbors( row, child );
+            distances( row, pos ) = distances( row, child );
+            pos = child;
+            child = 2 * pos + 1;
+        }
+        neighbors( row, pos ) = nid;
+        distances( row, pos ) = dist;
+    }
+
+    // Insert a candidate, replacing the farthest candidate when full.
+    KOKKOS_INLINE_FUNCTION
+    void insert( const int nid, const double dist )
+    {
+        if ( size < capacity )
+        {
+            int pos = size++;
+            while ( pos > 0 )
+            {
+                int parent = ( pos - 1 ) / 2;
+                if ( distances( row, parent ) >= dist )
+                    break;
+                neighbors( row, pos ) = neighbors( row, parent );
+                distances( row, pos ) = distances( row, parent );
+                pos = parent;
+            }
+            neighbors( row, pos ) = nid;
+            distances( row, pos ) = dist;
+        }
+        else if ( dist < maxDistance() )
+        {
+            siftDown( 0, size, nid, dist );
+        }
+    }
+
+    // Sort the heap in place by increasing distance.
+    KOKKOS_INLINE_FUNCTION
+    void sort()
+    {
+        for ( int end = size - 1; end > 0; --end )
+        {
+            int nid = neighbors( row, end );
+            double dist = distances( row, end );
+            neighbors( row, end ) = neighbors( row, 0 );
+            distances( row, end ) = distances( row, 0 );
+            siftDown( 0, end, nid, dist );
+        }
+    }
+};
+
+//! \endcond
+} // end namespace Impl
+
+//---------------------------------------------------------------------------//
+/*!
+  \brief k-nearest neighbor list built by expanding shells of cells in a
+  linked cell list.
+
+  \tparam MemorySpace The Kokkos memory space for storing the neighbor list.
+
+  Each particle stores up to k neighbors in a dense 2D layout, ordered by
+  increasing distance. Fewer than k neighbors are stored only if fewer than
+  k other particles exist.
+*/
+template <class MemorySpace>
+class KNearestNeighborList
+{
+  public:
+    static_assert( Kokkos::is_memory_space<MemorySpace>::value, "" );
+
+    //! Kokkos memory space in which the neighbor list data resides.
+    using memory_space = MemorySpace;
+
+    //! Kokkos default execution space for this memory space.
+    using execution_space = typename memory_space::execution_space;
+
+    //! Number of neighbors per particle.
+    Kokkos::View<int*, memory_space> counts;
+
+    //! Neighbor list.
+    Kokkos::View<int**, memory_space> neighbors;
+
+    //! Squared distance to each neighbor.
+    Kokkos::View<double**, memory_space> distances;
+
+    /*!
+      \brief Default constructor.
+    */
+    KNearestNeighborList() {}
+
+    /*!
+      \brief KNearestNeighborList constructor. Given a list of particle
+      positions calculate the k nearest neighbors of each particle.
+
+      \param x The slice containing the particle positions.
+
+      \param begin The beginning particle index to compute neighbors for.
+
+      \param end The end particle index to compute neighbors for.
+
+      \param k The number of neighbors to find for each particle.
+
+      \param grid_delta Grid cell size in each dimension. Cells containing on
+      the order of k particles give the best performance.
+
+      \param grid_min The minimum value of the grid containing the particles
+      in each dimension.
+
+      \param grid_max The maximum value of the grid containing the particles
+      in each dimension.
+
+      All particles are candidates for being a neighbor, regardless of
+      whether or not they are in the range.
+    */
+    template <class PositionSlice>
+    KNearestNeighborList(
+        PositionSlice x, const std::size_t begin, const std::size_t end,
+        const int k, const typename PositionSlice::value_type grid_delta[3],
+        const typename PositionSlice::value_type grid_min[3],
+        const typename PositionSlice::value_type grid_max[3],
+        typename std::enable_if<( is_slice<PositionSlice>::value ),
+                                int>::type* = 0 )
+    {
+        build( x, begin, end, k, grid_delta, grid_min, grid_max );
+    }
+
+    /*!
+      \brief Given a list of particle positions calculate the k nearest
+      neighbors of each particle.
+    */
+    template <class PositionSlice>
+    void build( PositionSlice x, const std::size_t begin,
+                const std::size_t end, const int k,
+                const typename PositionSlice::value_type grid_delta[3],
+                const typename PositionSlice::value_type grid_min[3],
+                const typename PositionSlice::value_type grid_max[3] )
+    {
+        // Use the default execution space.
+        build( execution_space{}, x, begin, end, k, grid_delta, grid_min,
+               grid_max );
+    }
+
+    /*!
+      \brief Given a list of particle positions calculate the k nearest
+      neighbors of each particle.
+    */
+    template <class PositionSlice, class ExecutionSpace>
+    void build( ExecutionSpace, PositionSlice x, const std::size_t begin,
+                const std::size_t end, const int k,
+                const typename PositionSlice::value_type grid_delta[3],
+                const typename PositionSlice::value_type grid_min[3],
+                const typename PositionSlice::value_type grid_max[3] )
+    {
+        Kokkos::Profiling::pushRegion( "Cabana::KNearestNeighborList::build" );
+
+        static_assert( is_accessible_from<memory_space, ExecutionSpace>{}, "" );
+
+        assert( end >= begin );
+        assert( end <= x.size() );
+        assert( k > 0 );
+
+        using device_type = Kokkos::Device<ExecutionSpace, memory_space>;
+
+        // Bin all particles as candidates.
+        LinkedCellList<device_type> linked_cell_list( x, grid_delta, grid_min,
+                                                      grid_max );
+        Impl::CartesianGrid<double> grid( grid_min[0], grid_min[1],
+                                          grid_min[2], grid_max[0],
+                                          grid_max[1], grid_max[2],
+                                          grid_delta[0], grid_delta[1],
+                                          grid_delta[2] );
+
+        // Particles in cells outside of shell s are at least this far times
+        // s from a particle in the center cell.
+        double min_delta = grid._dx;
+        min_delta = ( grid._dy < min_delta ) ? grid._dy : min_delta;
+        min_delta = ( grid._dz < min_delta ) ? grid._dz : min_delta;
+        int max_shell = grid._nx;
+        max_shell = ( grid._ny > max_shell ) ? grid._ny : max_shell;
+        max_shell = ( grid._nz > max_shell ) ? grid._nz : max_shell;
+
+        counts = Kokkos::View<int*, memory_space>( "num_neighbors", x.size() );
+        neighbors = Kokkos::View<int**, memory_space>(
+            Kokkos::ViewAllocateWithoutInitializing( "neighbors" ), x.size(),
+            k );
+        distances = Kokkos::View<double**, memory_space>(
+            Kokkos::ViewAllocateWithoutInitializing( "neighbor_distances" ),
+            x.size(), k );
+
+        auto neighbors_view = neighbors;
+        auto distances_view = distances;
+        auto counts_view = counts;
+        auto search_op = KOKKOS_LAMBDA( const int pid )
+        {
+            Impl::KNearestHeap<decltype( neighbors_view ),
+                               decltype( distances_view )>
+                heap( neighbors_view, distances_view, pid, k );
+
+            double x_p = x( pid, 0 );
+            double y_p = x( pid, 1 );
+            double z_p = x( pid, 2 );
+            int ic, jc, kc;
+            grid.locatePoint( x_p, y_p, z_p, ic, jc, kc );
+
+            // Expand shells of cells around the particle cell until the
+            // heap is full and no unvisited cell can contain a closer
+            // particle.
+            for ( int s = 0; s <= max_shell; ++s )
+            {
+                for ( int i = ic - s; i <= ic + s; ++i )
+                {
+                    if ( i < 0 || i >= grid._nx )
+                        continue;
+                    for ( int j = jc - s; j <= jc + s; ++j )
+                    {
+                        if ( j < 0 || j >= grid._ny )
+                            continue;
+
+                        // Interior (i,j) columns only touch the shell at
+                        // the two k faces.
+                        bool on_face = ( i == ic - s || i == ic + s ||
+                                         j == jc - s || j == jc + s );
+                        int k_step = on_face ? 1 : 2 * s;
+                        for ( int kk = kc - s; kk <= kc + s; kk += k_step )
+                        {
+                            if ( kk < 0 || kk >= grid._nz )
+                                continue;
+                            if ( heap.full() &&
+                                 grid.minDistanceToPoint( x_p, y_p, z_p, i, j,
+                                                          kk ) >=
+                                     heap.maxDistance() )
+                                continue;
+
+                            std::size_t n_offset =
+                                linked_cell_list.binOffset( i, j, kk );
+                            int num_n = linked_cell_list.binSize( i, j, kk );
+                            for ( int n = 0; n < num_n; ++n )
+                            {
+                                int nid = linked_cell_list.permutation(
+                                    n_offset + n );
+                                if ( nid == pid )
+                                    continue;
+                                double dx = x_p - x( nid, 0 );
+                                double dy = y_p - x( nid, 1 );
+                                double dz = z_p - x( nid, 2 );
+                                heap.insert( nid, dx * dx + dy * dy + dz * dz );
+                            }
+                        }
+                    }
+                }
+
+                double shell_dist = s * min_delta;
+                if ( heap.full() &&
+                     heap.maxDistance() <= shell_dist * shell_dist )
+                    break;
+            }
+
+            heap.sort();
+            counts_view( pid ) = heap.size;
+        };
+        Kokkos::RangePolicy<ExecutionSpace> policy( begin, end );
+        Kokkos::parallel_for( "Cabana::KNearestNeighborList::search", policy,
+                              search_op );
+        Kokkos::fence();
+
+        Kokkos::Profiling::popRegion();
+    }
+};
+
+//---------------------------------------------------------------------------//
+// Neighbor list interface implementation.
+//---------------------------------------------------------------------------//
+//! k-nearest NeighborList interface.
+template <class MemorySpace>
+class NeighborList<KNearestNeighborList<MemorySpace>>
+{
+  public:
+    //! Kokkos memory space.
+    using memory_space = MemorySpace;
+    //! Neighbor list type.
+    using list_type = KNearestNeighborList<MemorySpace>;
+
+    //! Get the maximum number of neighbors per particle.
+    KOKKOS_INLINE_FUNCTION
+    static std::size_t maxNeighbor( const list_type& list )
+    {
+        return list.neighbors.extent( 1 );
+    }
+
+    //! Get the number of neighbors for a given particle index.
+    KOKKOS_INLINE_FUNCTION
+    static std::size_t numNeighbor( const list_type& list,
+                                    const std::size_t particle_index )
+    {
+        return list.counts( particle_index );
+    }
+
+    //! Get the id for a neighbor for a given particle index and the index of
+    //! the neighbor relative to the particle.
+    KOKKOS_INLINE_FUNCTION
+    static std::size_t getNeighbor( const list_type& list,
+                                    const std::size_t particle_index,
+                                    const std::size_t neighbor_index )
+    {
+        return list.neighbors( particle_index, neighbor_index );
+    }
+};
+
+//---------------------------------------------------------------------------//
+
+} // end namespace Cabana
+
+#endif // end CABANA_KNEARESTNEIGHBORLIST_HPP
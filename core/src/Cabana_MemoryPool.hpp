@@ -0,0 +1,177 @@
+/****************************************************************************
+ * Copyright (c) 2018-2022 by the Cabana authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the Cabana library. Cabana is distributed under a   *
+ * BSD 3-clause license. For the licensing terms see the LICENSE file in    *
+ * the top-level directory.                                                 *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+/*!
+  \file Cabana_MemoryPool.hpp
+  \brief Pool of reusable allocations for particle and buffer storage
+*/
+#ifndef CABANA_MEMORYPOOL_HPP
+#define CABANA_MEMORYPOOL_HPP
+
+#include <impl/Cabana_FirstTouch.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace Cabana
+{
+//---------------------------------------------------------------------------//
+/*!
+  \brief Host-managed pool of memory blocks reused between allocations.
+
+  \tparam MemorySpace The Kokkos memory space of the blocks.
+
+  Blocks handed out by the pool are reference counted Kokkos views. A block
+  is returned to the pool when the pool holds the only remaining reference
+  to it, i.e. when every container using it has been reallocated or
+  destroyed. Freed blocks are handed out again for any request that fits,
+  so repeated growth and shrinkage of containers and communication buffers
+  does not allocate new memory once the pool is warm.
+
+  The pool must outlive the containers using it. It is not thread safe and
+  must only be used from the host.
+*/
+template <class MemorySpace>
+class MemoryPool
+{
+  public:
+    static_assert( Kokkos::is_memory_space<MemorySpace>::value, "" );
+
+    //! Kokkos memory space.
+    using memory_space = MemorySpace;
+
+    //! Memory block type.
+    using block_type = Kokkos::View<char*, memory_space>;
+
+    /*!
+      \brief Constructor.
+
+      \param label Label for the allocated blocks.
+    */
+    MemoryPool( const std::string& label = "Cabana::MemoryPool" )
+        : _label( label )
+    {
+    }
+
+    /*!
+      \brief Get a block of at least the given size.
+
+      The smallest free block that fits is reused. A new block is allocated
+      if none fits.
+
+      \param bytes The requested block size in bytes.
+
+      \return The block. Empty if zero bytes were requested.
+    */
+    block_type acquire( const std::size_t bytes )
+    {
+        if ( 0 == bytes )
+            return block_type();
+
+        std::size_t best = _blocks.size();
+        for ( std::size_t b = 0; b < _blocks.size(); ++b )
+        {
+            if ( isFree( b ) && _blocks[b].extent( 0 ) >= bytes &&
+                 ( best == _blocks.size() ||
+                   _blocks[b].extent( 0 ) < _blocks[best].extent( 0 ) ) )
+                best = b;
+        }
+
+        if ( best == _blocks.size() )
+        {
+            block_type block( Kokkos::ViewAllocateWithoutInitializing( _label ),
+                              bytes );
+            if ( _huge_pages )
+                Impl::adviseHugePages( memory_space(), block.data(), bytes );
+            if ( _first_touch )
+                Impl::firstTouch( typename memory_space::execution_space(),
+                                  memory_space(), block.data(), bytes );
+            _blocks.push_back( block );
+        }
+        return _blocks[best];
+    }
+
+    /*!
+      \brief Touch new blocks in parallel when they are allocated.
+
+      Host blocks are then placed across NUMA domains following a static
+      RangePolicy over the block in the default execution space of the
+      memory space, rather than on the domain of the thread that first
+      writes them. Blocks already in the pool are not affected.
+    */
+    void setFirstTouch( const bool first_touch ) { _first_touch = first_touch; }
+
+    //! Check if new blocks are touched in parallel.
+    bool firstTouch() const { return _first_touch; }
+
+    /*!
+      \brief Request transparent huge pages for new host blocks.
+
+      Only has an effect on Linux host memory with transparent huge pages
+      enabled in madvise mode. Blocks already in the pool are not affected.
+    */
+    void setHugePages( const bool huge_pages ) { _huge_pages = huge_pages; }
+
+    //! Check if huge pages are requested for new blocks.
+    bool hugePages() const { return _huge_pages; }
+
+    //! Free all blocks not currently in use.
+    void release()
+    {
+        std::vector<block_type> in_use;
+        for ( std::size_t b = 0; b < _blocks.size(); ++b )
+            if ( !isFree( b ) )
+                in_use.push_back( _blocks[b] );
+        _blocks.swap( in_use );
+    }
+
+    //! Get the number of blocks owned by the pool.
+    std::size_t numBlocks() const { return _blocks.size(); }
+
+    //! Get the number of blocks currently in use.
+    std::size_t numBlocksInUse() const
+    {
+        std::size_t count = 0;
+        for ( std::size_t b = 0; b < _blocks.size(); ++b )
+            if ( !isFree( b ) )
+                ++count;
+        return count;
+    }
+
+    //! Get the total number of bytes owned by the pool.
+    std::size_t allocatedBytes() const
+    {
+        std::size_t bytes = 0;
+        for ( std::size_t b = 0; b < _blocks.size(); ++b )
+            bytes += _blocks[b].extent( 0 );
+        return bytes;
+    }
+
+  private:
+    bool isFree( const std::size_t b ) const
+    {
+        return 1 == _blocks[b].use_count();
+    }
+
+    std::string _label;
+    std::vector<block_type> _blocks;
+    bool _first_touch = false;
+    bool _huge_pages = false;
+};
+
+//---------------------------------------------------------------------------//
+
+} // end namespace Cabana
+
+#endif // end CABANA_MEMORYPOOL_HPP
@@ -0,0 +1,194 @@
+/****************************************************************************
+ * Copyright (c) 2018-2022 by the Cabana authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the Cabana library. Cabana is distributed under a   *
+ * BSD 3-clause license. For the licensing terms see the LICENSE file in    *
+ * the top-level directory.                                                 *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+/*!
+  \file Cabana_MixedPrecision.hpp
+  \brief Reduced precision storage types for particle members
+*/
+#ifndef CABANA_MIXEDPRECISION_HPP
+#define CABANA_MIXEDPRECISION_HPP
+
+#include <Kokkos_Core.hpp>
+
+#include <cstdint>
+#include <type_traits>
+
+namespace Cabana
+{
+//---------------------------------------------------------------------------//
+/*!
+  \brief Fixed point storage of a floating point value.
+
+  \tparam IntType The signed integer type holding the stored value.
+
+  \tparam FractionalBits The number of bits after the binary point.
+
+  A value x is stored as the integer nearest to x * 2^FractionalBits,
+  saturated to the range of IntType. The type converts implicitly to and
+  from the compute type (double) so it can be used as a member type (or the
+  value type of an array member) in MemberTypes: slice access, tuple access
+  and compound assignment read and write compute precision values while the
+  AoSoA only stores sizeof(IntType) bytes per value. For example
+  FixedPoint<std::int16_t, 8> covers (-128, 128) with a resolution of 2^-8
+  in a quarter of the memory of a double.
+*/
+template <class IntType, int FractionalBits>
+struct FixedPoint
+{
+    static_assert( std::is_integral<IntType>::value &&
+                       std::is_signed<IntType>::value,
+                   "FixedPoint requires a signed integer storage type" );
+    static_assert( FractionalBits >= 0 &&
+                       FractionalBits < 8 * int( sizeof( IntType ) ) - 1,
+                   "Invalid number of fractional bits" );
+
+    //! Storage type.
+    using storage_type = IntType;
+
+    //! Compute type.
+    using compute_type = double;
+
+    //! Stored integer value.
+    storage_type value;
+
+    //! Default constructor. The value is uninitialized.
+    FixedPoint() = default;
+
+    //! Construct from a compute precision value.
+    KOKKOS_INLINE_FUNCTION
+    FixedPoint( const compute_type x )
+        : value( encode( x ) )
+    {
+    }
+
+    //! Convert to compute precision.
+    KOKKOS_INLINE_FUNCTION
+    operator compute_type() const { return value / scale(); }
+
+    //! Add a compute precision value.
+    KOKKOS_INLINE_FUNCTION
+    FixedPoint& operator+=( const compute_type x )
+    {
+        value = encode( compute_type( *this ) + x );
+        return *this;
+    }
+
+    //! Subtract a compute precision value.
+    KOKKOS_INLINE_FUNCTION
+    FixedPoint& operator-=( const compute_type x )
+    {
+        value = encode( compute_type( *this ) - x );
+        return *this;
+    }
+
+    //! Multiply by a compute precision value.
+    KOKKOS_INLINE_FUNCTION
+    FixedPoint& operator*=( const compute_type x )
+    {
+        value = encode( compute_type( *this ) * x );
+        return *this;
+    }
+
+    //! Divide by a compute precision value.
+    KOKKOS_INLINE_FUNCTION
+    FixedPoint& operator/=( const compute_type x )
+    {
+        value = encode( compute_type( *this ) / x );
+        return *this;
+    }
+
+    //! Smallest representable difference between two values.
+    KOKKOS_INLINE_FUNCTION
+    static constexpr compute_type resolution() { return 1.0 / scale(); }
+
+    //! Largest representable value.
+    KOKKOS_INLINE_FUNCTION
+    static constexpr compute_type max() { return maxStored() / scale(); }
+
+    //! Smallest representable value.
+    KOKKOS_INLINE_FUNCTION
+    static constexpr compute_type lowest() { return -maxStored() / scale(); }
+
+  private:
+    KOKKOS_INLINE_FUNCTION
+    static constexpr compute_type scale()
+    {
+        return static_cast<compute_type>( std::uint64_t( 1 )
+                                          << FractionalBits );
+    }
+
+    KOKKOS_INLINE_FUNCTION
+    static constexpr compute_type maxStored()
+    {
+        return static_cast<compute_type>(
+            ( std::uint64_t( 1 ) << ( 8 * sizeof( IntType ) - 1 ) ) - 1 );
+    }
+
+    KOKKOS_INLINE_FUNCTION
+    static storage_type encode( const compute_type x )
+    {
+        compute_type s = x * scale();
+        if ( s > maxStored() )
+            s = maxStored();
+        if ( s < -maxStored() )
+            s = -maxStored();
+        return static_cast<storage_type>( ( s < 0.0 ) ? s - 0.5 : s + 0.5 );
+    }
+};
+
+//---------------------------------------------------------------------------//
+//! \cond Impl
+template <class>
+struct is_fixed_point_impl : public std::false_type
+{
+};
+
+template <class IntType, int FractionalBits>
+struct is_fixed_point_impl<FixedPoint<IntType, FractionalBits>>
+    : public std::true_type
+{
+};
+//! \endcond
+
+//! FixedPoint static type checker.
+template <class T>
+struct is_fixed_point
+    : public is_fixed_point_impl<typename std::remove_cv<T>::type>::type
+{
+};
+
+//---------------------------------------------------------------------------//
+/*!
+  \brief Get the type a stored member value is computed and output in.
+
+  Builtin arithmetic types are their own compute type. Reduced precision
+  storage types use their compute_type.
+*/
+template <class T, class Enable = void>
+struct ComputeType
+{
+    //! Compute type.
+    using type = T;
+};
+
+//! Get the compute type of a reduced precision storage type.
+template <class T>
+struct ComputeType<T, typename std::enable_if<is_fixed_point<T>::value>::type>
+{
+    //! Compute type.
+    using type = typename T::compute_type;
+};
+
+//---------------------------------------------------------------------------//
+
+} // end namespace Cabana
+
+#endif // end CABANA_MIXEDPRECISION_HPP
@@ -21,12 +21,94 @@
 #include <Cabana_Types.hpp> // is_accessible_from
 
 #include <Kokkos_Core.hpp>
+#include <Kokkos_SIMD.hpp>
 
 #include <cstdlib>
 #include <type_traits>
 
 namespace Cabana
 {
+//---------------------------------------------------------------------------//
+// Explicit SIMD
+//---------------------------------------------------------------------------//
+//! Explicit SIMD execution mode tag for simd_parallel_for.
+class ExplicitSimdTag
+{
+};
+
+/*!
+  \brief Block of consecutive lanes of one SoA given to an explicit SIMD
+  functor.
+
+  \tparam Abi The Kokkos SIMD ABI of the block. Full blocks use the native
+  ABI of the host and lanes left over at the ends of the range use the
+  scalar ABI.
+
+  \tparam IndexType The index type.
+*/
+template <class Abi, class IndexType = int>
+struct SimdLanes
+{
+    //! Kokkos SIMD ABI.
+    using abi_type = Abi;
+
+    //! SIMD value type for the given scalar type.
+    template <class T>
+    using simd_type = Kokkos::Experimental::simd<T, Abi>;
+
+    //! Number of lanes in the block.
+    static constexpr int width = static_cast<int>( simd_type<double>::size() );
+
+    //! Struct index of the block.
+    IndexType s;
+
+    //! Array index of the first lane of the block.
+    IndexType a;
+};
+
+/*!
+  \brief Load the lanes of a block from a slice.
+
+  \param lanes The block of lanes.
+
+  \param slice The slice to load from.
+
+  \param d The indices of the slice element dimensions, if any.
+*/
+template <class Abi, class IndexType, class SliceType, class... Indices>
+KOKKOS_FORCEINLINE_FUNCTION
+    Kokkos::Experimental::simd<typename SliceType::value_type, Abi>
+    simdLoad( const SimdLanes<Abi, IndexType>& lanes, const SliceType& slice,
+              const Indices... d )
+{
+    Kokkos::Experimental::simd<typename SliceType::value_type, Abi> values;
+    values.copy_from( &slice.access( lanes.s, lanes.a, d... ),
+                      Kokkos::Experimental::element_aligned_tag() );
+    return values;
+}
+
+/*!
+  \brief Store SIMD values into the lanes of a block of a slice.
+
+  \param lanes The block of lanes.
+
+  \param values The values to store.
+
+  \param slice The slice to store to.
+
+  \param d The indices of the slice element dimensions, if any.
+*/
+template <class Abi, class IndexType, class SliceType, class... Indices>
+KOKKOS_FORCEINLINE_FUNCTION void simdStore(
+    const SimdLanes<Abi, IndexType>& lanes,
+    const Kokkos::Experimental::simd<typename SliceType::value_type, Abi>&
+        values,
+    const SliceType& slice, const Indices... d )
+{
+    values.copy_to( &slice.access( lanes.s, lanes.a, d... ),
+                    Kokkos::Experimental::element_aligned_tag() );
+}
+
 //---------------------------------------------------------------------------//
 namespace Impl
 {
@@ -121,6 +203,81 @@ struct ParallelFor<SimdPolicy<VectorLength, Properties...>, Functor>
     }
 };
 
+template <class ExecutionPolicy, class Functor>
+struct ExplicitSimdParallelFor;
+
+template <class Functor, int VectorLength, class... Properties>
+struct ExplicitSimdParallelFor<SimdPolicy<VectorLength, Properties...>,
+                               Functor>
+{
+    using simd_policy = SimdPolicy<VectorLength, Properties...>;
+    using team_policy = typename simd_policy::base_type;
+    using work_tag = typename team_policy::work_tag;
+    using index_type = typename team_policy::index_type;
+    using member_type = typename team_policy::member_type;
+    using execution_space = typename team_policy::execution_space;
+    static_assert( is_accessible_from<Kokkos::HostSpace, execution_space>{},
+                   "Explicit SIMD mode requires a host execution space" );
+    using native_lanes = SimdLanes<
+        typename Kokkos::Experimental::native_simd<double>::abi_type,
+        index_type>;
+    using scalar_lanes =
+        SimdLanes<Kokkos::Experimental::simd_abi::scalar, index_type>;
+
+    simd_policy exec_policy_;
+    Functor functor_;
+
+    ExplicitSimdParallelFor( std::string label, simd_policy exec_policy,
+                             Functor functor )
+        : exec_policy_( std::move( exec_policy ) )
+        , functor_( std::move( functor ) )
+    {
+        if ( label.empty() )
+            Kokkos::parallel_for(
+                dynamic_cast<const team_policy&>( exec_policy_ ), *this );
+        else
+            Kokkos::parallel_for(
+                label, dynamic_cast<const team_policy&>( exec_policy_ ),
+                *this );
+    }
+
+    template <class WorkTag>
+    KOKKOS_FUNCTION std::enable_if_t<!std::is_void<WorkTag>::value &&
+                                     std::is_same<WorkTag, work_tag>::value>
+    operator()( WorkTag, member_type const& team ) const
+    {
+        this->operator()( team );
+    }
+
+    KOKKOS_FUNCTION void operator()( member_type const& team ) const
+    {
+        index_type s = team.league_rank() + exec_policy_.structBegin();
+        index_type begin = exec_policy_.arrayBegin( s );
+        index_type end = exec_policy_.arrayEnd( s );
+        Kokkos::single( Kokkos::PerThread( team ),
+                        [&]()
+                        {
+                            const index_type width = native_lanes::width;
+                            index_type a = begin;
+
+                            // Lanes before the first full block.
+                            for ( ; a < end && a % width != 0; ++a )
+                                Impl::functorTagDispatch<work_tag>(
+                                    functor_, scalar_lanes{ s, a } );
+
+                            // Full blocks.
+                            for ( ; a + width <= end; a += width )
+                                Impl::functorTagDispatch<work_tag>(
+                                    functor_, native_lanes{ s, a } );
+
+                            // Lanes after the last full block.
+                            for ( ; a < end; ++a )
+                                Impl::functorTagDispatch<work_tag>(
+                                    functor_, scalar_lanes{ s, a } );
+                        } );
+    }
+};
+
 //! \endcond
 } // end namespace Impl
 
@@ -180,6 +337,50 @@ inline void simd_parallel_for(
     Kokkos::Profiling::popRegion();
 }
 
+/*!
+  \brief Execute a functor written with explicit SIMD types in parallel with
+  a 2d execution policy.
+
+  \param exec_policy The 2D range policy over which to execute the functor.
+
+  \param functor The functor to execute in parallel. It is called once per
+  block of SoA lanes with a SimdLanes argument (after the work tag, if any)
+  and must accept blocks of any ABI, e.g. through a templated call operator
+  or a generic lambda. Slice data for the block is loaded and stored with
+  simdLoad() and simdStore() and computed on as Kokkos SIMD values.
+
+  \param str Optional name for the functor.
+
+  Each SoA in the range is split into blocks of the host native SIMD width,
+  so the kernel is compiled to explicit vector code independent of compiler
+  auto-vectorization. Lanes of partially filled SoAs at the ends of the range
+  that do not form a full block are given one at a time with the scalar ABI.
+  Blocks of one SoA are run sequentially by a single thread of the team and
+  the native ABI is that of the host, so this mode is only available for
+  execution spaces that can access host memory.
+
+  \code
+  auto op = KOKKOS_LAMBDA( const auto& lanes )
+  {
+      auto v = Cabana::simdLoad( lanes, velocity, 0 );
+      Cabana::simdStore( lanes, 2.0 * v, velocity, 0 );
+  };
+  Cabana::simd_parallel_for( policy, op, Cabana::ExplicitSimdTag() );
+  \endcode
+*/
+template <class FunctorType, int VectorLength, class... ExecParameters>
+inline void simd_parallel_for(
+    const SimdPolicy<VectorLength, ExecParameters...>& exec_policy,
+    const FunctorType& functor, ExplicitSimdTag, const std::string& str = "" )
+{
+    Kokkos::Profiling::pushRegion( "Cabana::simd_parallel_for" );
+
+    Impl::ExplicitSimdParallelFor<SimdPolicy<VectorLength, ExecParameters...>,
+                                  FunctorType>( str, exec_policy, functor );
+
+    Kokkos::Profiling::popRegion();
+}
+
 //---------------------------------------------------------------------------//
 // Neighbor Parallel For
 //---------------------------------------------------------------------------//
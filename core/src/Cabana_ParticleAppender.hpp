@@ -0,0 +1,218 @@
+/****************************************************************************
+ * Copyright (c) 2018-2022 by the Cabana authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the Cabana library. Cabana is distributed under a   *
+ * BSD 3-clause license. For the licensing terms see the LICENSE file in    *
+ * the top-level directory.                                                 *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+/*!
+  \file Cabana_ParticleAppender.hpp
+  \brief Device-side creation of particles in an AoSoA
+*/
+#ifndef CABANA_PARTICLEAPPENDER_HPP
+#define CABANA_PARTICLEAPPENDER_HPP
+
+#include <Cabana_AoSoA.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <type_traits>
+
+namespace Cabana
+{
+//---------------------------------------------------------------------------//
+/*!
+  \brief Append particles to an AoSoA from within a kernel.
+
+  \tparam AoSoA_t The AoSoA type.
+
+  The AoSoA is grown by a headroom when the appender is created. Kernels
+  claim slots in the headroom with an atomic counter and write the new
+  particles directly. Finalizing shrinks the AoSoA to the particles actually
+  created. If more slots were claimed than the headroom holds, finalizing
+  discards the new particles and the kernel must be run again after
+  resetting with the required headroom.
+
+  Slices used to write new particles must be created after the appender (or
+  after a reset) as growing the AoSoA may reallocate it.
+*/
+template <class AoSoA_t>
+class ParticleAppender
+{
+  public:
+    static_assert( is_aosoa<AoSoA_t>::value, "" );
+
+    //! AoSoA type.
+    using aosoa_type = AoSoA_t;
+
+    //! Tuple type.
+    using tuple_type = typename aosoa_type::tuple_type;
+
+    //! Kokkos memory space.
+    using memory_space = typename aosoa_type::memory_space;
+
+    //! Size type.
+    using size_type = typename aosoa_type::size_type;
+
+    /*!
+      \brief Constructor.
+
+      \param aosoa The AoSoA to append to. Grown by the headroom.
+
+      \param headroom The number of particles that may be appended.
+    */
+    ParticleAppender( aosoa_type& aosoa, const size_type headroom )
+        : _begin( aosoa.size() )
+        , _counter( "Cabana::ParticleAppender::counter" )
+    {
+        reset( aosoa, headroom );
+    }
+
+    /*!
+      \brief Grow the AoSoA to the given headroom past the original size and
+      discard any claimed slots.
+    */
+    void reset( aosoa_type& aosoa, const size_type headroom )
+    {
+        _headroom = headroom;
+        aosoa.resize( _begin + _headroom );
+        _aosoa = aosoa;
+        Kokkos::deep_copy( _counter, 0 );
+    }
+
+    /*!
+      \brief Claim slots for new particles.
+
+      \param slot The AoSoA index of the first claimed slot.
+
+      \param n The number of contiguous slots to claim.
+
+      \return True if the slots fit in the headroom. Otherwise the slots must
+      not be written.
+    */
+    KOKKOS_INLINE_FUNCTION
+    bool claim( size_type& slot, const size_type n = 1 ) const
+    {
+        size_type offset = Kokkos::atomic_fetch_add( &_counter(), n );
+        slot = _begin + offset;
+        return offset + n <= _headroom;
+    }
+
+    //! Write a new particle into a claimed slot.
+    KOKKOS_INLINE_FUNCTION
+    void setTuple( const size_type slot, const tuple_type& tpl ) const
+    {
+        _aosoa.setTuple( slot, tpl );
+    }
+
+    //! Get the index of the first appended particle.
+    KOKKOS_INLINE_FUNCTION
+    size_type begin() const { return _begin; }
+
+    //! Get the number of particles the current headroom holds.
+    KOKKOS_INLINE_FUNCTION
+    size_type headroom() const { return _headroom; }
+
+    //! Get the number of slots claimed so far, including any overflow.
+    size_type numClaimed() const
+    {
+        size_type count;
+        Kokkos::deep_copy( count, _counter );
+        return count;
+    }
+
+    /*!
+      \brief Set the AoSoA size to the appended particles.
+
+      \return True if all claimed slots fit in the headroom. Otherwise the
+      AoSoA is returned to its original size and numClaimed() gives the
+      headroom needed to run again.
+    */
+    bool finalize( aosoa_type& aosoa )
+    {
+        auto count = numClaimed();
+        bool fits = ( count <= _headroom );
+        aosoa.resize( fits ? _begin + count : _begin );
+        _aosoa = aosoa;
+        return fits;
+    }
+
+  private:
+    size_type _begin;
+    size_type _headroom;
+    aosoa_type _aosoa;
+    Kokkos::View<size_type, memory_space> _counter;
+};
+
+//---------------------------------------------------------------------------//
+/*!
+  \brief Create particles from within a kernel, retrying with the required
+  headroom if the initial guess was too small.
+
+  \param exec_space Kokkos execution space.
+
+  \param aosoa The AoSoA to append to.
+
+  \param num_work The number of work items in the kernel.
+
+  \param functor Functor with signature (const int i, const
+  ParticleAppender<AoSoA_t>& appender) claiming slots and writing new
+  particles with the appender's setTuple(). It is run a second time if the
+  headroom overflows and must then claim the same number of slots.
+
+  \param headroom Initial guess of the number of new particles.
+
+  \return The number of particles appended.
+*/
+template <class ExecutionSpace, class AoSoA_t, class FunctorType>
+std::size_t appendParticles(
+    ExecutionSpace exec_space, AoSoA_t& aosoa, const std::size_t num_work,
+    const FunctorType& functor, const std::size_t headroom,
+    typename std::enable_if<( is_aosoa<AoSoA_t>::value ), int>::type* = 0 )
+{
+    Kokkos::Profiling::pushRegion( "Cabana::appendParticles" );
+
+    ParticleAppender<AoSoA_t> appender( aosoa, headroom );
+    Kokkos::RangePolicy<ExecutionSpace> policy( exec_space, 0, num_work );
+    auto append_op = KOKKOS_LAMBDA( const int i ) { functor( i, appender ); };
+    Kokkos::parallel_for( "Cabana::appendParticles", policy, append_op );
+    Kokkos::fence();
+
+    if ( !appender.finalize( aosoa ) )
+    {
+        appender.reset( aosoa, appender.numClaimed() );
+        Kokkos::parallel_for( "Cabana::appendParticles::retry", policy,
+                              KOKKOS_LAMBDA( const int i ) {
+                                  functor( i, appender );
+                              } );
+        Kokkos::fence();
+        appender.finalize( aosoa );
+    }
+
+    Kokkos::Profiling::popRegion();
+    return aosoa.size() - appender.begin();
+}
+
+/*!
+  \brief Create particles from within a kernel using the default execution
+  space of the AoSoA.
+*/
+template <class AoSoA_t, class FunctorType>
+std::size_t appendParticles(
+    AoSoA_t& aosoa, const std::size_t num_work, const FunctorType& functor,
+    const std::size_t headroom,
+    typename std::enable_if<( is_aosoa<AoSoA_t>::value ), int>::type* = 0 )
+{
+    using exec_space = typename AoSoA_t::execution_space;
+    return appendParticles( exec_space{}, aosoa, num_work, functor, headroom );
+}
+
+//---------------------------------------------------------------------------//
+
+} // end namespace Cabana
+
+#endif // end CABANA_PARTICLEAPPENDER_HPP
@@ -16,67 +16,253 @@
 #ifndef CABANA_PARTICLEINIT_HPP
 #define CABANA_PARTICLEINIT_HPP
 
+#include <Kokkos_Core.hpp>
 #include <Kokkos_Random.hpp>
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
 #include <random>
+#include <stdexcept>
 #include <type_traits>
 
 namespace Cabana
 {
 
+//! \cond Impl
+namespace Impl
+{
+//---------------------------------------------------------------------------//
+// SplitMix64 finalizer. Used to draw reproducible random numbers from the
+// seed, cell and round independent of the thread schedule.
+KOKKOS_INLINE_FUNCTION
+std::uint64_t hashMix( std::uint64_t x )
+{
+    x += 0x9e3779b97f4a7c15ull;
+    x = ( x ^ ( x >> 30 ) ) * 0xbf58476d1ce4e5b9ull;
+    x = ( x ^ ( x >> 27 ) ) * 0x94d049bb133111ebull;
+    return x ^ ( x >> 31 );
+}
+
+// Uniform random number in [0,1) from a hash.
+KOKKOS_INLINE_FUNCTION
+double hashUniform( const std::uint64_t h )
+{
+    return ( h >> 11 ) * ( 1.0 / 9007199254740992.0 );
+}
+
+// Hash of the dart thrown in a background cell in a given round.
+KOKKOS_INLINE_FUNCTION
+std::uint64_t dartHash( const std::uint64_t seed, const long cell,
+                        const int round )
+{
+    return hashMix( seed ^ hashMix( static_cast<std::uint64_t>( cell ) ^
+                                    hashMix( round ) ) );
+}
+
+//---------------------------------------------------------------------------//
+
+} // end namespace Impl
+//! \endcond
+
 /*!
   Generate random particles with minimum distance between neighbors. This
   approximates many physical scenarios, e.g. atomic simulations. Kokkos
   device version.
+
+  Particles are placed by parallel dart throwing on a background grid with
+  cells small enough to hold at most one particle, so each dart is only
+  checked against the particles of nearby cells. Cells are processed in
+  phases such that cells of the same phase can never conflict, which makes
+  the result deterministic for a given seed. The cost is linear in the
+  number of grid cells, which is proportional to the number of particles
+  for dense systems. Particles are returned in background cell order.
+
+  \throw std::runtime_error If the requested number of particles could not
+  be placed, e.g. because the density is too high.
 */
 template <class ExecutionSpace, class PositionType>
-void createRandomParticlesMinDistance( ExecutionSpace, PositionType& positions,
-                                       const std::size_t num_particles,
-                                       const double box_min,
-                                       const double box_max,
-                                       const double min_dist )
+std::enable_if_t<Kokkos::is_execution_space<ExecutionSpace>::value>
+createRandomParticlesMinDistance(
+    ExecutionSpace, PositionType& positions, const std::size_t num_particles,
+    const double box_min, const double box_max, const double min_dist,
+    const std::uint64_t seed = 342343901 )
 {
-    double min_dist_sqr = min_dist * min_dist;
+    Kokkos::Profiling::pushRegion( "Cabana::createRandomParticlesMinDistance" );
 
-    using PoolType = Kokkos::Random_XorShift64_Pool<ExecutionSpace>;
-    using RandomType = Kokkos::Random_XorShift64<ExecutionSpace>;
-    PoolType pool( 342343901 );
-    auto random_coord_op = KOKKOS_LAMBDA( const int p )
-    {
-        auto gen = pool.get_state();
+    using memory_space = typename ExecutionSpace::memory_space;
+
+    // Background grid. The cell diagonal is at most the minimum distance and
+    // there are at least as many cells as particles.
+    const double length = box_max - box_min;
+    long nc = std::max( 1L, static_cast<long>( std::ceil(
+                                std::cbrt( 1.0 * num_particles ) ) ) );
+    if ( min_dist > 0.0 )
+        nc = std::max( nc, static_cast<long>( std::ceil(
+                               length * std::sqrt( 3.0 ) / min_dist ) ) );
+    const double dx = length / nc;
+    const long num_cell = nc * nc * nc;
+
+    // Particles closer than the minimum distance are at most this many cells
+    // apart. Cells of the same phase are further apart than that.
+    const long radius =
+        ( min_dist > 0.0 ) ? static_cast<long>( std::ceil( min_dist / dx ) )
+                           : 0L;
+    const long stride = radius + 1;
+    const double min_dist_sqr = min_dist * min_dist;
 
-        // Create particles. Only add particles that are outside a minimum
-        // distance from other particles.
-        bool found_neighbor = true;
+    // Cell state: 0 empty, 1 accepted, 2 accepted in the current round.
+    Kokkos::View<double* [3], memory_space> cell_x(
+        Kokkos::ViewAllocateWithoutInitializing(
+            "Cabana::createRandomParticlesMinDistance::cell_x" ),
+        num_cell );
+    Kokkos::View<int*, memory_space> cell_state(
+        "Cabana::createRandomParticlesMinDistance::cell_state", num_cell );
+    Kokkos::RangePolicy<ExecutionSpace> cell_policy( 0, num_cell );
 
-        // Keep trying new random coordinates until we insert one that is
-        // not within the minimum distance of any other particle.
-        while ( found_neighbor )
+    const int max_round = 256;
+    std::size_t num_placed = 0;
+    for ( int round = 0; round < max_round && num_placed < num_particles;
+          ++round )
+    {
+        // Throw one dart in each empty cell. Cells of the same phase are at
+        // least stride cells apart in one dimension and their darts cannot
+        // be closer than the minimum distance.
+        for ( long phase = 0; phase < stride * stride * stride; ++phase )
         {
-            found_neighbor = false;
+            const long pi = phase / ( stride * stride );
+            const long pj = ( phase / stride ) % stride;
+            const long pk = phase % stride;
+            Kokkos::MDRangePolicy<ExecutionSpace, Kokkos::Rank<3>>
+                phase_policy( { 0, 0, 0 },
+                              { ( nc - pi + stride - 1 ) / stride,
+                                ( nc - pj + stride - 1 ) / stride,
+                                ( nc - pk + stride - 1 ) / stride } );
+            Kokkos::parallel_for(
+                "Cabana::createRandomParticlesMinDistance::throw",
+                phase_policy,
+                KOKKOS_LAMBDA( const long a, const long b, const long e ) {
+                    const long ijk[3] = { pi + stride * a, pj + stride * b,
+                                          pk + stride * e };
+                    const long c = ( ijk[0] * nc + ijk[1] ) * nc + ijk[2];
+                    if ( cell_state( c ) )
+                        return;
+
+                    auto h = Impl::dartHash( seed, c, round );
+                    double x[3];
+                    for ( int d = 0; d < 3; ++d )
+                        x[d] = box_min +
+                               ( ijk[d] + Impl::hashUniform(
+                                              Impl::hashMix( h + d ) ) ) *
+                                   dx;
+
+                    // Only particles within radius cells in each dimension
+                    // can be closer than the minimum distance.
+                    long lo[3];
+                    long hi[3];
+                    for ( int d = 0; d < 3; ++d )
+                    {
+                        lo[d] = ( ijk[d] > radius ) ? ijk[d] - radius : 0;
+                        hi[d] = ( ijk[d] + radius < nc ) ? ijk[d] + radius
+                                                         : nc - 1;
+                    }
+                    for ( long ni = lo[0]; ni <= hi[0]; ++ni )
+                        for ( long nj = lo[1]; nj <= hi[1]; ++nj )
+                            for ( long nk = lo[2]; nk <= hi[2]; ++nk )
+                            {
+                                const long n = ( ni * nc + nj ) * nc + nk;
+                                if ( !cell_state( n ) )
+                                    continue;
+                                double dist = 0.0;
+                                for ( int d = 0; d < 3; ++d )
+                                {
+                                    double diff = cell_x( n, d ) - x[d];
+                                    dist += diff * diff;
+                                }
+                                if ( dist < min_dist_sqr )
+                                    return;
+                            }
+
+                    for ( int d = 0; d < 3; ++d )
+                        cell_x( c, d ) = x[d];
+                    cell_state( c ) = 2;
+                } );
+        }
 
-            for ( int d = 0; d < 3; ++d )
-                positions( p, d ) = Kokkos::rand<RandomType, double>::draw(
-                    gen, box_min, box_max );
+        std::size_t num_new = 0;
+        Kokkos::parallel_reduce(
+            "Cabana::createRandomParticlesMinDistance::count", cell_policy,
+            KOKKOS_LAMBDA( const long c, std::size_t& count ) {
+                if ( 2 == cell_state( c ) )
+                    ++count;
+            },
+            num_new );
 
-            for ( int n = 0; n < p; n++ )
+        // If this round placed too many particles keep a random subset: find
+        // the smallest priority threshold keeping enough of them.
+        std::uint64_t threshold = ~std::uint64_t( 0 );
+        const std::size_t num_needed = num_particles - num_placed;
+        if ( num_new > num_needed )
+        {
+            std::uint64_t lo = 0;
+            while ( lo < threshold )
             {
-                double dx = positions( n, 0 ) - positions( p, 0 );
-                double dy = positions( n, 1 ) - positions( p, 1 );
-                double dz = positions( n, 2 ) - positions( p, 2 );
-                double dist = dx * dx + dy * dy + dz * dz;
-                if ( dist < min_dist_sqr )
-                {
-                    found_neighbor = true;
-                    break;
-                }
+                const std::uint64_t mid = lo + ( threshold - lo ) / 2;
+                std::size_t num_kept = 0;
+                Kokkos::parallel_reduce(
+                    "Cabana::createRandomParticlesMinDistance::select",
+                    cell_policy,
+                    KOKKOS_LAMBDA( const long c, std::size_t& count ) {
+                        if ( 2 == cell_state( c ) &&
+                             Impl::hashMix( Impl::dartHash( seed, c, round ) +
+                                            3 ) <= mid )
+                            ++count;
+                    },
+                    num_kept );
+                if ( num_kept >= num_needed )
+                    threshold = mid;
+                else
+                    lo = mid + 1;
             }
-            pool.free_state( gen );
+            num_new = num_needed;
         }
-    };
-    Kokkos::RangePolicy<ExecutionSpace> exec_policy( 0, num_particles );
-    Kokkos::parallel_for( exec_policy, random_coord_op );
+        Kokkos::parallel_for(
+            "Cabana::createRandomParticlesMinDistance::accept", cell_policy,
+            KOKKOS_LAMBDA( const long c ) {
+                if ( 2 == cell_state( c ) )
+                    cell_state( c ) =
+                        ( Impl::hashMix( Impl::dartHash( seed, c, round ) +
+                                         3 ) <= threshold )
+                            ? 1
+                            : 0;
+            } );
+        num_placed += num_new;
+    }
+
+    if ( num_placed < num_particles )
+    {
+        Kokkos::Profiling::popRegion();
+        throw std::runtime_error(
+            "Could not place the requested number of particles with the "
+            "given minimum distance" );
+    }
+
+    // Gather the particles in cell order. Ties in the final selection may
+    // accept extra particles which are dropped here.
+    Kokkos::parallel_scan(
+        "Cabana::createRandomParticlesMinDistance::gather", cell_policy,
+        KOKKOS_LAMBDA( const long c, std::size_t& offset, const bool final ) {
+            if ( 1 == cell_state( c ) )
+            {
+                if ( final && offset < num_particles )
+                    for ( int d = 0; d < 3; ++d )
+                        positions( offset, d ) = cell_x( c, d );
+                ++offset;
+            }
+        } );
     Kokkos::fence();
+
+    Kokkos::Profiling::popRegion();
 }
 
 /*!
@@ -89,11 +275,12 @@ void createRandomParticlesMinDistance( PositionType& positions,
                                        const std::size_t num_particles,
                                        const double box_min,
                                        const double box_max,
-                                       const double min_dist )
+                                       const double min_dist,
+                                       const std::uint64_t seed = 342343901 )
 {
     using exec_space = typename PositionType::execution_space;
     createRandomParticlesMinDistance( exec_space{}, positions, num_particles,
-                                      box_min, box_max, min_dist );
+                                      box_min, box_max, min_dist, seed );
 }
 
 //! Generate random particles. Kokkos device version.
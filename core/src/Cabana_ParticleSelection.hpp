@@ -0,0 +1,304 @@
+/****************************************************************************
+ * Copyright (c) 2018-2022 by the Cabana authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the Cabana library. Cabana is distributed under a   *
+ * BSD 3-clause license. For the licensing terms see the LICENSE file in    *
+ * the top-level directory.                                                 *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+/*!
+  \file Cabana_ParticleSelection.hpp
+  \brief Compacted particle subsets for output
+*/
+#ifndef CABANA_PARTICLESELECTION_HPP
+#define CABANA_PARTICLESELECTION_HPP
+
+#include <Cabana_Slice.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+namespace Cabana
+{
+//---------------------------------------------------------------------------//
+/*!
+  \brief Ordered list of selected particle indices.
+
+  \tparam MemorySpace The memory space of the indices.
+
+  A selection is built once with one of the create functions and then
+  passed to the output functions, which gather the selected particles of
+  each field directly into their staging buffers.
+*/
+template <class MemorySpace>
+class ParticleSelection
+{
+  public:
+    //! Memory space.
+    using memory_space = MemorySpace;
+
+    //! Index view type.
+    using index_view_type = Kokkos::View<int*, memory_space>;
+
+    //! Constructor from a view of increasing particle indices.
+    ParticleSelection( const index_view_type& indices )
+        : _indices( indices )
+    {
+    }
+
+    //! Get the number of selected particles.
+    std::size_t size() const { return _indices.size(); }
+
+    //! Get the selected particle indices.
+    index_view_type indices() const { return _indices; }
+
+  private:
+    index_view_type _indices;
+};
+
+//---------------------------------------------------------------------------//
+//! \cond Impl
+namespace Impl
+{
+//---------------------------------------------------------------------------//
+// Contiguous range of particles.
+struct ParticleRange
+{
+    std::size_t begin;
+    std::size_t end;
+
+    std::size_t size() const { return end - begin; }
+};
+
+//---------------------------------------------------------------------------//
+// Gather the particles of a range or selection into a contiguous view.
+template <class ViewType, class SliceType>
+void copySelectionToView( ViewType& view, const SliceType& slice,
+                          const ParticleRange& range )
+{
+    copySliceToView( view, slice, range.begin, range.end );
+}
+
+template <class ViewType, class SliceType, class MemorySpace>
+void copySelectionToView( ViewType& view, const SliceType& slice,
+                          const ParticleSelection<MemorySpace>& selection )
+{
+    static_assert(
+        Kokkos::SpaceAccessibility<typename SliceType::execution_space,
+                                   MemorySpace>::accessible,
+        "Selection must be accessible from the slice execution space" );
+    copySliceToView( view, slice, selection.indices() );
+}
+
+//---------------------------------------------------------------------------//
+// Select particles with a predicate on their index.
+template <class MemorySpace, class PredicateType>
+ParticleSelection<MemorySpace> selectIf( const std::size_t num_particle,
+                                         const PredicateType& predicate )
+{
+    using execution_space = typename MemorySpace::execution_space;
+
+    // Count and compact in a single scan into room for every particle, then
+    // shrink to the number selected.
+    typename ParticleSelection<MemorySpace>::index_view_type indices(
+        Kokkos::ViewAllocateWithoutInitializing( "Cabana::ParticleSelection" ),
+        num_particle );
+    int num_selected = 0;
+    Kokkos::parallel_scan(
+        "Cabana::ParticleSelection::compact",
+        Kokkos::RangePolicy<execution_space>( 0, num_particle ),
+        KOKKOS_LAMBDA( const int i, int& offset, const bool final_pass ) {
+            if ( predicate( i ) )
+            {
+                if ( final_pass )
+                    indices( offset ) = i;
+                ++offset;
+            }
+        },
+        num_selected );
+    Kokkos::resize( indices, num_selected );
+
+    return ParticleSelection<MemorySpace>( indices );
+}
+
+//---------------------------------------------------------------------------//
+// Predicate wrapping a mask where non-zero entries are selected.
+template <class MaskType>
+struct SelectMask
+{
+    MaskType mask;
+
+    KOKKOS_INLINE_FUNCTION
+    bool operator()( const int i ) const { return mask( i ); }
+};
+
+template <class MaskType>
+SelectMask<MaskType> makeSelectPredicate(
+    const MaskType& mask,
+    typename std::enable_if<( is_slice<MaskType>::value ||
+                              Kokkos::is_view<MaskType>::value ),
+                            int>::type* = 0 )
+{
+    return SelectMask<MaskType>{ mask };
+}
+
+template <class PredicateType>
+PredicateType makeSelectPredicate(
+    const PredicateType& predicate,
+    typename std::enable_if<( !is_slice<PredicateType>::value &&
+                              !Kokkos::is_view<PredicateType>::value ),
+                            int>::type* = 0 )
+{
+    return predicate;
+}
+
+//---------------------------------------------------------------------------//
+// Select every stride-th particle.
+struct StridePredicate
+{
+    int stride;
+    int offset;
+
+    KOKKOS_INLINE_FUNCTION
+    bool operator()( const int i ) const
+    {
+        return i >= offset && 0 == ( i - offset ) % stride;
+    }
+};
+
+//---------------------------------------------------------------------------//
+// Select a particle with a fixed probability using a hash of its index, so
+// the selection does not depend on the thread schedule.
+struct RandomPredicate
+{
+    std::uint64_t seed;
+    double fraction;
+
+    KOKKOS_INLINE_FUNCTION
+    static std::uint64_t hash( std::uint64_t x )
+    {
+        x += 0x9e3779b97f4a7c15ULL;
+        x = ( x ^ ( x >> 30 ) ) * 0xbf58476d1ce4e5b9ULL;
+        x = ( x ^ ( x >> 27 ) ) * 0x94d049bb133111ebULL;
+        return x ^ ( x >> 31 );
+    }
+
+    KOKKOS_INLINE_FUNCTION
+    bool operator()( const int i ) const
+    {
+        double u = ( hash( seed ^ static_cast<std::uint64_t>( i ) ) >> 11 ) *
+                   ( 1.0 / 9007199254740992.0 );
+        return u < fraction;
+    }
+};
+
+//---------------------------------------------------------------------------//
+// Select particles with positions in a box.
+template <class PositionSliceType>
+struct RegionPredicate
+{
+    static_assert(
+        3 == PositionSliceType::kokkos_view::traits::dimension::rank &&
+            3 == PositionSliceType::kokkos_view::static_extent( 2 ),
+        "Region selection requires 3D positions" );
+
+    PositionSliceType positions;
+    Kokkos::Array<double, 3> low;
+    Kokkos::Array<double, 3> high;
+
+    KOKKOS_INLINE_FUNCTION
+    bool operator()( const int i ) const
+    {
+        for ( int d = 0; d < 3; ++d )
+            if ( positions( i, d ) < low[d] || positions( i, d ) >= high[d] )
+                return false;
+        return true;
+    }
+};
+
+} // namespace Impl
+//! \endcond
+
+//---------------------------------------------------------------------------//
+/*!
+  \brief Select every stride-th particle.
+  \param num_particle The number of particles.
+  \param stride The distance between selected particles.
+  \param offset The first selected particle.
+*/
+template <class MemorySpace>
+ParticleSelection<MemorySpace>
+createStrideSelection( const std::size_t num_particle, const int stride,
+                       const int offset = 0 )
+{
+    if ( stride < 1 || offset < 0 )
+        throw std::runtime_error(
+            "Stride must be positive and offset non-negative" );
+    return Impl::selectIf<MemorySpace>(
+        num_particle, Impl::StridePredicate{ stride, offset } );
+}
+
+/*!
+  \brief Select a random fraction of the particles. The same seed, fraction
+  and number of particles give the same selection.
+  \param num_particle The number of particles.
+  \param fraction The probability of selecting each particle.
+  \param seed Random seed.
+*/
+template <class MemorySpace>
+ParticleSelection<MemorySpace>
+createRandomSelection( const std::size_t num_particle, const double fraction,
+                       const std::uint64_t seed = 0 )
+{
+    return Impl::selectIf<MemorySpace>(
+        num_particle,
+        Impl::RandomPredicate{ Impl::RandomPredicate::hash( seed ),
+                               fraction } );
+}
+
+/*!
+  \brief Select particles by a mask or predicate.
+  \param num_particle The number of particles.
+  \param select A view or slice where particles with non-zero entries are
+  selected, or a functor returning true for selected particle indices.
+*/
+template <class MemorySpace, class SelectType>
+ParticleSelection<MemorySpace> createSelection( const std::size_t num_particle,
+                                                const SelectType& select )
+{
+    return Impl::selectIf<MemorySpace>( num_particle,
+                                        Impl::makeSelectPredicate( select ) );
+}
+
+/*!
+  \brief Select the particles with positions in a box.
+  \param positions Particle positions.
+  \param low The low corner of the box.
+  \param high The high corner of the box (exclusive).
+*/
+template <class PositionSliceType>
+ParticleSelection<typename PositionSliceType::memory_space>
+createRegionSelection( const PositionSliceType& positions,
+                       const Kokkos::Array<double, 3>& low,
+                       const Kokkos::Array<double, 3>& high )
+{
+    static_assert( is_slice<PositionSliceType>::value,
+                   "Positions must be a slice" );
+    return Impl::selectIf<typename PositionSliceType::memory_space>(
+        positions.size(),
+        Impl::RegionPredicate<PositionSliceType>{ positions, low, high } );
+}
+
+//---------------------------------------------------------------------------//
+
+} // end namespace Cabana
+
+#endif // end CABANA_PARTICLESELECTION_HPP
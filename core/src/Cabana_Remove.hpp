@@ -0,0 +1,320 @@
+/****************************************************************************
+ * Copyright (c) 2018-2022 by the Cabana authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the Cabana library. Cabana is distributed under a   *
+ * BSD 3-clause license. For the licensing terms see the LICENSE file in    *
+ * the top-level directory.                                                 *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+/*!
+  \file Cabana_Remove.hpp
+  \brief Parallel removal of particles from an AoSoA
+*/
+#ifndef CABANA_REMOVE_HPP
+#define CABANA_REMOVE_HPP
+
+#include <Cabana_AoSoA.hpp>
+#include <Cabana_Slice.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <type_traits>
+
+namespace Cabana
+{
+//---------------------------------------------------------------------------//
+//! Remove particles while keeping the order of the remaining particles.
+struct OrderedRemoveTag
+{
+};
+
+//! Remove particles by filling holes with particles from the end.
+struct UnorderedRemoveTag
+{
+};
+
+namespace Impl
+{
+//! \cond Impl
+//---------------------------------------------------------------------------//
+// Predicate wrapping a mask where non-zero entries are removed.
+template <class MaskType>
+struct RemoveMask
+{
+    MaskType mask;
+
+    KOKKOS_INLINE_FUNCTION
+    bool operator()( const int i ) const { return mask( i ); }
+};
+
+template <class MaskType>
+RemoveMask<MaskType> makeRemovePredicate(
+    const MaskType& mask,
+    typename std::enable_if<( is_slice<MaskType>::value ||
+                              Kokkos::is_view<MaskType>::value ),
+                            int>::type* = 0 )
+{
+    return RemoveMask<MaskType>{ mask };
+}
+
+template <class PredicateType>
+PredicateType makeRemovePredicate(
+    const PredicateType& predicate,
+    typename std::enable_if<( !is_slice<PredicateType>::value &&
+                              !Kokkos::is_view<PredicateType>::value ),
+                            int>::type* = 0 )
+{
+    return predicate;
+}
+
+//---------------------------------------------------------------------------//
+// Compact the particles after the first removed particle, keeping their
+// order. Only particles behind the first hole are moved.
+template <class ExecutionSpace, class AoSoA_t, class FlagView>
+std::size_t removeFlagged( ExecutionSpace, AoSoA_t& aosoa,
+                           const FlagView& remove, OrderedRemoveTag )
+{
+    const std::size_t num_particle = aosoa.size();
+
+    // Find the first hole.
+    std::size_t first = num_particle;
+    Kokkos::parallel_reduce(
+        "Cabana::remove_if::first_removed",
+        Kokkos::RangePolicy<ExecutionSpace>( 0, num_particle ),
+        KOKKOS_LAMBDA( const std::size_t i, std::size_t& result ) {
+            if ( remove( i ) && i < result )
+                result = i;
+        },
+        Kokkos::Min<std::size_t>( first ) );
+
+    // The reducer is initialized to the largest value, not num_particle, so
+    // nothing was flagged if the result is past the end.
+    if ( first >= num_particle )
+        return 0;
+
+    // Number the kept particles behind the first hole.
+    Kokkos::View<std::size_t*, typename AoSoA_t::memory_space> new_index(
+        Kokkos::ViewAllocateWithoutInitializing( "remove_new_index" ),
+        num_particle - first );
+    std::size_t num_keep = 0;
+    Kokkos::parallel_scan(
+        "Cabana::remove_if::ordered_scan",
+        Kokkos::RangePolicy<ExecutionSpace>( first, num_particle ),
+        KOKKOS_LAMBDA( const std::size_t i, std::size_t& offset,
+                       const bool final_pass ) {
+            if ( final_pass )
+                new_index( i - first ) = offset;
+            if ( !remove( i ) )
+                ++offset;
+        },
+        num_keep );
+
+    // Gather the kept particles and copy them back into the holes.
+    Kokkos::View<typename AoSoA_t::tuple_type*,
+                 typename AoSoA_t::memory_space>
+        scratch( Kokkos::ViewAllocateWithoutInitializing( "remove_scratch" ),
+                 num_keep );
+    Kokkos::parallel_for(
+        "Cabana::remove_if::gather",
+        Kokkos::RangePolicy<ExecutionSpace>( first, num_particle ),
+        KOKKOS_LAMBDA( const std::size_t i ) {
+            if ( !remove( i ) )
+                scratch( new_index( i - first ) ) = aosoa.getTuple( i );
+        } );
+    Kokkos::parallel_for(
+        "Cabana::remove_if::copy_back",
+        Kokkos::RangePolicy<ExecutionSpace>( 0, num_keep ),
+        KOKKOS_LAMBDA( const std::size_t i ) {
+            aosoa.setTuple( first + i, scratch( i ) );
+        } );
+    Kokkos::fence();
+
+    std::size_t num_remove = num_particle - first - num_keep;
+    aosoa.resize( first + num_keep );
+    return num_remove;
+}
+
+//---------------------------------------------------------------------------//
+// Fill the holes in the front of the container with the particles kept at
+// the end. Only as many particles as were removed are moved.
+template <class ExecutionSpace, class AoSoA_t, class FlagView>
+std::size_t removeFlagged( ExecutionSpace, AoSoA_t& aosoa,
+                           const FlagView& remove, UnorderedRemoveTag )
+{
+    const std::size_t num_particle = aosoa.size();
+
+    std::size_t num_remove = 0;
+    Kokkos::parallel_reduce(
+        "Cabana::remove_if::count",
+        Kokkos::RangePolicy<ExecutionSpace>( 0, num_particle ),
+        KOKKOS_LAMBDA( const std::size_t i, std::size_t& result ) {
+            if ( remove( i ) )
+                ++result;
+        },
+        num_remove );
+    if ( 0 == num_remove )
+        return 0;
+    const std::size_t num_keep = num_particle - num_remove;
+
+    // Holes are removed particles in the new range and fillers are kept
+    // particles past its end. There are as many of one as of the other.
+    using memory_space = typename AoSoA_t::memory_space;
+    Kokkos::View<std::size_t*, memory_space> holes(
+        Kokkos::ViewAllocateWithoutInitializing( "remove_holes" ),
+        num_particle - num_keep );
+    Kokkos::View<std::size_t*, memory_space> fillers(
+        Kokkos::ViewAllocateWithoutInitializing( "remove_fillers" ),
+        num_particle - num_keep );
+    std::size_t num_hole = 0;
+    Kokkos::parallel_scan(
+        "Cabana::remove_if::hole_scan",
+        Kokkos::RangePolicy<ExecutionSpace>( 0, num_keep ),
+        KOKKOS_LAMBDA( const std::size_t i, std::size_t& offset,
+                       const bool final_pass ) {
+            if ( remove( i ) )
+            {
+                if ( final_pass )
+                    holes( offset ) = i;
+                ++offset;
+            }
+        },
+        num_hole );
+    std::size_t num_filler = 0;
+    Kokkos::parallel_scan(
+        "Cabana::remove_if::filler_scan",
+        Kokkos::RangePolicy<ExecutionSpace>( num_keep, num_particle ),
+        KOKKOS_LAMBDA( const std::size_t i, std::size_t& offset,
+                       const bool final_pass ) {
+            if ( !remove( i ) )
+            {
+                if ( final_pass )
+                    fillers( offset ) = i;
+                ++offset;
+            }
+        },
+        num_filler );
+
+    // Holes and fillers are in disjoint ranges so they can be moved in
+    // place.
+    Kokkos::parallel_for(
+        "Cabana::remove_if::fill_holes",
+        Kokkos::RangePolicy<ExecutionSpace>( 0, num_hole ),
+        KOKKOS_LAMBDA( const std::size_t h ) {
+            aosoa.setTuple( holes( h ), aosoa.getTuple( fillers( h ) ) );
+        } );
+    Kokkos::fence();
+
+    aosoa.resize( num_keep );
+    return num_remove;
+}
+
+//! \endcond
+} // end namespace Impl
+
+//---------------------------------------------------------------------------//
+/*!
+  \brief Remove particles from an AoSoA.
+
+  \tparam ExecutionSpace Kokkos execution space.
+
+  \tparam AoSoA_t The AoSoA type.
+
+  \tparam PredicateType Mask (slice or Kokkos view) with a non-zero value for
+  each particle to remove or functor returning true for the index of each
+  particle to remove.
+
+  \tparam RemoveTag Either OrderedRemoveTag to keep the relative order of the
+  remaining particles or UnorderedRemoveTag to only move as many particles as
+  were removed.
+
+  \param exec_space Kokkos execution space.
+
+  \param aosoa The AoSoA to remove particles from. Resized to the number of
+  remaining particles.
+
+  \param predicate The mask or functor selecting the particles to remove. The
+  predicate is evaluated for all particles before any data is moved so it may
+  read the AoSoA.
+
+  \return The number of particles removed.
+*/
+template <class ExecutionSpace, class AoSoA_t, class PredicateType,
+          class RemoveTag>
+std::size_t remove_if(
+    ExecutionSpace exec_space, AoSoA_t& aosoa, const PredicateType& predicate,
+    RemoveTag tag,
+    typename std::enable_if<( is_aosoa<AoSoA_t>::value &&
+                              Kokkos::is_execution_space<
+                                  ExecutionSpace>::value ),
+                            int>::type* = 0 )
+{
+    Kokkos::Profiling::pushRegion( "Cabana::remove_if" );
+
+    static_assert(
+        is_accessible_from<typename AoSoA_t::memory_space, ExecutionSpace>{},
+        "" );
+
+    // Evaluate the predicate before moving data.
+    auto pred = Impl::makeRemovePredicate( predicate );
+    Kokkos::View<bool*, typename AoSoA_t::memory_space> remove(
+        Kokkos::ViewAllocateWithoutInitializing( "remove_flags" ),
+        aosoa.size() );
+    Kokkos::parallel_for(
+        "Cabana::remove_if::flag",
+        Kokkos::RangePolicy<ExecutionSpace>( 0, aosoa.size() ),
+        KOKKOS_LAMBDA( const std::size_t i ) { remove( i ) = pred( i ); } );
+    Kokkos::fence();
+
+    auto num_remove = Impl::removeFlagged( exec_space, aosoa, remove, tag );
+
+    Kokkos::Profiling::popRegion();
+    return num_remove;
+}
+
+/*!
+  \brief Remove particles from an AoSoA, keeping the order of the remaining
+  particles.
+
+  \param aosoa The AoSoA to remove particles from.
+
+  \param predicate The mask or functor selecting the particles to remove.
+
+  \return The number of particles removed.
+*/
+template <class AoSoA_t, class PredicateType>
+std::size_t remove_if(
+    AoSoA_t& aosoa, const PredicateType& predicate,
+    typename std::enable_if<( is_aosoa<AoSoA_t>::value ), int>::type* = 0 )
+{
+    using exec_space = typename AoSoA_t::execution_space;
+    return remove_if( exec_space{}, aosoa, predicate, OrderedRemoveTag{} );
+}
+
+/*!
+  \brief Remove particles from an AoSoA with the given ordering.
+
+  \param aosoa The AoSoA to remove particles from.
+
+  \param predicate The mask or functor selecting the particles to remove.
+
+  \param tag OrderedRemoveTag or UnorderedRemoveTag.
+
+  \return The number of particles removed.
+*/
+template <class AoSoA_t, class PredicateType, class RemoveTag>
+std::size_t remove_if(
+    AoSoA_t& aosoa, const PredicateType& predicate, RemoveTag tag,
+    typename std::enable_if<( is_aosoa<AoSoA_t>::value ), int>::type* = 0 )
+{
+    using exec_space = typename AoSoA_t::execution_space;
+    return remove_if( exec_space{}, aosoa, predicate, tag );
+}
+
+//---------------------------------------------------------------------------//
+
+} // end namespace Cabana
+
+#endif // end CABANA_REMOVE_HPP
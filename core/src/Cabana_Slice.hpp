@@ -919,6 +919,75 @@ void copySliceToView( ViewType& view, const SliceType& slice,
     copySliceToView( exec_space{}, view, slice, begin, end );
 }
 
+//! Copy selected particles from slice to View. Rank-0
+template <class ExecutionSpace, class ViewType, class SliceType,
+          class IndexViewType>
+void copySliceToView(
+    ExecutionSpace exec_space, ViewType& view, const SliceType& slice,
+    const IndexViewType& indices,
+    typename std::enable_if<
+        2 == SliceType::kokkos_view::traits::dimension::rank &&
+            Kokkos::is_view<IndexViewType>::value,
+        int*>::type = 0 )
+{
+    Kokkos::parallel_for(
+        "Cabana::copySliceToView::SelectedRank0",
+        Kokkos::RangePolicy<ExecutionSpace>( exec_space, 0, indices.size() ),
+        KOKKOS_LAMBDA( const int i ) { view( i ) = slice( indices( i ) ); } );
+}
+
+//! Copy selected particles from slice to View. Rank-1
+template <class ExecutionSpace, class ViewType, class SliceType,
+          class IndexViewType>
+void copySliceToView(
+    ExecutionSpace exec_space, ViewType& view, const SliceType& slice,
+    const IndexViewType& indices,
+    typename std::enable_if<
+        3 == SliceType::kokkos_view::traits::dimension::rank &&
+            Kokkos::is_view<IndexViewType>::value,
+        int*>::type = 0 )
+{
+    Kokkos::parallel_for(
+        "Cabana::copySliceToView::SelectedRank1",
+        Kokkos::RangePolicy<ExecutionSpace>( exec_space, 0, indices.size() ),
+        KOKKOS_LAMBDA( const int i ) {
+            for ( std::size_t d0 = 0; d0 < slice.extent( 2 ); ++d0 )
+                view( i, d0 ) = slice( indices( i ), d0 );
+        } );
+}
+
+//! Copy selected particles from slice to View. Rank-2
+template <class ExecutionSpace, class ViewType, class SliceType,
+          class IndexViewType>
+void copySliceToView(
+    ExecutionSpace exec_space, ViewType& view, const SliceType& slice,
+    const IndexViewType& indices,
+    typename std::enable_if<
+        4 == SliceType::kokkos_view::traits::dimension::rank &&
+            Kokkos::is_view<IndexViewType>::value,
+        int*>::type = 0 )
+{
+    Kokkos::parallel_for(
+        "Cabana::copySliceToView::SelectedRank2",
+        Kokkos::RangePolicy<ExecutionSpace>( exec_space, 0, indices.size() ),
+        KOKKOS_LAMBDA( const int i ) {
+            for ( std::size_t d0 = 0; d0 < slice.extent( 2 ); ++d0 )
+                for ( std::size_t d1 = 0; d1 < slice.extent( 3 ); ++d1 )
+                    view( i, d0, d1 ) = slice( indices( i ), d0, d1 );
+        } );
+}
+
+//! Copy selected particles from slice to View with default execution space.
+template <class ViewType, class SliceType, class IndexViewType>
+void copySliceToView(
+    ViewType& view, const SliceType& slice, const IndexViewType& indices,
+    typename std::enable_if<Kokkos::is_view<IndexViewType>::value,
+                            int*>::type = 0 )
+{
+    using exec_space = typename SliceType::execution_space;
+    copySliceToView( exec_space{}, view, slice, indices );
+}
+
 //---------------------------------------------------------------------------//
 // Copy from View.
 //---------------------------------------------------------------------------//
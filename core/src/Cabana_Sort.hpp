@@ -18,6 +18,7 @@
 
 #include <Cabana_AoSoA.hpp>
 #include <Cabana_DeepCopy.hpp>
+#include <Cabana_HotColdAoSoA.hpp>
 #include <Cabana_Slice.hpp>
 
 #include <Kokkos_Core.hpp>
@@ -686,6 +687,26 @@ void permute(
     Kokkos::Profiling::popRegion();
 }
 
+//---------------------------------------------------------------------------//
+/*!
+  \brief Given binning data permute the hot and cold members of a
+  HotColdAoSoA.
+
+  \param binning_data The binning data.
+
+  \param aosoa The container to permute.
+ */
+template <class BinningDataType, class HotColdType>
+void permute(
+    const BinningDataType& binning_data, HotColdType& aosoa,
+    typename std::enable_if<( is_binning_data<BinningDataType>::value &&
+                              is_hot_cold_aosoa<HotColdType>::value ),
+                            int>::type* = 0 )
+{
+    permute( binning_data, aosoa.hot() );
+    permute( binning_data, aosoa.cold() );
+}
+
 //---------------------------------------------------------------------------//
 
 } // end namespace Cabana
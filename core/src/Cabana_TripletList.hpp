@@ -0,0 +1,522 @@
+/****************************************************************************
+ * Copyright (c) 2018-2022 by the Cabana authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the Cabana library. Cabana is distributed under a   *
+ * BSD 3-clause license. For the licensing terms see the LICENSE file in    *
+ * the top-level directory.                                                 *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+/*!
+  \file Cabana_TripletList.hpp
+  \brief Precomputed particle triplet (angle) list for many-body interactions
+*/
+#ifndef CABANA_TRIPLETLIST_HPP
+#define CABANA_TRIPLETLIST_HPP
+
+#include <Cabana_NeighborList.hpp>
+#include <Cabana_Parallel.hpp>
+#include <Cabana_Slice.hpp>
+#include <Cabana_Types.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <cassert>
+#include <string>
+#include <type_traits>
+
+namespace Cabana
+{
+//---------------------------------------------------------------------------//
+/*!
+  \brief Compressed sparse row (CSR) list of particle triplets.
+
+  \tparam MemorySpace The Kokkos memory space for storing the triplet list.
+
+  For each central particle "i" the list stores every unique pair of
+  neighbors (j,k) of "i" (with j listed before k in the source neighbor list)
+  for which both "j" and "k" are within the angular cutoff of "i". The
+  angular cutoff may be shorter than the cutoff used to build the source
+  neighbor list. The pair filtering is done once at build time such that
+  repeated many-body passes over the same list only iterate the stored
+  triplets.
+*/
+template <class MemorySpace>
+class TripletList
+{
+  public:
+    static_assert( Kokkos::is_memory_space<MemorySpace>::value, "" );
+
+    //! Kokkos memory space in which the triplet list data resides.
+    using memory_space = MemorySpace;
+
+    //! Kokkos default execution space for this memory space.
+    using execution_space = typename memory_space::execution_space;
+
+    //! Number of triplets per central particle.
+    Kokkos::View<int*, memory_space> counts;
+
+    //! Offsets into the triplet list.
+    Kokkos::View<int*, memory_space> offsets;
+
+    //! Triplet list. Each entry stores the (j,k) neighbor ids.
+    Kokkos::View<int* [2], memory_space> triplets;
+
+    /*!
+      \brief Default constructor.
+    */
+    TripletList() {}
+
+    /*!
+      \brief TripletList constructor. Given a list of particle positions and
+      a neighbor list calculate the triplet list.
+
+      \param x The slice containing the particle positions.
+
+      \param begin The beginning particle index to compute triplets for.
+
+      \param end The end particle index to compute triplets for.
+
+      \param list The neighbor list from which triplets are built. This should
+      be a full neighbor list for typical many-body potentials.
+
+      \param angular_radius The cutoff for both neighbors of a triplet. Only
+      neighbors within this radius of the central particle are paired.
+    */
+    template <class PositionSlice, class NeighborListType>
+    TripletList(
+        PositionSlice x, const std::size_t begin, const std::size_t end,
+        const NeighborListType& list,
+        const typename PositionSlice::value_type angular_radius,
+        typename std::enable_if<( is_slice<PositionSlice>::value ),
+                                int>::type* = 0 )
+    {
+        build( x, begin, end, list, angular_radius );
+    }
+
+    /*!
+      \brief Given a list of particle positions and a neighbor list calculate
+      the triplet list.
+    */
+    template <class PositionSlice, class NeighborListType>
+    void build( PositionSlice x, const std::size_t begin,
+                const std::size_t end, const NeighborListType& list,
+                const typename PositionSlice::value_type angular_radius )
+    {
+        // Use the default execution space.
+        build( execution_space{}, x, begin, end, list, angular_radius );
+    }
+
+    /*!
+      \brief Given a list of particle positions and a neighbor list calculate
+      the triplet list.
+    */
+    template <class ExecutionSpace, class PositionSlice,
+              class NeighborListType>
+    void build( ExecutionSpace, PositionSlice x, const std::size_t begin,
+                const std::size_t end, const NeighborListType& list,
+                const typename PositionSlice::value_type angular_radius )
+    {
+        Kokkos::Profiling::pushRegion( "Cabana::TripletList::build" );
+
+        static_assert( is_accessible_from<memory_space, ExecutionSpace>{},
+                       "" );
+
+        assert( end >= begin );
+        assert( end <= x.size() );
+
+        using neighbor_list_traits = NeighborList<NeighborListType>;
+        using value_type = typename PositionSlice::value_type;
+
+        // Neighbors of a particle are only paired if both are within the
+        // angular cutoff.
+        const value_type rsqr = angular_radius * angular_radius;
+
+        // Count the triplets of each particle.
+        auto triplet_counts = Kokkos::View<int*, memory_space>(
+            "triplet_counts", x.size() );
+        Kokkos::RangePolicy<ExecutionSpace> range_policy( begin, end );
+        Kokkos::parallel_for(
+            "Cabana::TripletList::count", range_policy,
+            KOKKOS_LAMBDA( const int i ) {
+                int m = 0;
+                int nn = neighbor_list_traits::numNeighbor( list, i );
+                for ( int n = 0; n < nn; ++n )
+                    if ( distanceSqr( x, i,
+                                      neighbor_list_traits::getNeighbor(
+                                          list, i, n ) ) <= rsqr )
+                        ++m;
+                triplet_counts( i ) = m * ( m - 1 ) / 2;
+            } );
+
+        // Calculate offsets from counts and the total number of triplets.
+        auto triplet_offsets = Kokkos::View<int*, memory_space>(
+            Kokkos::ViewAllocateWithoutInitializing( "triplet_offsets" ),
+            x.size() );
+        int total_num_triplet = 0;
+        Kokkos::parallel_scan(
+            "Cabana::TripletList::offset_scan",
+            Kokkos::RangePolicy<ExecutionSpace>( 0, x.size() ),
+            KOKKOS_LAMBDA( const int i, int& update, const bool final_pass ) {
+                if ( final_pass )
+                    triplet_offsets( i ) = update;
+                update += triplet_counts( i );
+            },
+            total_num_triplet );
+        Kokkos::fence();
+
+        // Allocate and fill the triplets.
+        auto triplet_data = Kokkos::View<int* [2], memory_space>(
+            Kokkos::ViewAllocateWithoutInitializing( "triplets" ),
+            total_num_triplet );
+        Kokkos::parallel_for(
+            "Cabana::TripletList::fill", range_policy,
+            KOKKOS_LAMBDA( const int i ) {
+                int t = triplet_offsets( i );
+                int nn = neighbor_list_traits::numNeighbor( list, i );
+                for ( int n = 0; n < nn; ++n )
+                {
+                    int j = neighbor_list_traits::getNeighbor( list, i, n );
+                    if ( distanceSqr( x, i, j ) > rsqr )
+                        continue;
+                    for ( int a = n + 1; a < nn; ++a )
+                    {
+                        int k =
+                            neighbor_list_traits::getNeighbor( list, i, a );
+                        if ( distanceSqr( x, i, k ) <= rsqr )
+                        {
+                            triplet_data( t, 0 ) = j;
+                            triplet_data( t, 1 ) = k;
+                            ++t;
+                        }
+                    }
+                }
+            } );
+        Kokkos::fence();
+
+        counts = triplet_counts;
+        offsets = triplet_offsets;
+        triplets = triplet_data;
+
+        Kokkos::Profiling::popRegion();
+    }
+
+    //! Get the total number of triplets.
+    KOKKOS_INLINE_FUNCTION
+    std::size_t totalTriplets() const { return triplets.extent( 0 ); }
+
+    //! Get the number of triplets for a given particle index.
+    KOKKOS_INLINE_FUNCTION
+    std::size_t numTriplet( const std::size_t particle_index ) const
+    {
+        return counts( particle_index );
+    }
+
+    //! Get the first neighbor of a triplet for a given particle index and the
+    //! index of the triplet relative to the particle.
+    KOKKOS_INLINE_FUNCTION
+    std::size_t getFirst( const std::size_t particle_index,
+                          const std::size_t triplet_index ) const
+    {
+        return triplets( offsets( particle_index ) + triplet_index, 0 );
+    }
+
+    //! Get the second neighbor of a triplet for a given particle index and the
+    //! index of the triplet relative to the particle.
+    KOKKOS_INLINE_FUNCTION
+    std::size_t getSecond( const std::size_t particle_index,
+                           const std::size_t triplet_index ) const
+    {
+        return triplets( offsets( particle_index ) + triplet_index, 1 );
+    }
+
+  private:
+    // Squared distance between two particles.
+    template <class PositionSlice>
+    KOKKOS_INLINE_FUNCTION static typename PositionSlice::value_type
+    distanceSqr( const PositionSlice& x, const int i, const int j )
+    {
+        typename PositionSlice::value_type dx = x( i, 0 ) - x( j, 0 );
+        typename PositionSlice::value_type dy = x( i, 1 ) - x( j, 1 );
+        typename PositionSlice::value_type dz = x( i, 2 ) - x( j, 2 );
+        return dx * dx + dy * dy + dz * dz;
+    }
+};
+
+//---------------------------------------------------------------------------//
+// Triplet Parallel For
+//---------------------------------------------------------------------------//
+/*!
+  \brief Execute functor in parallel according to the execution policy over
+  particles with a thread-local serial loop over precomputed particle
+  triplets.
+
+  \tparam FunctorType The functor type to execute.
+  \tparam MemorySpace The triplet list memory space.
+  \tparam ExecParams The Kokkos range policy parameters.
+
+  \param exec_policy The policy over which to execute the functor.
+  \param functor The functor to execute in parallel
+  \param list The triplet list over which to execute the neighbor operations.
+  \param SecondNeighborsTag Tag indicating operations over particle first and
+  second neighbors.
+  \param SerialOpTag Tag indicating a serial loop strategy over triplets.
+  \param str Optional name for the functor. Will be forwarded if non-empty to
+  the Kokkos::parallel_for called by this code and can be used for
+  identification and profiling purposes.
+
+  The functor has the same signature as for second neighbor iteration with a
+  neighbor list: <tt>operator()( i, j, k )</tt>.
+*/
+template <class FunctorType, class MemorySpace, class... ExecParameters>
+inline void neighbor_parallel_for(
+    const Kokkos::RangePolicy<ExecParameters...>& exec_policy,
+    const FunctorType& functor, const TripletList<MemorySpace>& list,
+    const SecondNeighborsTag, const SerialOpTag, const std::string& str = "" )
+{
+    Kokkos::Profiling::pushRegion( "Cabana::neighbor_parallel_for" );
+
+    using work_tag = typename Kokkos::RangePolicy<ExecParameters...>::work_tag;
+
+    using execution_space =
+        typename Kokkos::RangePolicy<ExecParameters...>::execution_space;
+
+    using index_type =
+        typename Kokkos::RangePolicy<ExecParameters...>::index_type;
+
+    auto begin = exec_policy.begin();
+    auto end = exec_policy.end();
+    using linear_policy_type = Kokkos::RangePolicy<execution_space, void, void>;
+    linear_policy_type linear_exec_policy( begin, end );
+
+    static_assert( is_accessible_from<MemorySpace, execution_space>{}, "" );
+
+    auto neigh_func = KOKKOS_LAMBDA( const index_type i )
+    {
+        const index_type nt = list.numTriplet( i );
+        for ( index_type t = 0; t < nt; ++t )
+        {
+            const index_type j = list.getFirst( i, t );
+            const index_type k = list.getSecond( i, t );
+            Impl::functorTagDispatch<work_tag>( functor, i, j, k );
+        }
+    };
+    if ( str.empty() )
+        Kokkos::parallel_for( linear_exec_policy, neigh_func );
+    else
+        Kokkos::parallel_for( str, linear_exec_policy, neigh_func );
+
+    Kokkos::Profiling::popRegion();
+}
+
+//---------------------------------------------------------------------------//
+/*!
+  \brief Execute functor in parallel according to the execution policy over
+  particles with team parallelism over precomputed particle triplets.
+
+  \tparam FunctorType The functor type to execute.
+  \tparam MemorySpace The triplet list memory space.
+  \tparam ExecParams The Kokkos range policy parameters.
+
+  \param exec_policy The policy over which to execute the functor.
+  \param functor The functor to execute in parallel
+  \param list The triplet list over which to execute the neighbor operations.
+  \param SecondNeighborsTag Tag indicating operations over particle first and
+  second neighbors.
+  \param TeamOpTag Tag indicating a team parallel strategy over triplets.
+  \param str Optional name for the functor. Will be forwarded if non-empty to
+  the Kokkos::parallel_for called by this code and can be used for
+  identification and profiling purposes.
+*/
+template <class FunctorType, class MemorySpace, class... ExecParameters>
+inline void neighbor_parallel_for(
+    const Kokkos::RangePolicy<ExecParameters...>& exec_policy,
+    const FunctorType& functor, const TripletList<MemorySpace>& list,
+    const SecondNeighborsTag, const TeamOpTag, const std::string& str = "" )
+{
+    Kokkos::Profiling::pushRegion( "Cabana::neighbor_parallel_for" );
+
+    using work_tag = typename Kokkos::RangePolicy<ExecParameters...>::work_tag;
+
+    using execution_space =
+        typename Kokkos::RangePolicy<ExecParameters...>::execution_space;
+
+    using kokkos_policy =
+        Kokkos::TeamPolicy<execution_space, Kokkos::Schedule<Kokkos::Dynamic>>;
+    kokkos_policy team_policy( exec_policy.end() - exec_policy.begin(),
+                               Kokkos::AUTO );
+
+    using index_type = typename kokkos_policy::index_type;
+
+    static_assert( is_accessible_from<MemorySpace, execution_space>{}, "" );
+
+    const auto range_begin = exec_policy.begin();
+
+    auto neigh_func =
+        KOKKOS_LAMBDA( const typename kokkos_policy::member_type& team )
+    {
+        index_type i = team.league_rank() + range_begin;
+        Kokkos::parallel_for(
+            Kokkos::TeamThreadRange( team, list.numTriplet( i ) ),
+            [&]( const index_type t )
+            {
+                const index_type j = list.getFirst( i, t );
+                const index_type k = list.getSecond( i, t );
+                Impl::functorTagDispatch<work_tag>( functor, i, j, k );
+            } );
+    };
+    if ( str.empty() )
+        Kokkos::parallel_for( team_policy, neigh_func );
+    else
+        Kokkos::parallel_for( str, team_policy, neigh_func );
+
+    Kokkos::Profiling::popRegion();
+}
+
+//---------------------------------------------------------------------------//
+// Triplet Parallel Reduce
+//---------------------------------------------------------------------------//
+/*!
+  \brief Execute functor reduction in parallel according to the execution policy
+  over particles with a thread-local serial loop over precomputed particle
+  triplets.
+
+  \tparam FunctorType The functor type to execute.
+  \tparam MemorySpace The triplet list memory space.
+  \tparam ReduceType The reduction type.
+  \tparam ExecParams The Kokkos range policy parameters.
+
+  \param exec_policy The policy over which to execute the functor.
+  \param functor The functor to execute in parallel
+  \param list The triplet list over which to execute the neighbor operations.
+  \param SecondNeighborsTag Tag indicating operations over particle first and
+  second neighbors.
+  \param SerialOpTag Tag indicating a serial loop strategy over triplets.
+  \param reduce_val Scalar to be reduced across particles and triplets.
+  \param str Optional name for the functor. Will be forwarded if non-empty to
+  the Kokkos::parallel_reduce called by this code and can be used for
+  identification and profiling purposes.
+*/
+template <class FunctorType, class MemorySpace, class ReduceType,
+          class... ExecParameters>
+inline void neighbor_parallel_reduce(
+    const Kokkos::RangePolicy<ExecParameters...>& exec_policy,
+    const FunctorType& functor, const TripletList<MemorySpace>& list,
+    const SecondNeighborsTag, const SerialOpTag, ReduceType& reduce_val,
+    const std::string& str = "" )
+{
+    Kokkos::Profiling::pushRegion( "Cabana::neighbor_parallel_reduce" );
+
+    using work_tag = typename Kokkos::RangePolicy<ExecParameters...>::work_tag;
+
+    using execution_space =
+        typename Kokkos::RangePolicy<ExecParameters...>::execution_space;
+
+    using index_type =
+        typename Kokkos::RangePolicy<ExecParameters...>::index_type;
+
+    auto begin = exec_policy.begin();
+    auto end = exec_policy.end();
+    using linear_policy_type = Kokkos::RangePolicy<execution_space, void, void>;
+    linear_policy_type linear_exec_policy( begin, end );
+
+    static_assert( is_accessible_from<MemorySpace, execution_space>{}, "" );
+
+    auto neigh_reduce = KOKKOS_LAMBDA( const index_type i, ReduceType& ival )
+    {
+        const index_type nt = list.numTriplet( i );
+        for ( index_type t = 0; t < nt; ++t )
+        {
+            const index_type j = list.getFirst( i, t );
+            const index_type k = list.getSecond( i, t );
+            Impl::functorTagDispatch<work_tag>( functor, i, j, k, ival );
+        }
+    };
+    if ( str.empty() )
+        Kokkos::parallel_reduce( linear_exec_policy, neigh_reduce, reduce_val );
+    else
+        Kokkos::parallel_reduce( str, linear_exec_policy, neigh_reduce,
+                                 reduce_val );
+
+    Kokkos::Profiling::popRegion();
+}
+
+//---------------------------------------------------------------------------//
+/*!
+  \brief Execute functor reduction in parallel according to the execution policy
+  over particles with team parallelism over precomputed particle triplets.
+
+  \tparam FunctorType The functor type to execute.
+  \tparam MemorySpace The triplet list memory space.
+  \tparam ReduceType The reduction type.
+  \tparam ExecParams The Kokkos range policy parameters.
+
+  \param exec_policy The policy over which to execute the functor.
+  \param functor The functor to execute in parallel
+  \param list The triplet list over which to execute the neighbor operations.
+  \param SecondNeighborsTag Tag indicating operations over particle first and
+  second neighbors.
+  \param TeamOpTag Tag indicating a team parallel strategy over triplets.
+  \param reduce_val Scalar to be reduced across particles and triplets.
+  \param str Optional name for the functor. Will be forwarded if non-empty to
+  the Kokkos::parallel_reduce called by this code and can be used for
+  identification and profiling purposes.
+*/
+template <class FunctorType, class MemorySpace, class ReduceType,
+          class... ExecParameters>
+inline void neighbor_parallel_reduce(
+    const Kokkos::RangePolicy<ExecParameters...>& exec_policy,
+    const FunctorType& functor, const TripletList<MemorySpace>& list,
+    const SecondNeighborsTag, const TeamOpTag, ReduceType& reduce_val,
+    const std::string& str = "" )
+{
+    Kokkos::Profiling::pushRegion( "Cabana::neighbor_parallel_reduce" );
+
+    using work_tag = typename Kokkos::RangePolicy<ExecParameters...>::work_tag;
+
+    using execution_space =
+        typename Kokkos::RangePolicy<ExecParameters...>::execution_space;
+
+    using kokkos_policy =
+        Kokkos::TeamPolicy<execution_space, Kokkos::Schedule<Kokkos::Dynamic>>;
+    kokkos_policy team_policy( exec_policy.end() - exec_policy.begin(),
+                               Kokkos::AUTO );
+
+    using index_type = typename kokkos_policy::index_type;
+
+    static_assert( is_accessible_from<MemorySpace, execution_space>{}, "" );
+
+    const auto range_begin = exec_policy.begin();
+
+    auto neigh_reduce = KOKKOS_LAMBDA(
+        const typename kokkos_policy::member_type& team, ReduceType& ival )
+    {
+        index_type i = team.league_rank() + range_begin;
+        ReduceType reduce_t = 0;
+
+        Kokkos::parallel_reduce(
+            Kokkos::TeamThreadRange( team, list.numTriplet( i ) ),
+            [&]( const index_type t, ReduceType& tval )
+            {
+                const index_type j = list.getFirst( i, t );
+                const index_type k = list.getSecond( i, t );
+                Impl::functorTagDispatch<work_tag>( functor, i, j, k, tval );
+            },
+            reduce_t );
+        Kokkos::single( Kokkos::PerTeam( team ), [&]() { ival += reduce_t; } );
+    };
+    if ( str.empty() )
+        Kokkos::parallel_reduce( team_policy, neigh_reduce, reduce_val );
+    else
+        Kokkos::parallel_reduce( str, team_policy, neigh_reduce, reduce_val );
+
+    Kokkos::Profiling::popRegion();
+}
+
+//---------------------------------------------------------------------------//
+
+} // end namespace Cabana
+
+#endif // end CABANA_TRIPLETLIST_HPP
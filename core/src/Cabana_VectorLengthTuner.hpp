@@ -0,0 +1,240 @@
+/****************************************************************************
+ * Copyright (c) 2018-2022 by the Cabana authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the Cabana library. Cabana is distributed under a   *
+ * BSD 3-clause license. For the licensing terms see the LICENSE file in    *
+ * the top-level directory.                                                 *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+/*!
+  \file Cabana_VectorLengthTuner.hpp
+  \brief Runtime selection of the AoSoA vector length
+*/
+#ifndef CABANA_VECTORLENGTHTUNER_HPP
+#define CABANA_VECTORLENGTHTUNER_HPP
+
+#include <Cabana_AoSoA.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <cstddef>
+#include <limits>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace Cabana
+{
+//---------------------------------------------------------------------------//
+//! Compile-time list of candidate AoSoA vector lengths.
+template <int... VectorLengths>
+struct VectorLengthList
+{
+    //! Number of candidates.
+    static constexpr std::size_t size = sizeof...( VectorLengths );
+};
+
+//---------------------------------------------------------------------------//
+//! \cond Impl
+namespace Impl
+{
+template <class Functor>
+void dispatchVectorLength( const int, VectorLengthList<>, Functor&& )
+{
+    throw std::runtime_error( "Vector length is not one of the candidates" );
+}
+
+template <int VectorLength, int... VectorLengths, class Functor>
+void dispatchVectorLength( const int vector_length,
+                           VectorLengthList<VectorLength, VectorLengths...>,
+                           Functor&& functor )
+{
+    if ( VectorLength == vector_length )
+        functor( std::integral_constant<int, VectorLength>() );
+    else
+        dispatchVectorLength( vector_length,
+                              VectorLengthList<VectorLengths...>(),
+                              std::forward<Functor>( functor ) );
+}
+} // namespace Impl
+//! \endcond
+
+/*!
+  \brief Call a functor with a runtime vector length as a compile-time
+  constant.
+
+  \param vector_length The vector length. Must be one of the candidates.
+
+  \param candidates The candidate vector lengths instantiated.
+
+  \param functor Functor called with std::integral_constant<int, V> where V
+  is the vector length.
+*/
+template <int... VectorLengths, class Functor>
+void dispatchVectorLength( const int vector_length,
+                           VectorLengthList<VectorLengths...> candidates,
+                           Functor&& functor )
+{
+    Impl::dispatchVectorLength( vector_length, candidates,
+                                std::forward<Functor>( functor ) );
+}
+
+//---------------------------------------------------------------------------//
+/*!
+  \brief Select the vector length of an AoSoA type at runtime by timing a
+  representative kernel for each candidate.
+
+  \tparam DataTypes The AoSoA member types.
+
+  \tparam DeviceType The AoSoA device type.
+
+  \tparam Candidates The VectorLengthList of candidates.
+
+  The best inner array size depends on the member sizes, the kernels and the
+  hardware. The tuner instantiates only the given candidates, so code paths
+  written as templates on the vector length are compiled once per candidate
+  and the choice made at startup is applied with dispatch().
+*/
+template <class DataTypes, class DeviceType, class Candidates>
+class VectorLengthTuner;
+
+//! \cond Impl
+template <class DataTypes, class DeviceType, int... VectorLengths>
+class VectorLengthTuner<DataTypes, DeviceType,
+                        VectorLengthList<VectorLengths...>>
+//! \endcond
+{
+  public:
+    static_assert( sizeof...( VectorLengths ) > 0,
+                   "At least one candidate vector length is required" );
+
+    //! Candidate vector lengths.
+    using candidates = VectorLengthList<VectorLengths...>;
+
+    //! AoSoA type for a candidate vector length.
+    template <int VectorLength>
+    using aosoa_type = AoSoA<DataTypes, DeviceType, VectorLength>;
+
+    /*!
+      \brief Constructor. The selected vector length is the first candidate
+      until tune() is called.
+
+      \param label Label used when reporting.
+    */
+    VectorLengthTuner( const std::string& label = "" )
+        : _label( label )
+        , _vector_length( firstCandidate( VectorLengths... ) )
+    {
+    }
+
+    /*!
+      \brief Time a kernel for each candidate and select the fastest.
+
+      \param num_particle The number of particles in the timed AoSoAs.
+
+      \param kernel Callable taking a non-const reference to an AoSoA of any
+      candidate vector length (e.g. a generic lambda). The AoSoA contents are
+      uninitialized on the first call so the kernel must fill any data it
+      reads.
+
+      \param num_run The number of timed runs per candidate after one warm
+      up run. The minimum time is used.
+
+      \return The selected vector length.
+    */
+    template <class KernelType>
+    int tune( const std::size_t num_particle, const KernelType& kernel,
+              const int num_run = 5 )
+    {
+        _times.clear();
+        ( timeCandidate<VectorLengths>( num_particle, kernel, num_run ), ... );
+
+        std::size_t best = 0;
+        for ( std::size_t c = 1; c < _times.size(); ++c )
+            if ( _times[c] < _times[best] )
+                best = c;
+        _vector_length = candidateLengths()[best];
+        return _vector_length;
+    }
+
+    //! Get the selected vector length.
+    int vectorLength() const { return _vector_length; }
+
+    //! Get the candidate vector lengths.
+    static std::vector<int> candidateLengths() { return { VectorLengths... }; }
+
+    //! Get the minimum run time in seconds of each candidate from tune().
+    const std::vector<double>& times() const { return _times; }
+
+    //! Write the timings and the selected vector length.
+    void report( std::ostream& stream ) const
+    {
+        stream << "Cabana::VectorLengthTuner";
+        if ( !_label.empty() )
+            stream << " " << _label;
+        stream << ":";
+        auto lengths = candidateLengths();
+        for ( std::size_t c = 0; c < _times.size(); ++c )
+            stream << " " << lengths[c] << " (" << _times[c] << " s)";
+        stream << " selected " << _vector_length << "\n";
+    }
+
+    /*!
+      \brief Call a functor with the selected vector length.
+
+      \param functor Functor called with std::integral_constant<int, V> where
+      V is the selected vector length, e.g. to construct an
+      aosoa_type<V> and run the application with it.
+    */
+    template <class Functor>
+    void dispatch( Functor&& functor ) const
+    {
+        dispatchVectorLength( _vector_length, candidates(),
+                              std::forward<Functor>( functor ) );
+    }
+
+  private:
+    template <class... Ints>
+    static constexpr int firstCandidate( const int first, Ints... )
+    {
+        return first;
+    }
+
+    template <int VectorLength, class KernelType>
+    void timeCandidate( const std::size_t num_particle,
+                        const KernelType& kernel, const int num_run )
+    {
+        aosoa_type<VectorLength> aosoa( "Cabana::VectorLengthTuner",
+                                        num_particle );
+        kernel( aosoa );
+        Kokkos::fence();
+
+        double best = std::numeric_limits<double>::max();
+        for ( int r = 0; r < num_run; ++r )
+        {
+            Kokkos::Timer timer;
+            kernel( aosoa );
+            Kokkos::fence();
+            double time = timer.seconds();
+            if ( time < best )
+                best = time;
+        }
+        _times.push_back( best );
+    }
+
+    std::string _label;
+    int _vector_length;
+    std::vector<double> _times;
+};
+
+//---------------------------------------------------------------------------//
+
+} // end namespace Cabana
+
+#endif // end CABANA_VECTORLENGTHTUNER_HPP
@@ -70,6 +70,13 @@ struct VerletListData<MemorySpace, VerletLayoutCSR>
                    Kokkos::atomic_fetch_add( &counts( pid ), 1 ) ) = nid;
     }
 
+    //! Get a neighbor in the list.
+    KOKKOS_INLINE_FUNCTION
+    int getNeighbor( const int pid, const int nid ) const
+    {
+        return neighbors( offsets( pid ) + nid );
+    }
+
     //! Modify a neighbor in the list.
     KOKKOS_INLINE_FUNCTION
     void setNeighbor( const int pid, const int nid, const int new_id ) const
@@ -100,6 +107,13 @@ struct VerletListData<MemorySpace, VerletLayout2D>
             neighbors( pid, count ) = nid;
     }
 
+    //! Get a neighbor in the list.
+    KOKKOS_INLINE_FUNCTION
+    int getNeighbor( const int pid, const int nid ) const
+    {
+        return neighbors( pid, nid );
+    }
+
     //! Modify a neighbor in the list.
     KOKKOS_INLINE_FUNCTION
     void setNeighbor( const int pid, const int nid, const int new_id ) const
@@ -208,6 +222,60 @@ struct LinkedCellStencil
     }
 };
 
+//---------------------------------------------------------------------------//
+// Apply a functor to each neighbor of a single particle found by searching the
+// cell stencil of a linked cell list.
+template <class AlgorithmTag, class PositionSlice, class LinkedCellListType,
+          class Scalar, class NeighborFunctor>
+KOKKOS_INLINE_FUNCTION void
+forEachStencilNeighbor( const int pid, const PositionSlice& position,
+                        const LinkedCellListType& linked_cell_list,
+                        const LinkedCellStencil<Scalar>& cell_stencil,
+                        const NeighborFunctor& functor )
+{
+    // Cache the particle coordinates.
+    double x_p = position( pid, 0 );
+    double y_p = position( pid, 1 );
+    double z_p = position( pid, 2 );
+
+    // Get the stencil for the cell containing the particle.
+    int ic, jc, kc;
+    cell_stencil.grid.locatePoint( x_p, y_p, z_p, ic, jc, kc );
+    int cell = cell_stencil.grid.cardinalCellIndex( ic, jc, kc );
+    int imin, imax, jmin, jmax, kmin, kmax;
+    cell_stencil.getCells( cell, imin, imax, jmin, jmax, kmin, kmax );
+
+    // Loop over the cell stencil.
+    for ( int i = imin; i < imax; ++i )
+        for ( int j = jmin; j < jmax; ++j )
+            for ( int k = kmin; k < kmax; ++k )
+            {
+                if ( cell_stencil.grid.minDistanceToPoint( x_p, y_p, z_p, i, j,
+                                                           k ) >
+                     cell_stencil.rsqr )
+                    continue;
+
+                std::size_t n_offset = linked_cell_list.binOffset( i, j, k );
+                int num_n = linked_cell_list.binSize( i, j, k );
+                for ( int n = 0; n < num_n; ++n )
+                {
+                    int nid = linked_cell_list.permutation( n_offset + n );
+                    double x_n = position( nid, 0 );
+                    double y_n = position( nid, 1 );
+                    double z_n = position( nid, 2 );
+                    if ( NeighborDiscriminator<AlgorithmTag>::isValid(
+                             pid, x_p, y_p, z_p, nid, x_n, y_n, z_n ) )
+                    {
+                        Scalar dx = x_p - x_n;
+                        Scalar dy = y_p - y_n;
+                        Scalar dz = z_p - z_n;
+                        if ( dx * dx + dy * dy + dz * dz <= cell_stencil.rsqr )
+                            functor( nid );
+                    }
+                }
+            }
+}
+
 //---------------------------------------------------------------------------//
 // Verlet List Builder
 //---------------------------------------------------------------------------//
@@ -255,6 +323,21 @@ struct VerletListBuilder
                        const PositionValueType grid_min[3],
                        const PositionValueType grid_max[3],
                        const std::size_t max_neigh )
+        : VerletListBuilder( slice, begin, end, slice.size(),
+                             neighborhood_radius, cell_size_ratio, grid_min,
+                             grid_max, max_neigh )
+    {
+    }
+
+    // Constructor with candidate neighbors restricted to the particle range
+    // [0,candidate_end).
+    VerletListBuilder( PositionSlice slice, const std::size_t begin,
+                       const std::size_t end, const std::size_t candidate_end,
+                       const PositionValueType neighborhood_radius,
+                       const PositionValueType cell_size_ratio,
+                       const PositionValueType grid_min[3],
+                       const PositionValueType grid_max[3],
+                       const std::size_t max_neigh )
         : pid_begin( begin )
         , pid_end( end )
         , cell_stencil( neighborhood_radius, cell_size_ratio, grid_min,
@@ -275,13 +358,13 @@ struct VerletListBuilder
         position = slice;
 
         // Bin the particles in the grid. Don't actually sort them but make a
-        // permutation vector. Note that we are binning all particles here and
-        // not just the requested range. This is because all particles are
-        // treated as candidates for neighbors.
+        // permutation vector. Note that we are binning all candidate
+        // particles here and not just the requested range. This is because
+        // all candidate particles are treated as potential neighbors.
         double grid_size = cell_size_ratio * neighborhood_radius;
         PositionValueType grid_delta[3] = { grid_size, grid_size, grid_size };
-        linked_cell_list =
-            LinkedCellList<device>( position, grid_delta, grid_min, grid_max );
+        linked_cell_list = LinkedCellList<device>(
+            position, 0, candidate_end, grid_delta, grid_min, grid_max );
         bin_data_1d = linked_cell_list.binningData();
 
         // We will use the square of the distance for neighbor determination.
@@ -667,6 +750,14 @@ class VerletList
     //! Verlet list data.
     VerletListData<memory_space, LayoutTag> _data;
 
+    //! Number of locally owned neighbors per particle. Locally owned
+    //! neighbors are stored before ghosted neighbors in each row.
+    Kokkos::View<int*, memory_space> _local_counts;
+
+    //! Number of locally owned particles. Particles with larger indices are
+    //! ghosts.
+    std::size_t _num_local = 0;
+
     /*!
       \brief Default constructor.
     */
@@ -741,8 +832,8 @@ class VerletList
       calculate the neighbor list.
     */
     template <class PositionSlice, class ExecutionSpace>
-    void build( ExecutionSpace, PositionSlice x, const std::size_t begin,
-                const std::size_t end,
+    void build( ExecutionSpace exec_space, PositionSlice x,
+                const std::size_t begin, const std::size_t end,
                 const typename PositionSlice::value_type neighborhood_radius,
                 const typename PositionSlice::value_type cell_size_ratio,
                 const typename PositionSlice::value_type grid_min[3],
@@ -751,10 +842,475 @@ class VerletList
     {
         Kokkos::Profiling::pushRegion( "Cabana::VerletList::build" );
 
+        assert( end >= begin );
+        assert( end <= x.size() );
+
+        buildImpl( exec_space, x, begin, end, x.size(), neighborhood_radius,
+                   cell_size_ratio, grid_min, grid_max, max_neigh );
+
+        // All particles are treated as locally owned.
+        _num_local = x.size();
+        _local_counts = _data.counts;
+
+        Kokkos::Profiling::popRegion();
+    }
+
+    /*!
+      \brief Given a list of particle positions with locally owned particles
+      followed by ghosted particles, calculate the neighbor list of the
+      locally owned particles.
+
+      \param x The slice containing the particle positions. Locally owned
+      particles are stored in [0,num_local) and ghosted particles in
+      [num_local,num_local+num_ghost), as laid out by Cabana::Halo.
+
+      \param num_local The number of locally owned particles.
+
+      \param num_ghost The number of ghosted particles.
+
+      \param neighborhood_radius The radius of the neighborhood.
+
+      \param cell_size_ratio The ratio of the cell size in the Cartesian grid
+      to the neighborhood radius.
+
+      \param grid_min The minimum value of the grid containing the particles
+      (including ghosts) in each dimension.
+
+      \param grid_max The maximum value of the grid containing the particles
+      (including ghosts) in each dimension.
+
+      \param max_neigh Optional maximum number of neighbors per particle to
+      pre-allocate the neighbor list (2D layout only).
+
+      Neighbors are only computed for locally owned particles and only
+      locally owned and ghosted particles are binned as candidates, so
+      ghost-ghost pairs and any particles beyond the ghosts are never
+      considered. Each row of the list is partitioned such that the locally
+      owned neighbors come first, followed by the ghosted neighbors (see
+      numLocalNeighbor()).
+
+      For half neighbor lists a pair is stored only if the neighbor is
+      greater than the particle in (x,y,z) lexicographic order. Ghosted
+      positions are consistent images of particles owned by another rank (or
+      periodic images), so a local-ghost pair is stored on exactly one rank.
+      Contributions accumulated on ghosts must then be returned to their
+      owners with a reverse communication (e.g. Cabana::scatter).
+    */
+    template <class PositionSlice>
+    void buildWithGhosts(
+        PositionSlice x, const std::size_t num_local,
+        const std::size_t num_ghost,
+        const typename PositionSlice::value_type neighborhood_radius,
+        const typename PositionSlice::value_type cell_size_ratio,
+        const typename PositionSlice::value_type grid_min[3],
+        const typename PositionSlice::value_type grid_max[3],
+        const std::size_t max_neigh = 0 )
+    {
+        // Use the default execution space.
+        buildWithGhosts( execution_space{}, x, num_local, num_ghost,
+                         neighborhood_radius, cell_size_ratio, grid_min,
+                         grid_max, max_neigh );
+    }
+
+    /*!
+      \brief Given a list of particle positions with locally owned particles
+      followed by ghosted particles, calculate the neighbor list of the
+      locally owned particles.
+    */
+    template <class PositionSlice, class ExecutionSpace>
+    void buildWithGhosts(
+        ExecutionSpace exec_space, PositionSlice x, const std::size_t num_local,
+        const std::size_t num_ghost,
+        const typename PositionSlice::value_type neighborhood_radius,
+        const typename PositionSlice::value_type cell_size_ratio,
+        const typename PositionSlice::value_type grid_min[3],
+        const typename PositionSlice::value_type grid_max[3],
+        const std::size_t max_neigh = 0 )
+    {
+        Kokkos::Profiling::pushRegion(
+            "Cabana::VerletList::buildWithGhosts" );
+
+        assert( num_local + num_ghost <= x.size() );
+
+        buildImpl( exec_space, x, 0, num_local, num_local + num_ghost,
+                   neighborhood_radius, cell_size_ratio, grid_min, grid_max,
+                   max_neigh );
+
+        // Partition each row such that the locally owned neighbors are
+        // first.
+        _num_local = num_local;
+        _local_counts = Kokkos::View<int*, memory_space>(
+            "local_neighbor_counts", _data.counts.size() );
+        auto data = _data;
+        auto local_counts = _local_counts;
+        const int local_end = num_local;
+        Kokkos::parallel_for(
+            "Cabana::VerletList::partition_ghosts",
+            Kokkos::RangePolicy<ExecutionSpace>( exec_space, 0, num_local ),
+            KOKKOS_LAMBDA( const int pid ) {
+                int lo = 0;
+                int hi = data.counts( pid ) - 1;
+                while ( lo <= hi )
+                {
+                    int nid = data.getNeighbor( pid, lo );
+                    if ( nid < local_end )
+                    {
+                        ++lo;
+                    }
+                    else
+                    {
+                        data.setNeighbor( pid, lo,
+                                          data.getNeighbor( pid, hi ) );
+                        data.setNeighbor( pid, hi, nid );
+                        --hi;
+                    }
+                }
+                local_counts( pid ) = lo;
+            } );
+        Kokkos::fence();
+
+        Kokkos::Profiling::popRegion();
+    }
+
+    /*!
+      \brief Incrementally update the neighbor list after a subset of
+      particles has moved or been inserted.
+
+      \param x The slice containing the updated particle positions.
+
+      \param changed View of the ids of all particles that moved since the
+      last build or update. Particles inserted at the end of the slice since
+      the last build or update must be included.
+
+      \param neighborhood_radius The radius of the neighborhood.
+
+      \param cell_size_ratio The ratio of the cell size in the Cartesian grid
+      to the neighborhood radius.
+
+      \param grid_min The minimum value of the grid containing the particles
+      in each dimension.
+
+      \param grid_max The maximum value of the grid containing the particles
+      in each dimension.
+
+      Only the rows of the changed particles and of their old and new
+      neighbors are recomputed; all other rows are copied as-is when the list
+      is repacked. The list must previously have been built for all particles
+      (i.e. over the range [0,x.size()) before any insertion). Binning and
+      repacking are linear in the number of particles, but the neighbor
+      search, which dominates the cost of a full build, is proportional to
+      the number of affected rows.
+    */
+    template <class PositionSlice, class IdViewType>
+    void update( PositionSlice x, const IdViewType& changed,
+                 const typename PositionSlice::value_type neighborhood_radius,
+                 const typename PositionSlice::value_type cell_size_ratio,
+                 const typename PositionSlice::value_type grid_min[3],
+                 const typename PositionSlice::value_type grid_max[3] )
+    {
+        // Use the default execution space.
+        update( execution_space{}, x, changed, neighborhood_radius,
+                cell_size_ratio, grid_min, grid_max );
+    }
+
+    /*!
+      \brief Incrementally update the neighbor list after a subset of
+      particles has moved or been inserted.
+    */
+    template <class ExecutionSpace, class PositionSlice, class IdViewType>
+    void update( ExecutionSpace, PositionSlice x, const IdViewType& changed,
+                 const typename PositionSlice::value_type neighborhood_radius,
+                 const typename PositionSlice::value_type cell_size_ratio,
+                 const typename PositionSlice::value_type grid_min[3],
+                 const typename PositionSlice::value_type grid_max[3] )
+    {
+        Kokkos::Profiling::pushRegion( "Cabana::VerletList::update" );
+
+        static_assert( is_accessible_from<memory_space, ExecutionSpace>{}, "" );
+        static_assert(
+            is_accessible_from<typename IdViewType::memory_space,
+                               ExecutionSpace>{},
+            "" );
+
+        using device_type = Kokkos::Device<ExecutionSpace, memory_space>;
+        using value_type = typename PositionSlice::value_type;
+
+        std::size_t num_particle = x.size();
+        std::size_t old_num_particle = _data.counts.size();
+        assert( num_particle >= old_num_particle );
+
+        // Bin the particles with the same grid used for a full build.
+        Impl::LinkedCellStencil<value_type> cell_stencil(
+            neighborhood_radius, cell_size_ratio, grid_min, grid_max );
+        value_type grid_size = cell_size_ratio * neighborhood_radius;
+        value_type grid_delta[3] = { grid_size, grid_size, grid_size };
+        LinkedCellList<device_type> linked_cell_list( x, grid_delta, grid_min,
+                                                      grid_max );
+
+        // Flag the changed particles along with their old and new neighbors.
+        Kokkos::View<int*, memory_space> affected( "affected_rows",
+                                                  num_particle );
+        auto data = _data;
+        Kokkos::parallel_for(
+            "Cabana::VerletList::update::flag_rows",
+            Kokkos::RangePolicy<ExecutionSpace>( 0, changed.extent( 0 ) ),
+            KOKKOS_LAMBDA( const int c ) {
+                int pid = changed( c );
+                affected( pid ) = 1;
+                if ( pid < static_cast<int>( old_num_particle ) )
+                    for ( int n = 0; n < data.counts( pid ); ++n )
+                        affected( data.getNeighbor( pid, n ) ) = 1;
+                Impl::forEachStencilNeighbor<FullNeighborTag>(
+                    pid, x, linked_cell_list, cell_stencil,
+                    [&]( const int nid ) { affected( nid ) = 1; } );
+            } );
+        flagRowsWithChanged( AlgorithmTag(), ExecutionSpace(), changed,
+                             affected, old_num_particle );
+        Kokkos::fence();
+
+        // Compact the affected rows.
+        Kokkos::View<int*, memory_space> rows(
+            Kokkos::ViewAllocateWithoutInitializing( "update_rows" ),
+            num_particle );
+        int num_rows = 0;
+        Kokkos::parallel_scan(
+            "Cabana::VerletList::update::compact_rows",
+            Kokkos::RangePolicy<ExecutionSpace>( 0, num_particle ),
+            KOKKOS_LAMBDA( const int i, int& update, const bool final_pass ) {
+                if ( affected( i ) )
+                {
+                    if ( final_pass )
+                        rows( update ) = i;
+                    ++update;
+                }
+            },
+            num_rows );
+
+        // Count the new neighbors of the affected rows.
+        Kokkos::View<int*, memory_space> row_counts( "update_row_counts",
+                                                    num_rows );
+        Kokkos::parallel_for(
+            "Cabana::VerletList::update::count_rows",
+            Kokkos::RangePolicy<ExecutionSpace>( 0, num_rows ),
+            KOKKOS_LAMBDA( const int r ) {
+                int count = 0;
+                Impl::forEachStencilNeighbor<AlgorithmTag>(
+                    rows( r ), x, linked_cell_list, cell_stencil,
+                    [&]( const int ) { ++count; } );
+                row_counts( r ) = count;
+            } );
+        Kokkos::fence();
+
+        // Repack the list and fill the affected rows.
+        repack( LayoutTag(), ExecutionSpace(), num_particle, affected, rows,
+                row_counts );
+        auto new_data = _data;
+        Kokkos::parallel_for(
+            "Cabana::VerletList::update::fill_rows",
+            Kokkos::RangePolicy<ExecutionSpace>( 0, num_rows ),
+            KOKKOS_LAMBDA( const int r ) {
+                int pid = rows( r );
+                int n = 0;
+                Impl::forEachStencilNeighbor<AlgorithmTag>(
+                    pid, x, linked_cell_list, cell_stencil,
+                    [&]( const int nid )
+                    {
+                        new_data.setNeighbor( pid, n, nid );
+                        ++n;
+                    } );
+            } );
+        Kokkos::fence();
+
+        // All particles are treated as locally owned.
+        _num_local = num_particle;
+        _local_counts = _data.counts;
+
+        Kokkos::Profiling::popRegion();
+    }
+
+    //! Get the number of locally owned neighbors for a given particle
+    //! index. These are the first neighbors stored for the particle.
+    KOKKOS_INLINE_FUNCTION
+    std::size_t numLocalNeighbor( const std::size_t particle_index ) const
+    {
+        return _local_counts( particle_index );
+    }
+
+    //! Determine if a particle index refers to a ghosted particle.
+    KOKKOS_INLINE_FUNCTION
+    bool isGhost( const std::size_t particle_index ) const
+    {
+        return particle_index >= _num_local;
+    }
+
+    //! Modify a neighbor in the list; for example, mark it as a broken bond.
+    KOKKOS_INLINE_FUNCTION
+    void setNeighbor( const std::size_t particle_index,
+                      const std::size_t neighbor_index,
+                      const int new_index ) const
+    {
+        _data.setNeighbor( particle_index, neighbor_index, new_index );
+    }
+
+  private:
+    // Full lists are symmetric so the rows containing a changed particle are
+    // already flagged as its old neighbors.
+    template <class ExecutionSpace, class IdViewType>
+    void flagRowsWithChanged( FullNeighborTag, ExecutionSpace,
+                              const IdViewType&,
+                              const Kokkos::View<int*, memory_space>&,
+                              const std::size_t )
+    {
+    }
+
+    // Half lists store a pair in only one of the two rows so search all rows
+    // for the changed particles.
+    template <class ExecutionSpace, class IdViewType>
+    void flagRowsWithChanged( HalfNeighborTag, ExecutionSpace,
+                              const IdViewType& changed,
+                              const Kokkos::View<int*, memory_space>& affected,
+                              const std::size_t old_num_particle )
+    {
+        Kokkos::View<int*, memory_space> is_changed( "is_changed",
+                                                    affected.size() );
+        Kokkos::parallel_for(
+            "Cabana::VerletList::update::mark_changed",
+            Kokkos::RangePolicy<ExecutionSpace>( 0, changed.extent( 0 ) ),
+            KOKKOS_LAMBDA( const int c ) { is_changed( changed( c ) ) = 1; } );
+        auto data = _data;
+        Kokkos::parallel_for(
+            "Cabana::VerletList::update::flag_half_rows",
+            Kokkos::RangePolicy<ExecutionSpace>( 0, old_num_particle ),
+            KOKKOS_LAMBDA( const int pid ) {
+                for ( int n = 0; n < data.counts( pid ); ++n )
+                    if ( is_changed( data.getNeighbor( pid, n ) ) )
+                    {
+                        affected( pid ) = 1;
+                        break;
+                    }
+            } );
+    }
+
+    // Repack the CSR list with the new counts of the affected rows, copying
+    // the unaffected rows.
+    template <class ExecutionSpace>
+    void repack( VerletLayoutCSR, ExecutionSpace,
+                 const std::size_t num_particle,
+                 const Kokkos::View<int*, memory_space>& affected,
+                 const Kokkos::View<int*, memory_space>& rows,
+                 const Kokkos::View<int*, memory_space>& row_counts )
+    {
+        auto old_data = _data;
+        std::size_t old_num_particle = old_data.counts.size();
+
+        // Update the counts.
+        Kokkos::View<int*, memory_space> counts( "num_neighbors",
+                                                num_particle );
+        Kokkos::deep_copy(
+            Kokkos::subview( counts,
+                             Kokkos::pair<std::size_t, std::size_t>(
+                                 0, old_num_particle ) ),
+            old_data.counts );
+        Kokkos::parallel_for(
+            "Cabana::VerletList::update::set_counts",
+            Kokkos::RangePolicy<ExecutionSpace>( 0, row_counts.size() ),
+            KOKKOS_LAMBDA( const int r ) {
+                counts( rows( r ) ) = row_counts( r );
+            } );
+
+        // Calculate the new offsets.
+        Kokkos::View<int*, memory_space> offsets(
+            Kokkos::ViewAllocateWithoutInitializing( "neighbor_offsets" ),
+            num_particle );
+        int total_num_neighbor = 0;
+        Kokkos::parallel_scan(
+            "Cabana::VerletList::update::offset_scan",
+            Kokkos::RangePolicy<ExecutionSpace>( 0, num_particle ),
+            KOKKOS_LAMBDA( const int i, int& update, const bool final_pass ) {
+                if ( final_pass )
+                    offsets( i ) = update;
+                update += counts( i );
+            },
+            total_num_neighbor );
+        Kokkos::fence();
+
+        // Copy the unaffected rows into the new list.
+        Kokkos::View<int*, memory_space> neighbors(
+            Kokkos::ViewAllocateWithoutInitializing( "neighbors" ),
+            total_num_neighbor );
+        Kokkos::parallel_for(
+            "Cabana::VerletList::update::copy_rows",
+            Kokkos::RangePolicy<ExecutionSpace>( 0, num_particle ),
+            KOKKOS_LAMBDA( const int i ) {
+                if ( !affected( i ) )
+                    for ( int n = 0; n < counts( i ); ++n )
+                        neighbors( offsets( i ) + n ) =
+                            old_data.getNeighbor( i, n );
+            } );
+        Kokkos::fence();
+
+        _data.counts = counts;
+        _data.offsets = offsets;
+        _data.neighbors = neighbors;
+    }
+
+    // Resize the 2D list if needed with the new counts of the affected rows.
+    // Unaffected rows are preserved in place.
+    template <class ExecutionSpace>
+    void repack( VerletLayout2D, ExecutionSpace,
+                 const std::size_t num_particle,
+                 const Kokkos::View<int*, memory_space>&,
+                 const Kokkos::View<int*, memory_space>& rows,
+                 const Kokkos::View<int*, memory_space>& row_counts )
+    {
+        int max_num_neighbor = 0;
+        Kokkos::parallel_reduce(
+            "Cabana::VerletList::update::reduce_max",
+            Kokkos::RangePolicy<ExecutionSpace>( 0, row_counts.size() ),
+            KOKKOS_LAMBDA( const int r, int& value ) {
+                if ( row_counts( r ) > value )
+                    value = row_counts( r );
+            },
+            Kokkos::Max<int>( max_num_neighbor ) );
+        Kokkos::fence();
+
+        std::size_t max_n = ( static_cast<std::size_t>( max_num_neighbor ) >
+                              _data.neighbors.extent( 1 ) )
+                                ? max_num_neighbor
+                                : _data.neighbors.extent( 1 );
+        if ( num_particle > _data.counts.size() )
+            Kokkos::resize( _data.counts, num_particle );
+        if ( num_particle > _data.neighbors.extent( 0 ) ||
+             max_n > _data.neighbors.extent( 1 ) )
+            Kokkos::resize( _data.neighbors, num_particle, max_n );
+
+        auto counts = _data.counts;
+        Kokkos::parallel_for(
+            "Cabana::VerletList::update::set_counts",
+            Kokkos::RangePolicy<ExecutionSpace>( 0, row_counts.size() ),
+            KOKKOS_LAMBDA( const int r ) {
+                counts( rows( r ) ) = row_counts( r );
+            } );
+        Kokkos::fence();
+    }
+
+    // Build the list for particles in [begin,end) with candidate neighbors
+    // in [0,candidate_end).
+    template <class PositionSlice, class ExecutionSpace>
+    void
+    buildImpl( ExecutionSpace, PositionSlice x, const std::size_t begin,
+               const std::size_t end, const std::size_t candidate_end,
+               const typename PositionSlice::value_type neighborhood_radius,
+               const typename PositionSlice::value_type cell_size_ratio,
+               const typename PositionSlice::value_type grid_min[3],
+               const typename PositionSlice::value_type grid_max[3],
+               const std::size_t max_neigh )
+    {
         static_assert( is_accessible_from<memory_space, ExecutionSpace>{}, "" );
 
         assert( end >= begin );
-        assert( end <= x.size() );
+        assert( end <= candidate_end );
+        assert( candidate_end <= x.size() );
 
         using device_type = Kokkos::Device<ExecutionSpace, memory_space>;
 
@@ -762,8 +1318,9 @@ class VerletList
         using builder_type =
             Impl::VerletListBuilder<device_type, PositionSlice, AlgorithmTag,
                                     LayoutTag, BuildTag>;
-        builder_type builder( x, begin, end, neighborhood_radius,
-                              cell_size_ratio, grid_min, grid_max, max_neigh );
+        builder_type builder( x, begin, end, candidate_end,
+                              neighborhood_radius, cell_size_ratio, grid_min,
+                              grid_max, max_neigh );
 
         // For each particle in the range check each neighboring bin for
         // neighbor particles. Bins are at least the size of the neighborhood
@@ -804,17 +1361,6 @@ class VerletList
 
         // Get the data from the builder.
         _data = builder._data;
-
-        Kokkos::Profiling::popRegion();
-    }
-
-    //! Modify a neighbor in the list; for example, mark it as a broken bond.
-    KOKKOS_INLINE_FUNCTION
-    void setNeighbor( const std::size_t particle_index,
-                      const std::size_t neighbor_index,
-                      const int new_index ) const
-    {
-        _data.setNeighbor( particle_index, neighbor_index, new_index );
     }
 };
 
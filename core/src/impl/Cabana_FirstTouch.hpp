@@ -0,0 +1,112 @@
+/****************************************************************************
+ * Copyright (c) 2018-2022 by the Cabana authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the Cabana library. Cabana is distributed under a   *
+ * BSD 3-clause license. For the licensing terms see the LICENSE file in    *
+ * the top-level directory.                                                 *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+/*!
+  \file Cabana_FirstTouch.hpp
+  \brief Page placement of host allocations
+*/
+#ifndef CABANA_FIRSTTOUCH_HPP
+#define CABANA_FIRSTTOUCH_HPP
+
+#include <Kokkos_Core.hpp>
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined( __linux__ )
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace Cabana
+{
+namespace Impl
+{
+//---------------------------------------------------------------------------//
+//! Granularity of first touch. Pages at least this large are touched once.
+constexpr std::size_t first_touch_page_size = 4096;
+
+//---------------------------------------------------------------------------//
+/*!
+  \brief Request transparent huge pages for a host allocation.
+
+  Only the whole pages inside the range are advised. Must be called before
+  the range is first touched to have an effect.
+
+  \return True if the advice was given.
+*/
+template <class MemorySpace>
+bool adviseHugePages( MemorySpace, void* ptr, const std::size_t bytes )
+{
+    if ( !Kokkos::SpaceAccessibility<Kokkos::HostSpace,
+                                     MemorySpace>::accessible ||
+         nullptr == ptr )
+        return false;
+
+#if defined( __linux__ ) && defined( MADV_HUGEPAGE )
+    auto page = static_cast<std::uintptr_t>( sysconf( _SC_PAGESIZE ) );
+    auto begin = reinterpret_cast<std::uintptr_t>( ptr );
+    auto end = begin + bytes;
+    begin = ( begin + page - 1 ) / page * page;
+    end = end / page * page;
+    if ( begin >= end )
+        return false;
+    return 0 == madvise( reinterpret_cast<void*>( begin ), end - begin,
+                         MADV_HUGEPAGE );
+#else
+    (void)bytes;
+    return false;
+#endif
+}
+
+//---------------------------------------------------------------------------//
+/*!
+  \brief Touch each page of a new host allocation in parallel.
+
+  Pages are touched with a static schedule so that under a first touch
+  policy the page holding byte b of the allocation is placed on the NUMA
+  domain of the thread that a static RangePolicy over the allocation's
+  elements assigns element b / sizeof(element) to. The contents of the range
+  are undefined afterwards.
+*/
+template <class ExecutionSpace, class MemorySpace>
+void firstTouch( const ExecutionSpace& exec_space, MemorySpace, void* ptr,
+                 const std::size_t bytes )
+{
+    if ( !Kokkos::SpaceAccessibility<Kokkos::HostSpace,
+                                     MemorySpace>::accessible ||
+         !Kokkos::SpaceAccessibility<ExecutionSpace,
+                                     MemorySpace>::accessible ||
+         0 == bytes )
+        return;
+
+    Kokkos::Profiling::pushRegion( "Cabana::firstTouch" );
+
+    char* data = static_cast<char*>( ptr );
+    std::size_t page = first_touch_page_size;
+    std::size_t num_page = ( bytes + page - 1 ) / page;
+    Kokkos::RangePolicy<ExecutionSpace, Kokkos::Schedule<Kokkos::Static>>
+        policy( exec_space, 0, num_page );
+    Kokkos::parallel_for(
+        "Cabana::firstTouch", policy, KOKKOS_LAMBDA( const std::size_t p ) {
+            data[p * page] = 0;
+        } );
+    exec_space.fence();
+
+    Kokkos::Profiling::popRegion();
+}
+
+//---------------------------------------------------------------------------//
+
+} // end namespace Impl
+} // end namespace Cabana
+
+#endif // end CABANA_FIRSTTOUCH_HPP
@@ -11,6 +11,7 @@
 
 #include <Cabana_AoSoA.hpp>
 #include <Cabana_DeepCopy.hpp>
+#include <Cabana_MemoryPool.hpp>
 #include <Cabana_Types.hpp>
 #include <impl/Cabana_Index.hpp>
 
@@ -603,6 +604,161 @@ void testUnmanaged()
     checkDataMembers( aosoa, fval, dval, ival, dim_1, dim_2, dim_3 );
 }
 
+//---------------------------------------------------------------------------//
+// Test capacity growth and shrink hysteresis.
+void testGrowthPolicy()
+{
+    const int vector_length = 16;
+    using DataTypes = Cabana::MemberTypes<double[3], int>;
+    using AoSoA_t = Cabana::AoSoA<DataTypes, TEST_MEMSPACE, vector_length>;
+
+    AoSoA_t aosoa( "aosoa", 32 );
+    EXPECT_EQ( aosoa.growthFactor(), 1.0 );
+    EXPECT_EQ( aosoa.shrinkHysteresis(), 1.0 );
+
+    // Growth is geometric once the capacity is exceeded.
+    aosoa.setGrowthFactor( 2.0 );
+    aosoa.resize( 33 );
+    EXPECT_EQ( aosoa.size(), 33u );
+    EXPECT_EQ( aosoa.capacity(), 64u );
+
+    // No reallocation while the size stays within the capacity.
+    auto data = aosoa.data();
+    for ( int n = 34; n <= 64; ++n )
+        aosoa.resize( n );
+    EXPECT_EQ( aosoa.data(), data );
+    EXPECT_EQ( aosoa.capacity(), 64u );
+
+    // Large requests are still satisfied exactly.
+    aosoa.resize( 300 );
+    EXPECT_EQ( aosoa.capacity(), 304u );
+
+    // Explicit reserves are exact.
+    aosoa.reserve( 320 );
+    EXPECT_EQ( aosoa.capacity(), 320u );
+
+    // Keep excess storage within the hysteresis.
+    aosoa.setShrinkHysteresis( 2.0 );
+    aosoa.resize( 200 );
+    aosoa.shrinkToFit();
+    EXPECT_EQ( aosoa.capacity(), 320u );
+    aosoa.resize( 100 );
+    aosoa.shrinkToFit();
+    EXPECT_EQ( aosoa.capacity(), 112u );
+
+    EXPECT_THROW( aosoa.setGrowthFactor( 0.5 ), std::runtime_error );
+    EXPECT_THROW( aosoa.setShrinkHysteresis( 0.5 ), std::runtime_error );
+}
+
+//---------------------------------------------------------------------------//
+// Test pooled AoSoA storage.
+void testMemoryPool()
+{
+    using DataTypes = Cabana::MemberTypes<double[3], int>;
+    using AoSoA_t = Cabana::AoSoA<DataTypes, TEST_MEMSPACE>;
+    using memory_space = typename AoSoA_t::memory_space;
+    Cabana::MemoryPool<memory_space> pool;
+
+    std::size_t num_data = 100;
+    AoSoA_t aosoa( "aosoa" );
+    aosoa.setMemoryPool( &pool );
+    aosoa.resize( num_data );
+    EXPECT_EQ( pool.numBlocks(), 1u );
+    EXPECT_EQ( pool.numBlocksInUse(), 1u );
+
+    // Fill the data and grow. The data is copied to a new block and the old
+    // block is freed.
+    auto slice_0 = Cabana::slice<0>( aosoa );
+    auto slice_1 = Cabana::slice<1>( aosoa );
+    Kokkos::parallel_for(
+        "fill", Kokkos::RangePolicy<TEST_EXECSPACE>( 0, num_data ),
+        KOKKOS_LAMBDA( const int i ) {
+            for ( int d = 0; d < 3; ++d )
+                slice_0( i, d ) = i + d;
+            slice_1( i ) = i;
+        } );
+    Kokkos::fence();
+    aosoa.resize( 2 * num_data );
+    EXPECT_EQ( pool.numBlocks(), 2u );
+    EXPECT_EQ( pool.numBlocksInUse(), 1u );
+
+    auto mirror =
+        Cabana::create_mirror_view_and_copy( Kokkos::HostSpace(), aosoa );
+    auto mirror_0 = Cabana::slice<0>( mirror );
+    auto mirror_1 = Cabana::slice<1>( mirror );
+    for ( std::size_t i = 0; i < num_data; ++i )
+    {
+        for ( int d = 0; d < 3; ++d )
+            EXPECT_EQ( mirror_0( i, d ), i + d );
+        EXPECT_EQ( mirror_1( i ), static_cast<int>( i ) );
+    }
+
+    // A second container reuses the freed block.
+    AoSoA_t other( "other" );
+    other.setMemoryPool( &pool );
+    other.resize( num_data );
+    EXPECT_EQ( pool.numBlocks(), 2u );
+    EXPECT_EQ( pool.numBlocksInUse(), 2u );
+
+    // Blocks are freed when the containers are.
+    other = AoSoA_t( "other" );
+    EXPECT_EQ( pool.numBlocksInUse(), 1u );
+    pool.release();
+    EXPECT_EQ( pool.numBlocks(), 1u );
+}
+
+//---------------------------------------------------------------------------//
+// Test first touch and huge page placement options.
+void testPlacement()
+{
+    using DataTypes = Cabana::MemberTypes<double[3], int>;
+    using AoSoA_t = Cabana::AoSoA<DataTypes, TEST_MEMSPACE>;
+    using memory_space = typename AoSoA_t::memory_space;
+
+    AoSoA_t aosoa( "aosoa" );
+    EXPECT_FALSE( aosoa.firstTouch() );
+    EXPECT_FALSE( aosoa.hugePages() );
+    aosoa.setFirstTouch( true );
+    aosoa.setHugePages( true );
+    EXPECT_TRUE( aosoa.firstTouch() );
+    EXPECT_TRUE( aosoa.hugePages() );
+
+    // Fill the data and grow. Placement must not change the copied data.
+    std::size_t num_data = 1000;
+    aosoa.resize( num_data );
+    auto slice_0 = Cabana::slice<0>( aosoa );
+    auto slice_1 = Cabana::slice<1>( aosoa );
+    Kokkos::parallel_for(
+        "fill", Kokkos::RangePolicy<TEST_EXECSPACE>( 0, num_data ),
+        KOKKOS_LAMBDA( const int i ) {
+            for ( int d = 0; d < 3; ++d )
+                slice_0( i, d ) = i + d;
+            slice_1( i ) = i;
+        } );
+    Kokkos::fence();
+    aosoa.reserve( 100 * num_data );
+
+    auto mirror =
+        Cabana::create_mirror_view_and_copy( Kokkos::HostSpace(), aosoa );
+    auto mirror_0 = Cabana::slice<0>( mirror );
+    auto mirror_1 = Cabana::slice<1>( mirror );
+    for ( std::size_t i = 0; i < num_data; ++i )
+    {
+        for ( int d = 0; d < 3; ++d )
+            EXPECT_EQ( mirror_0( i, d ), i + d );
+        EXPECT_EQ( mirror_1( i ), static_cast<int>( i ) );
+    }
+
+    // Pool blocks are placed when allocated.
+    Cabana::MemoryPool<memory_space> pool;
+    pool.setFirstTouch( true );
+    pool.setHugePages( true );
+    EXPECT_TRUE( pool.firstTouch() );
+    EXPECT_TRUE( pool.hugePages() );
+    auto block = pool.acquire( 1 << 20 );
+    EXPECT_EQ( block.extent( 0 ), std::size_t( 1 << 20 ) );
+}
+
 //---------------------------------------------------------------------------//
 // RUN TESTS
 //---------------------------------------------------------------------------//
@@ -620,6 +776,15 @@ TEST( TEST_CATEGORY, aosoa_access_test ) { testAccess(); }
 //---------------------------------------------------------------------------//
 TEST( TEST_CATEGORY, aosoa_unmanaged_test ) { testUnmanaged(); }
 
+//---------------------------------------------------------------------------//
+TEST( TEST_CATEGORY, aosoa_growth_policy_test ) { testGrowthPolicy(); }
+
+//---------------------------------------------------------------------------//
+TEST( TEST_CATEGORY, aosoa_memory_pool_test ) { testMemoryPool(); }
+
+//---------------------------------------------------------------------------//
+TEST( TEST_CATEGORY, aosoa_placement_test ) { testPlacement(); }
+
 //---------------------------------------------------------------------------//
 
 } // end namespace Test
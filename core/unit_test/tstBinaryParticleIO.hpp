@@ -0,0 +1,112 @@
+/****************************************************************************
+ * Copyright (c) 2018-2022 by the Cabana authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the Cabana library. Cabana is distributed under a   *
+ * BSD 3-clause license. For the licensing terms see the LICENSE file in    *
+ * the top-level directory.                                                 *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#include <Cabana_AoSoA.hpp>
+#include <Cabana_BinaryParticleIO.hpp>
+#include <Cabana_DeepCopy.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+
+namespace Test
+{
+//---------------------------------------------------------------------------//
+void mappedReadTest()
+{
+    // Write particles that partially fill the last SoA.
+    int num_particle = 45;
+    using DataTypes = Cabana::MemberTypes<double[3], float[2][2], int>;
+    Cabana::AoSoA<DataTypes, TEST_MEMSPACE, 16> aosoa( "particles",
+                                                       num_particle );
+    auto aosoa_host = Cabana::create_mirror_view( Kokkos::HostSpace(), aosoa );
+    auto x_host = Cabana::slice<0>( aosoa_host );
+    auto m_host = Cabana::slice<1>( aosoa_host );
+    auto id_host = Cabana::slice<2>( aosoa_host );
+    for ( int p = 0; p < num_particle; ++p )
+    {
+        for ( int d = 0; d < 3; ++d )
+            x_host( p, d ) = p + 0.1 * d;
+        for ( int i = 0; i < 2; ++i )
+            for ( int j = 0; j < 2; ++j )
+                m_host( p, i, j ) = p * i + j;
+        id_host( p ) = -p;
+    }
+    Cabana::deep_copy( aosoa, aosoa_host );
+    Cabana::Experimental::BinaryParticleIO::writeAoSoA( "particles.cbp",
+                                                        aosoa );
+
+    // Check the header.
+    auto header =
+        Cabana::Experimental::BinaryParticleIO::readHeader( "particles.cbp" );
+    EXPECT_EQ( header.size, std::size_t( num_particle ) );
+    EXPECT_EQ( header.num_soa, 3u );
+    EXPECT_EQ( header.vector_length, 16u );
+    EXPECT_EQ( header.label, "particles" );
+    EXPECT_EQ( header.data_offset % 4096, 0u );
+    ASSERT_EQ( header.members.size(), 3u );
+    EXPECT_EQ( header.members[0].kind, 'f' );
+    EXPECT_EQ( header.members[0].value_bytes, sizeof( double ) );
+    EXPECT_EQ( header.members[0].num_values, 3u );
+    EXPECT_EQ( header.members[1].num_values, 4u );
+    EXPECT_EQ( header.members[2].kind, 'i' );
+    EXPECT_EQ( header.members[2].soa_offset,
+               header.members[1].soa_offset + 4 * 16 * sizeof( float ) );
+
+    // Map the file and read it in place.
+    Cabana::Experimental::BinaryParticleIO::MappedAoSoA<DataTypes, 16> mapped(
+        "particles.cbp" );
+    auto mapped_aosoa = mapped.aosoa();
+    EXPECT_EQ( static_cast<int>( mapped_aosoa.size() ), num_particle );
+    auto x_mapped = Cabana::slice<0>( mapped_aosoa );
+    auto m_mapped = Cabana::slice<1>( mapped_aosoa );
+    auto id_mapped = Cabana::slice<2>( mapped_aosoa );
+    for ( int p = 0; p < num_particle; ++p )
+    {
+        for ( int d = 0; d < 3; ++d )
+            EXPECT_EQ( x_mapped( p, d ), x_host( p, d ) );
+        for ( int i = 0; i < 2; ++i )
+            for ( int j = 0; j < 2; ++j )
+                EXPECT_EQ( m_mapped( p, i, j ), m_host( p, i, j ) );
+        EXPECT_EQ( id_mapped( p ), id_host( p ) );
+    }
+
+    // Mapped particles can be copied to any memory space.
+    Cabana::AoSoA<DataTypes, TEST_MEMSPACE, 16> copy( "copy", num_particle );
+    Cabana::deep_copy( copy, mapped_aosoa );
+    auto copy_host =
+        Cabana::create_mirror_view_and_copy( Kokkos::HostSpace(), copy );
+    auto id_copy = Cabana::slice<2>( copy_host );
+    for ( int p = 0; p < num_particle; ++p )
+        EXPECT_EQ( id_copy( p ), id_host( p ) );
+
+    // A different layout cannot be mapped.
+    using WrongTypes = Cabana::MemberTypes<double[3], float[2][2], double>;
+    EXPECT_THROW(
+        ( Cabana::Experimental::BinaryParticleIO::MappedAoSoA<WrongTypes, 16>(
+            "particles.cbp" ) ),
+        std::runtime_error );
+    EXPECT_THROW(
+        ( Cabana::Experimental::BinaryParticleIO::MappedAoSoA<DataTypes, 8>(
+            "particles.cbp" ) ),
+        std::runtime_error );
+}
+
+//---------------------------------------------------------------------------//
+// RUN TESTS
+//---------------------------------------------------------------------------//
+TEST( TEST_CATEGORY, mapped_read_test ) { mappedReadTest(); }
+
+//---------------------------------------------------------------------------//
+
+} // end namespace Test
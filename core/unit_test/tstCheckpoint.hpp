@@ -0,0 +1,176 @@
+/****************************************************************************
+ * Copyright (c) 2018-2022 by the Cabana authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the Cabana library. Cabana is distributed under a   *
+ * BSD 3-clause license. For the licensing terms see the LICENSE file in    *
+ * the top-level directory.                                                 *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#include <Cabana_AoSoA.hpp>
+#include <Cabana_Checkpoint.hpp>
+#include <Cabana_DeepCopy.hpp>
+#include <Cabana_Fields.hpp>
+#include <Cabana_ParticleList.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <gtest/gtest.h>
+
+#include <mpi.h>
+
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace Test
+{
+//---------------------------------------------------------------------------//
+struct CheckpointId : Cabana::Field::Scalar<int>
+{
+    static std::string label() { return "id"; }
+};
+
+//---------------------------------------------------------------------------//
+void checkpointTest( const int num_files, const bool collective )
+{
+    int comm_rank;
+    MPI_Comm_rank( MPI_COMM_WORLD, &comm_rank );
+
+    Cabana::Experimental::Checkpoint::CheckpointConfig config;
+    config.num_files = num_files;
+    config.collective = collective;
+
+    // Uneven numbers of particles per rank.
+    int num_particle = 37 + 11 * comm_rank;
+    using DataTypes = Cabana::MemberTypes<double[3], float[2][2], int>;
+    Cabana::AoSoA<DataTypes, TEST_MEMSPACE, 8> aosoa( "aosoa", num_particle );
+    auto aosoa_host = Cabana::create_mirror_view( Kokkos::HostSpace(), aosoa );
+    auto x_host = Cabana::slice<0>( aosoa_host );
+    auto m_host = Cabana::slice<1>( aosoa_host );
+    auto id_host = Cabana::slice<2>( aosoa_host );
+    for ( int p = 0; p < num_particle; ++p )
+    {
+        for ( int d = 0; d < 3; ++d )
+            x_host( p, d ) = 1000.0 * comm_rank + p + 0.1 * d;
+        for ( int i = 0; i < 2; ++i )
+            for ( int j = 0; j < 2; ++j )
+                m_host( p, i, j ) = p * i + j;
+        id_host( p ) = 1000 * comm_rank + p;
+    }
+    Cabana::deep_copy( aosoa, aosoa_host );
+
+    auto particles = Cabana::createParticleList<TEST_MEMSPACE>(
+        "particles",
+        Cabana::ParticleTraits<Cabana::Field::Position<3>, CheckpointId>() );
+    particles.aosoa().resize( num_particle + 5 );
+    auto particles_host = Cabana::create_mirror_view( Kokkos::HostSpace(),
+                                                      particles.aosoa() );
+    auto px_host = Cabana::slice<0>( particles_host );
+    auto pid_host = Cabana::slice<1>( particles_host );
+    for ( int p = 0; p < num_particle + 5; ++p )
+    {
+        for ( int d = 0; d < 3; ++d )
+            px_host( p, d ) = -1.0 * p - d;
+        pid_host( p ) = comm_rank - p;
+    }
+    Cabana::deep_copy( particles.aosoa(), particles_host );
+
+    // Write everything in one operation.
+    Cabana::Experimental::Checkpoint::Writer writer( MPI_COMM_WORLD, config );
+    writer.add( "aosoa", aosoa );
+    writer.add( particles );
+    writer.write( "checkpoint", num_files );
+
+    // Restore into empty containers.
+    Cabana::Experimental::Checkpoint::Reader reader(
+        MPI_COMM_WORLD, "checkpoint", num_files, config );
+    EXPECT_TRUE( reader.contains( "aosoa" ) );
+    EXPECT_TRUE( reader.contains( "particles" ) );
+    EXPECT_FALSE( reader.contains( "grid" ) );
+    EXPECT_EQ( static_cast<int>( reader.count( "aosoa" ) ), num_particle );
+
+    Cabana::AoSoA<DataTypes, TEST_MEMSPACE, 8> aosoa_read( "read" );
+    reader.read( "aosoa", aosoa_read );
+    EXPECT_EQ( static_cast<int>( aosoa_read.size() ), num_particle );
+    auto read_host =
+        Cabana::create_mirror_view_and_copy( Kokkos::HostSpace(), aosoa_read );
+    auto x_read = Cabana::slice<0>( read_host );
+    auto m_read = Cabana::slice<1>( read_host );
+    auto id_read = Cabana::slice<2>( read_host );
+    for ( int p = 0; p < num_particle; ++p )
+    {
+        for ( int d = 0; d < 3; ++d )
+            EXPECT_EQ( x_read( p, d ), x_host( p, d ) );
+        for ( int i = 0; i < 2; ++i )
+            for ( int j = 0; j < 2; ++j )
+                EXPECT_EQ( m_read( p, i, j ), m_host( p, i, j ) );
+        EXPECT_EQ( id_read( p ), id_host( p ) );
+    }
+
+    auto particles_read = Cabana::createParticleList<TEST_MEMSPACE>(
+        "particles",
+        Cabana::ParticleTraits<Cabana::Field::Position<3>, CheckpointId>() );
+    reader.read( particles_read );
+    EXPECT_EQ( static_cast<int>( particles_read.size() ), num_particle + 5 );
+    auto particles_read_host = Cabana::create_mirror_view_and_copy(
+        Kokkos::HostSpace(), particles_read.aosoa() );
+    auto px_read = Cabana::slice<0>( particles_read_host );
+    auto pid_read = Cabana::slice<1>( particles_read_host );
+    for ( int p = 0; p < num_particle + 5; ++p )
+    {
+        for ( int d = 0; d < 3; ++d )
+            EXPECT_EQ( px_read( p, d ), px_host( p, d ) );
+        EXPECT_EQ( pid_read( p ), pid_host( p ) );
+    }
+
+    // A different layout cannot be restored.
+    Cabana::AoSoA<DataTypes, TEST_MEMSPACE, 16> aosoa_wrong( "wrong" );
+    EXPECT_THROW( reader.read( "aosoa", aosoa_wrong ), std::runtime_error );
+    EXPECT_THROW( reader.count( "grid" ), std::runtime_error );
+
+    // A size mismatch on one rank throws on all ranks.
+    std::size_t bytes =
+        aosoa.numSoA() * sizeof( typename decltype( aosoa )::soa_type );
+    std::vector<char> raw( bytes + 1 );
+    EXPECT_THROW( reader.readSection( "aosoa", reader.layout( "aosoa" ),
+                                      raw.data(),
+                                      ( 0 == comm_rank ) ? bytes + 1 : bytes ),
+                  std::runtime_error );
+
+    // A missing file throws on all ranks, including those reading other
+    // files.
+    MPI_Barrier( MPI_COMM_WORLD );
+    if ( 0 == comm_rank )
+        std::remove(
+            ( "checkpoint_" + std::to_string( num_files ) + "_0.ckpt" )
+                .c_str() );
+    MPI_Barrier( MPI_COMM_WORLD );
+    EXPECT_THROW( Cabana::Experimental::Checkpoint::Reader(
+                      MPI_COMM_WORLD, "checkpoint", num_files, config ),
+                  std::runtime_error );
+}
+
+//---------------------------------------------------------------------------//
+// RUN TESTS
+//---------------------------------------------------------------------------//
+TEST( TEST_CATEGORY, checkpoint_single_file_test )
+{
+    checkpointTest( 1, true );
+}
+
+//---------------------------------------------------------------------------//
+TEST( TEST_CATEGORY, checkpoint_multi_file_test )
+{
+    int comm_size;
+    MPI_Comm_size( MPI_COMM_WORLD, &comm_size );
+    checkpointTest( comm_size, true );
+    checkpointTest( 2, false );
+}
+
+//---------------------------------------------------------------------------//
+
+} // end namespace Test
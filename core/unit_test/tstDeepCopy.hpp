@@ -11,10 +11,13 @@
 
 #include <Cabana_AoSoA.hpp>
 #include <Cabana_DeepCopy.hpp>
+#include <Cabana_MixedPrecision.hpp>
 #include <Cabana_Types.hpp>
 
 #include <gtest/gtest.h>
 
+#include <cstdint>
+
 namespace Test
 {
 
@@ -292,6 +295,136 @@ void testAssign()
     }
 }
 
+//---------------------------------------------------------------------------//
+// Perform a reduced storage precision test.
+void testMixedPrecision()
+{
+    // Declare data types.
+    using fixed_type = Cabana::FixedPoint<std::int16_t, 8>;
+    using ComputeTypes = Cabana::MemberTypes<double[3], double, int>;
+    using StorageTypes = Cabana::MemberTypes<float[3], fixed_type, int>;
+    static_assert( sizeof( fixed_type ) == 2, "" );
+    static_assert( Cabana::CheckMemberTypes<
+                       Cabana::MemberTypes<fixed_type[3], float>>::value,
+                   "" );
+
+    // Fill an AoSoA at compute precision.
+    int num_data = 423;
+    Cabana::AoSoA<ComputeTypes, Kokkos::HostSpace> compute( "compute",
+                                                            num_data );
+    auto c_0 = Cabana::slice<0>( compute );
+    auto c_1 = Cabana::slice<1>( compute );
+    auto c_2 = Cabana::slice<2>( compute );
+    for ( int n = 0; n < num_data; ++n )
+    {
+        for ( int d = 0; d < 3; ++d )
+            c_0( n, d ) = 0.1 * n + d;
+        c_1( n ) = 0.01 * n - 1.3;
+        c_2( n ) = n;
+    }
+
+    // Convert to storage precision.
+    Cabana::AoSoA<StorageTypes, TEST_MEMSPACE, 8> storage( "storage",
+                                                           num_data );
+    Cabana::deep_copy( storage, compute );
+
+    // Update at compute precision through the slices.
+    auto s_0 = Cabana::slice<0>( storage );
+    auto s_1 = Cabana::slice<1>( storage );
+    Kokkos::parallel_for(
+        "update", Kokkos::RangePolicy<TEST_EXECSPACE>( 0, num_data ),
+        KOKKOS_LAMBDA( const int n ) {
+            for ( int d = 0; d < 3; ++d )
+                s_0( n, d ) *= 2.0;
+            s_1( n ) += 0.5;
+        } );
+    Kokkos::fence();
+
+    // Tuples convert on access.
+    auto host_storage =
+        Cabana::create_mirror_view_and_copy( Kokkos::HostSpace(), storage );
+    auto tp = host_storage.getTuple( 7 );
+    double fixed_value = Cabana::get<1>( tp );
+    EXPECT_NEAR( fixed_value, 0.07 - 0.8, fixed_type::resolution() );
+    Cabana::get<1>( tp ) = 3.25;
+    host_storage.setTuple( 7, tp );
+
+    // Convert back and check the values to within the storage precision.
+    Cabana::deep_copy( compute, host_storage );
+    for ( int n = 0; n < num_data; ++n )
+    {
+        for ( int d = 0; d < 3; ++d )
+            EXPECT_FLOAT_EQ( c_0( n, d ), 2.0 * ( 0.1 * n + d ) );
+        if ( 7 == n )
+            EXPECT_EQ( c_1( n ), 3.25 );
+        else
+            EXPECT_NEAR( c_1( n ), 0.01 * n - 0.8,
+                         fixed_type::resolution() );
+        EXPECT_EQ( c_2( n ), n );
+    }
+
+    // Values out of range saturate.
+    fixed_type big = 1.0e6;
+    EXPECT_EQ( double( big ), fixed_type::max() );
+}
+
+//---------------------------------------------------------------------------//
+// Perform an asynchronous copy test on an execution space instance.
+void testAsyncDeepCopy()
+{
+    // Declare data types.
+    using DataTypes = Cabana::MemberTypes<double[3], int>;
+
+    // Create a source AoSoA with index dependent data.
+    int num_data = 285;
+    Cabana::AoSoA<DataTypes, TEST_MEMSPACE> src( "src", num_data );
+    auto src_0 = Cabana::slice<0>( src );
+    auto src_1 = Cabana::slice<1>( src );
+    Kokkos::parallel_for(
+        "initialize", Kokkos::RangePolicy<TEST_EXECSPACE>( 0, num_data ),
+        KOKKOS_LAMBDA( const int n ) {
+            for ( int d = 0; d < 3; ++d )
+                src_0( n, d ) = n + 0.5 * d;
+            src_1( n ) = n;
+        } );
+    Kokkos::fence();
+
+    auto check = [=]( const auto& aosoa )
+    {
+        auto mirror =
+            Cabana::create_mirror_view_and_copy( Kokkos::HostSpace(), aosoa );
+        auto m_0 = Cabana::slice<0>( mirror );
+        auto m_1 = Cabana::slice<1>( mirror );
+        for ( int n = 0; n < num_data; ++n )
+        {
+            for ( int d = 0; d < 3; ++d )
+                EXPECT_EQ( m_0( n, d ), n + 0.5 * d );
+            EXPECT_EQ( m_1( n ), n );
+        }
+    };
+
+    TEST_EXECSPACE exec_space;
+
+    // Stage to the host.
+    auto host = Cabana::create_mirror_view_and_copy(
+        exec_space, Kokkos::HostSpace(), src );
+    exec_space.fence();
+    check( host );
+
+    // Copy to a different layout.
+    Cabana::AoSoA<DataTypes, TEST_MEMSPACE, 1> dst( "dst", num_data );
+    Cabana::deep_copy( exec_space, dst, src );
+    exec_space.fence();
+    check( dst );
+
+    // Copy a slice back into a cleared source.
+    Cabana::deep_copy( src_0, 0.0 );
+    auto dst_0 = Cabana::slice<0>( dst );
+    Cabana::deep_copy( exec_space, src_0, dst_0 );
+    exec_space.fence();
+    check( src );
+}
+
 //---------------------------------------------------------------------------//
 // TESTS
 //---------------------------------------------------------------------------//
@@ -320,12 +453,25 @@ TEST( TEST_CATEGORY, deep_copy_from_host_different_layout_test )
     testDeepCopy<TEST_MEMSPACE, Kokkos::HostSpace, 16, 32>();
 }
 
+//---------------------------------------------------------------------------//
+TEST( TEST_CATEGORY, deep_copy_same_space_different_layout_test )
+{
+    testDeepCopy<TEST_MEMSPACE, TEST_MEMSPACE, 16, 1>();
+    testDeepCopy<TEST_MEMSPACE, TEST_MEMSPACE, 1, 16>();
+}
+
 //---------------------------------------------------------------------------//
 TEST( TEST_CATEGORY, mirror_test ) { testMirror(); }
 
 //---------------------------------------------------------------------------//
 TEST( TEST_CATEGORY, assign_test ) { testAssign(); }
 
+//---------------------------------------------------------------------------//
+TEST( TEST_CATEGORY, mixed_precision_test ) { testMixedPrecision(); }
+
+//---------------------------------------------------------------------------//
+TEST( TEST_CATEGORY, async_deep_copy_test ) { testAsyncDeepCopy(); }
+
 //---------------------------------------------------------------------------//
 
 } // end namespace Test
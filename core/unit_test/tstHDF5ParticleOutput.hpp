@@ -22,8 +22,11 @@
 
 #include <Cabana_AoSoA.hpp>
 #include <Cabana_DeepCopy.hpp>
+#include <Cabana_Fields.hpp>
 #include <Cabana_HDF5ParticleOutput.hpp>
 #include <Cabana_ParticleInit.hpp>
+#include <Cabana_ParticleList.hpp>
+#include <Cabana_ParticleSelection.hpp>
 
 #include <Kokkos_Core.hpp>
 
@@ -32,6 +35,8 @@
 #include <mpi.h>
 
 #include <memory>
+#include <stdexcept>
+#include <vector>
 
 namespace Test
 {
@@ -188,11 +193,353 @@ void writeReadTest()
     EXPECT_DOUBLE_EQ( time, time_read );
 }
 
+//---------------------------------------------------------------------------//
+void asyncWriteReadTest()
+{
+    double low_corner = -2.8;
+    double high_corner = 1.2;
+
+    // Allocate particle properties.
+    int num_particle = 100;
+    using DataTypes = Cabana::MemberTypes<double[3],   // coords
+                                          float[3][3], // matrix
+                                          int>;        // id.
+    Cabana::AoSoA<DataTypes, TEST_MEMSPACE> aosoa( "particles", num_particle );
+    auto coords = Cabana::slice<0>( aosoa, "coords" );
+    auto matrix = Cabana::slice<1>( aosoa, "matrix" );
+    auto ids = Cabana::slice<2>( aosoa, "ids" );
+    Cabana::createRandomParticles( coords, num_particle, low_corner,
+                                   high_corner );
+
+    auto aosoa_mirror =
+        Cabana::create_mirror_view_and_copy( Kokkos::HostSpace(), aosoa );
+    auto coords_mirror = Cabana::slice<0>( aosoa_mirror, "coords" );
+    auto matrix_mirror = Cabana::slice<1>( aosoa_mirror, "matrix" );
+    auto ids_mirror = Cabana::slice<2>( aosoa_mirror, "ids" );
+
+    Cabana::Experimental::HDF5ParticleOutput::HDF5Config h5_config;
+    h5_config.collective = true;
+
+    // Write more time steps than can be in flight, moving the particles as
+    // soon as each write returns. Each file must hold the particles as they
+    // were when written.
+    int num_step = 4;
+    double time_step_size = 0.32;
+    std::vector<Cabana::AoSoA<DataTypes, Kokkos::HostSpace>> expected;
+    {
+        Cabana::Experimental::HDF5ParticleOutput::AsyncWriter writer(
+            h5_config, MPI_COMM_WORLD, 2 );
+
+        // Writes run in the background whenever MPI allows it.
+        int provided;
+        MPI_Query_thread( &provided );
+        if ( MPI_THREAD_MULTIPLE == provided )
+            EXPECT_TRUE( writer.isAsync() );
+        else
+            EXPECT_FALSE( writer.isAsync() );
+        EXPECT_FALSE( Cabana::Experimental::HDF5ParticleOutput::AsyncWriter(
+                          h5_config, MPI_COMM_WORLD, 0 )
+                          .isAsync() );
+        for ( int step = 0; step < num_step; ++step )
+        {
+            for ( int p = 0; p < num_particle; ++p )
+            {
+                ids_mirror( p ) = p + step;
+                for ( int d1 = 0; d1 < 3; ++d1 )
+                {
+                    coords_mirror( p, d1 ) += time_step_size;
+                    for ( int d2 = 0; d2 < 3; ++d2 )
+                        matrix_mirror( p, d1, d2 ) = step * d1 - d2;
+                }
+            }
+            Cabana::deep_copy( aosoa, aosoa_mirror );
+            expected.emplace_back( "expected", num_particle );
+            Cabana::deep_copy( expected.back(), aosoa_mirror );
+
+            writer.write( "particles-async", step, step * time_step_size,
+                          coords.size(), coords, ids, matrix );
+            EXPECT_LE( writer.numInFlight(), 2u );
+        }
+        writer.wait();
+        EXPECT_EQ( writer.numInFlight(), 0u );
+    }
+
+    // Read the data back in and compare.
+    Cabana::AoSoA<DataTypes, Kokkos::HostSpace> aosoa_read( "read",
+                                                            aosoa.size() );
+    auto coords_read = Cabana::slice<0>( aosoa_read, "coords" );
+    auto matrix_read = Cabana::slice<1>( aosoa_read, "matrix" );
+    auto ids_read = Cabana::slice<2>( aosoa_read, "ids" );
+    double time_read;
+    for ( int step = 0; step < num_step; ++step )
+    {
+        Cabana::Experimental::HDF5ParticleOutput::readTimeStep(
+            h5_config, "particles-async", MPI_COMM_WORLD, step,
+            coords.size(), coords.label(), time_read, coords_read );
+        checkVector( Cabana::slice<0>( expected[step] ), coords_read );
+        EXPECT_DOUBLE_EQ( step * time_step_size, time_read );
+
+        Cabana::Experimental::HDF5ParticleOutput::readTimeStep(
+            h5_config, "particles-async", MPI_COMM_WORLD, step,
+            coords.size(), ids.label(), time_read, ids_read );
+        checkScalar( Cabana::slice<2>( expected[step] ), ids_read );
+
+        Cabana::Experimental::HDF5ParticleOutput::readTimeStep(
+            h5_config, "particles-async", MPI_COMM_WORLD, step,
+            coords.size(), matrix.label(), time_read, matrix_read );
+        checkMatrix( Cabana::slice<1>( expected[step] ), matrix_read );
+    }
+}
+
+//---------------------------------------------------------------------------//
+void compressedWriteReadTest()
+{
+    // Allocate particle properties.
+    int num_particle = 1000;
+    using DataTypes = Cabana::MemberTypes<double[3], // coords
+                                          double,    // energy
+                                          int>;      // id.
+    Cabana::AoSoA<DataTypes, TEST_MEMSPACE> aosoa( "particles", num_particle );
+    auto coords = Cabana::slice<0>( aosoa, "coords" );
+    auto energy = Cabana::slice<1>( aosoa, "energy" );
+    auto ids = Cabana::slice<2>( aosoa, "ids" );
+    Cabana::createRandomParticles( coords, num_particle, -2.8, 1.2 );
+
+    auto aosoa_mirror =
+        Cabana::create_mirror_view_and_copy( Kokkos::HostSpace(), aosoa );
+    auto coords_mirror = Cabana::slice<0>( aosoa_mirror, "coords" );
+    auto energy_mirror = Cabana::slice<1>( aosoa_mirror, "energy" );
+    auto ids_mirror = Cabana::slice<2>( aosoa_mirror, "ids" );
+    for ( int p = 0; p < num_particle; ++p )
+    {
+        ids_mirror( p ) = p;
+        energy_mirror( p ) =
+            0.5 * coords_mirror( p, 0 ) * coords_mirror( p, 0 );
+    }
+    Cabana::deep_copy( aosoa, aosoa_mirror );
+
+    Cabana::AoSoA<DataTypes, Kokkos::HostSpace> aosoa_read( "read",
+                                                            num_particle );
+    auto coords_read = Cabana::slice<0>( aosoa_read, "coords" );
+    auto energy_read = Cabana::slice<1>( aosoa_read, "energy" );
+    auto ids_read = Cabana::slice<2>( aosoa_read, "ids" );
+    double time_read;
+
+    // Lossless chunked and compressed output.
+    Cabana::Experimental::HDF5ParticleOutput::HDF5Config h5_config;
+    h5_config.chunk = true;
+    h5_config.shuffle = true;
+    h5_config.deflate_level = 4;
+    Cabana::Experimental::HDF5ParticleOutput::writeTimeStep(
+        h5_config, "particles-deflate", MPI_COMM_WORLD, 0, 1.5, coords.size(),
+        coords, energy, ids );
+
+    Cabana::Experimental::HDF5ParticleOutput::readTimeStep(
+        h5_config, "particles-deflate", MPI_COMM_WORLD, 0, coords.size(),
+        coords.label(), time_read, coords_read );
+    checkVector( coords_mirror, coords_read );
+    EXPECT_DOUBLE_EQ( 1.5, time_read );
+    Cabana::Experimental::HDF5ParticleOutput::readTimeStep(
+        h5_config, "particles-deflate", MPI_COMM_WORLD, 0, coords.size(),
+        ids.label(), time_read, ids_read );
+    checkScalar( ids_mirror, ids_read );
+
+    // Lossy scale-offset output of floating point fields with a given chunk
+    // size. Integer fields are unchanged.
+    h5_config.chunk_size = 64;
+    h5_config.scale_offset_digits = 4;
+    Cabana::Experimental::HDF5ParticleOutput::writeTimeStep(
+        h5_config, "particles-scaleoffset", MPI_COMM_WORLD, 0, 1.5,
+        coords.size(), coords, energy, ids );
+
+    Cabana::Experimental::HDF5ParticleOutput::readTimeStep(
+        h5_config, "particles-scaleoffset", MPI_COMM_WORLD, 0, coords.size(),
+        energy.label(), time_read, energy_read );
+    for ( int p = 0; p < num_particle; ++p )
+        EXPECT_NEAR( energy_mirror( p ), energy_read( p ), 1.0e-4 );
+    Cabana::Experimental::HDF5ParticleOutput::readTimeStep(
+        h5_config, "particles-scaleoffset", MPI_COMM_WORLD, 0, coords.size(),
+        ids.label(), time_read, ids_read );
+    checkScalar( ids_mirror, ids_read );
+}
+
+//---------------------------------------------------------------------------//
+struct ParticleId : Cabana::Field::Scalar<int>
+{
+    static std::string label() { return "ids"; }
+};
+
+void restartReadTest()
+{
+    int comm_rank;
+    MPI_Comm_rank( MPI_COMM_WORLD, &comm_rank );
+
+    // Write an uneven number of particles per rank with the global index as
+    // the id.
+    int num_particle = 50 + 10 * comm_rank;
+    using DataTypes = Cabana::MemberTypes<double[3], int>;
+    Cabana::AoSoA<DataTypes, TEST_MEMSPACE> aosoa( "particles", num_particle );
+    auto coords = Cabana::slice<0>( aosoa, "position" );
+    auto ids = Cabana::slice<1>( aosoa, "ids" );
+    Cabana::createRandomParticles( coords, num_particle, -2.8, 1.2 );
+
+    int offset = 0;
+    MPI_Exscan( &num_particle, &offset, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD );
+    if ( 0 == comm_rank )
+        offset = 0;
+    auto ids_mirror =
+        Cabana::create_mirror_view_and_copy( Kokkos::HostSpace(), ids );
+    for ( int p = 0; p < num_particle; ++p )
+        ids_mirror( p ) = offset + p;
+    Cabana::deep_copy( ids, ids_mirror );
+
+    Cabana::Experimental::HDF5ParticleOutput::HDF5Config h5_config;
+    Cabana::Experimental::HDF5ParticleOutput::writeTimeStep(
+        h5_config, "particles-restart", MPI_COMM_WORLD, 0, 2.5, num_particle,
+        coords, ids );
+
+    // Read back in even blocks.
+    std::size_t n_global =
+        Cabana::Experimental::HDF5ParticleOutput::readNumParticles(
+            h5_config, "particles-restart", MPI_COMM_WORLD, 0, "ids" );
+    int num_global = 0;
+    MPI_Allreduce( &num_particle, &num_global, 1, MPI_INT, MPI_SUM,
+                   MPI_COMM_WORLD );
+    EXPECT_EQ( static_cast<int>( n_global ), num_global );
+
+    int n_local = Cabana::Experimental::HDF5ParticleOutput::localBlockSize(
+        n_global, MPI_COMM_WORLD );
+    int n_sum = 0;
+    MPI_Allreduce( &n_local, &n_sum, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD );
+    EXPECT_EQ( n_sum, num_global );
+    int read_offset = 0;
+    MPI_Exscan( &n_local, &read_offset, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD );
+    if ( 0 == comm_rank )
+        read_offset = 0;
+
+    // Read all fields from slices at once.
+    Cabana::AoSoA<DataTypes, Kokkos::HostSpace> aosoa_read( "read", n_local );
+    auto coords_read = Cabana::slice<0>( aosoa_read, "position" );
+    auto ids_read = Cabana::slice<1>( aosoa_read, "ids" );
+    double time_read = 0.0;
+    Cabana::Experimental::HDF5ParticleOutput::readTimeStep(
+        h5_config, "particles-restart", MPI_COMM_WORLD, 0, n_local, time_read,
+        coords_read, ids_read );
+    EXPECT_DOUBLE_EQ( time_read, 2.5 );
+    for ( int p = 0; p < n_local; ++p )
+    {
+        EXPECT_EQ( ids_read( p ), read_offset + p );
+        for ( int d = 0; d < 3; ++d )
+        {
+            EXPECT_GE( coords_read( p, d ), -2.8 );
+            EXPECT_LE( coords_read( p, d ), 1.2 );
+        }
+    }
+
+    // Read all fields into a particle list.
+    Cabana::ParticleList<Kokkos::HostSpace, Cabana::Field::Position<3>,
+                         ParticleId>
+        particles( "particles" );
+    time_read = 0.0;
+    Cabana::Experimental::HDF5ParticleOutput::readTimeStep(
+        h5_config, "particles-restart", MPI_COMM_WORLD, 0, n_local, time_read,
+        particles );
+    EXPECT_DOUBLE_EQ( time_read, 2.5 );
+    EXPECT_EQ( static_cast<int>( particles.size() ), n_local );
+    auto ids_list = particles.slice( ParticleId() );
+    auto coords_list = particles.slice( Cabana::Field::Position<3>() );
+    for ( int p = 0; p < n_local; ++p )
+    {
+        EXPECT_EQ( ids_list( p ), read_offset + p );
+        for ( int d = 0; d < 3; ++d )
+            EXPECT_DOUBLE_EQ( coords_list( p, d ), coords_read( p, d ) );
+    }
+
+    // A missing field throws and releases the file so it can be read again.
+    auto missing = Cabana::slice<1>( aosoa_read, "missing" );
+    EXPECT_THROW( Cabana::Experimental::HDF5ParticleOutput::readTimeStep(
+                      h5_config, "particles-restart", MPI_COMM_WORLD, 0,
+                      n_local, time_read, coords_read, missing ),
+                  std::runtime_error );
+    EXPECT_EQ( Cabana::Experimental::HDF5ParticleOutput::readNumParticles(
+                   h5_config, "particles-restart", MPI_COMM_WORLD, 0, "ids" ),
+               n_global );
+}
+
+//---------------------------------------------------------------------------//
+void selectedWriteReadTest()
+{
+    // Allocate particle properties.
+    int num_particle = 1000;
+    using DataTypes = Cabana::MemberTypes<double[3], // coords
+                                          int>;      // id.
+    Cabana::AoSoA<DataTypes, TEST_MEMSPACE> aosoa( "particles", num_particle );
+    auto coords = Cabana::slice<0>( aosoa, "coords" );
+    auto ids = Cabana::slice<1>( aosoa, "ids" );
+    Cabana::createRandomParticles( coords, num_particle, -2.8, 1.2 );
+
+    auto aosoa_mirror =
+        Cabana::create_mirror_view_and_copy( Kokkos::HostSpace(), aosoa );
+    auto coords_mirror = Cabana::slice<0>( aosoa_mirror, "coords" );
+    auto ids_mirror = Cabana::slice<1>( aosoa_mirror, "ids" );
+    for ( int p = 0; p < num_particle; ++p )
+        ids_mirror( p ) = p;
+    Cabana::deep_copy( aosoa, aosoa_mirror );
+
+    // Write every third particle.
+    auto selection =
+        Cabana::createStrideSelection<TEST_MEMSPACE>( num_particle, 3, 1 );
+    std::size_t num_selected = selection.size();
+    EXPECT_EQ( static_cast<int>( num_selected ), 333 );
+
+    Cabana::Experimental::HDF5ParticleOutput::HDF5Config h5_config;
+    Cabana::Experimental::HDF5ParticleOutput::writeTimeStep(
+        h5_config, "particles-selected", MPI_COMM_WORLD, 0, 0.5, selection,
+        coords, ids );
+
+    Cabana::AoSoA<DataTypes, Kokkos::HostSpace> aosoa_read( "read",
+                                                            num_selected );
+    auto coords_read = Cabana::slice<0>( aosoa_read, "coords" );
+    auto ids_read = Cabana::slice<1>( aosoa_read, "ids" );
+    double time_read;
+    Cabana::Experimental::HDF5ParticleOutput::readTimeStep(
+        h5_config, "particles-selected", MPI_COMM_WORLD, 0, num_selected,
+        coords.label(), time_read, coords_read );
+    Cabana::Experimental::HDF5ParticleOutput::readTimeStep(
+        h5_config, "particles-selected", MPI_COMM_WORLD, 0, num_selected,
+        ids.label(), time_read, ids_read );
+    EXPECT_DOUBLE_EQ( 0.5, time_read );
+    for ( std::size_t p = 0; p < num_selected; ++p )
+    {
+        int id = 3 * p + 1;
+        EXPECT_EQ( ids_read( p ), id );
+        for ( int d = 0; d < 3; ++d )
+            EXPECT_DOUBLE_EQ( coords_read( p, d ), coords_mirror( id, d ) );
+    }
+}
+
 //---------------------------------------------------------------------------//
 // RUN TESTS
 //---------------------------------------------------------------------------//
 TEST( TEST_CATEGORY, write_read_test ) { writeReadTest(); }
 
+//---------------------------------------------------------------------------//
+TEST( TEST_CATEGORY, async_write_read_test ) { asyncWriteReadTest(); }
+
+//---------------------------------------------------------------------------//
+TEST( TEST_CATEGORY, restart_read_test ) { restartReadTest(); }
+
+//---------------------------------------------------------------------------//
+TEST( TEST_CATEGORY, selected_write_read_test ) { selectedWriteReadTest(); }
+
+//---------------------------------------------------------------------------//
+#if H5_VERSION_GE( 1, 10, 2 )
+TEST( TEST_CATEGORY, compressed_write_read_test )
+{
+    compressedWriteReadTest();
+}
+#endif
+
 //---------------------------------------------------------------------------//
 
 } // end namespace Test
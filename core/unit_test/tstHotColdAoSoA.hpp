@@ -0,0 +1,122 @@
+/****************************************************************************
+ * Copyright (c) 2018-2022 by the Cabana authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the Cabana library. Cabana is distributed under a   *
+ * BSD 3-clause license. For the licensing terms see the LICENSE file in    *
+ * the top-level directory.                                                 *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#include <Cabana_DeepCopy.hpp>
+#include <Cabana_HotColdAoSoA.hpp>
+#include <Cabana_Sort.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <gtest/gtest.h>
+
+namespace Test
+{
+//---------------------------------------------------------------------------//
+using HotTypes = Cabana::MemberTypes<double[3], int>;
+using ColdTypes = Cabana::MemberTypes<float, long>;
+using HotCold_t = Cabana::HotColdAoSoA<HotTypes, ColdTypes, TEST_MEMSPACE>;
+
+//---------------------------------------------------------------------------//
+// Fill all members from the particle index.
+void fillHotCold( HotCold_t& particles )
+{
+    auto x = Cabana::slice<0>( particles );
+    auto id = Cabana::slice<1>( particles );
+    auto w = Cabana::slice<2>( particles );
+    auto tag = Cabana::slice<3>( particles );
+    Kokkos::parallel_for(
+        "fill", Kokkos::RangePolicy<TEST_EXECSPACE>( 0, particles.size() ),
+        KOKKOS_LAMBDA( const int p ) {
+            for ( int d = 0; d < 3; ++d )
+                x( p, d ) = p + d;
+            id( p ) = p;
+            w( p ) = 0.5 * p;
+            tag( p ) = 2 * p;
+        } );
+    Kokkos::fence();
+}
+
+//---------------------------------------------------------------------------//
+// Check every member is consistent with the id member.
+void checkHotCold( const HotCold_t& particles, const int num_data )
+{
+    EXPECT_EQ( static_cast<int>( particles.size() ), num_data );
+    auto host = Cabana::create_mirror_view_and_copy( Kokkos::HostSpace(),
+                                                     particles );
+    auto x = Cabana::slice<0>( host );
+    auto id = Cabana::slice<1>( host );
+    auto w = Cabana::slice<2>( host );
+    auto tag = Cabana::slice<3>( host );
+    for ( int p = 0; p < num_data; ++p )
+    {
+        for ( int d = 0; d < 3; ++d )
+            EXPECT_EQ( x( p, d ), id( p ) + d );
+        EXPECT_EQ( w( p ), 0.5 * id( p ) );
+        EXPECT_EQ( tag( p ), 2 * id( p ) );
+    }
+}
+
+//---------------------------------------------------------------------------//
+void testHotCold()
+{
+    int num_data = 233;
+    HotCold_t particles( "particles", num_data );
+
+    static_assert( HotCold_t::number_of_hot_members == 2, "" );
+    static_assert( HotCold_t::number_of_members == 4, "" );
+    static_assert( Cabana::is_hot_cold_aosoa<HotCold_t>::value, "" );
+    EXPECT_EQ( particles.hot().size(), particles.cold().size() );
+
+    fillHotCold( particles );
+    checkHotCold( particles, num_data );
+
+    // Resizing keeps both parts in step.
+    particles.resize( 2 * num_data );
+    EXPECT_EQ( particles.hot().size(), particles.cold().size() );
+    EXPECT_GE( particles.capacity(), particles.size() );
+    particles.resize( num_data );
+    particles.shrinkToFit();
+    checkHotCold( particles, num_data );
+
+    // Reverse the particles with a sort and check members stay together.
+    Kokkos::View<int*, TEST_MEMSPACE> keys( "keys", num_data );
+    Kokkos::parallel_for(
+        "keys", Kokkos::RangePolicy<TEST_EXECSPACE>( 0, num_data ),
+        KOKKOS_LAMBDA( const int p ) { keys( p ) = num_data - p; } );
+    Kokkos::fence();
+    auto binning_data = Cabana::sortByKey( keys );
+    Cabana::permute( binning_data, particles );
+    checkHotCold( particles, num_data );
+    auto host = Cabana::create_mirror_view_and_copy( Kokkos::HostSpace(),
+                                                     particles );
+    auto id = Cabana::slice<1>( host );
+    for ( int p = 0; p < num_data; ++p )
+        EXPECT_EQ( id( p ), num_data - 1 - p );
+
+    // Deep copy between containers.
+    HotCold_t copy( "copy", num_data );
+    Cabana::deep_copy( copy, particles );
+    checkHotCold( copy, num_data );
+
+    // Mismatched parts are rejected.
+    typename HotCold_t::hot_aosoa_type hot( "hot", 3 );
+    typename HotCold_t::cold_aosoa_type cold( "cold", 4 );
+    EXPECT_THROW( HotCold_t( hot, cold ), std::runtime_error );
+}
+
+//---------------------------------------------------------------------------//
+// RUN TESTS
+//---------------------------------------------------------------------------//
+TEST( TEST_CATEGORY, hot_cold_aosoa_test ) { testHotCold(); }
+
+//---------------------------------------------------------------------------//
+
+} // end namespace Test
@@ -10,8 +10,10 @@
  ****************************************************************************/
 
 #include <Cabana_AoSoA.hpp>
+#include <Cabana_KNearestNeighborList.hpp>
 #include <Cabana_NeighborList.hpp>
 #include <Cabana_Parallel.hpp>
+#include <Cabana_TripletList.hpp>
 #include <Cabana_VerletList.hpp>
 
 #include <Kokkos_Core.hpp>
@@ -20,6 +22,10 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <utility>
+#include <vector>
+
 namespace Test
 {
 //---------------------------------------------------------------------------//
@@ -219,6 +225,127 @@ void testVerletListFullPartialRange()
                                        test_data.num_ignore );
 }
 
+//---------------------------------------------------------------------------//
+template <class LayoutTag, class BuildTag>
+void testVerletListLocalGhost()
+{
+    // Create the AoSoA and fill with random particle positions.
+    NeighborListTestData test_data;
+    auto position = Cabana::slice<0>( test_data.aosoa );
+
+    // Treat the first particles as locally owned and the next as ghosts. The
+    // remaining particles are neither and should never be neighbors.
+    int num_local = test_data.num_particle / 2;
+    int num_ghost = test_data.num_ignore;
+
+    Cabana::VerletList<TEST_MEMSPACE, Cabana::FullNeighborTag, LayoutTag,
+                       BuildTag>
+        nlist;
+    nlist.buildWithGhosts( position, num_local, num_ghost,
+                           test_data.test_radius, test_data.cell_size_ratio,
+                           test_data.grid_min, test_data.grid_max );
+
+    auto list_copy =
+        copyListToHost( nlist, test_data.N2_list_copy.neighbors.extent( 0 ),
+                        test_data.N2_list_copy.neighbors.extent( 1 ) );
+    auto local_counts = Kokkos::create_mirror_view_and_copy(
+        Kokkos::HostSpace(), nlist._local_counts );
+
+    for ( int p = 0; p < test_data.num_particle; ++p )
+    {
+        if ( p >= num_local )
+        {
+            EXPECT_EQ( list_copy.counts( p ), 0 );
+            continue;
+        }
+
+        // Only locally owned and ghosted particles are candidates.
+        std::vector<int> actual_neighbors;
+        int actual_local = 0;
+        for ( int n = 0; n < test_data.N2_list_copy.counts( p ); ++n )
+        {
+            int nid = test_data.N2_list_copy.neighbors( p, n );
+            if ( nid < num_local + num_ghost )
+                actual_neighbors.push_back( nid );
+            if ( nid < num_local )
+                ++actual_local;
+        }
+        EXPECT_EQ( list_copy.counts( p ),
+                   static_cast<int>( actual_neighbors.size() ) );
+        EXPECT_EQ( local_counts( p ), actual_local );
+
+        // Locally owned neighbors are stored before ghosted neighbors.
+        std::vector<int> computed_neighbors( list_copy.counts( p ) );
+        for ( int n = 0; n < list_copy.counts( p ); ++n )
+        {
+            computed_neighbors[n] = list_copy.neighbors( p, n );
+            if ( n < local_counts( p ) )
+                EXPECT_LT( computed_neighbors[n], num_local );
+            else
+                EXPECT_GE( computed_neighbors[n], num_local );
+        }
+
+        std::sort( computed_neighbors.begin(), computed_neighbors.end() );
+        std::sort( actual_neighbors.begin(), actual_neighbors.end() );
+        for ( std::size_t n = 0; n < actual_neighbors.size(); ++n )
+            EXPECT_EQ( computed_neighbors[n], actual_neighbors[n] );
+    }
+}
+
+//---------------------------------------------------------------------------//
+template <class AlgorithmTag, class LayoutTag>
+void testVerletListUpdate()
+{
+    // Create the AoSoA and fill with random particle positions.
+    NeighborListTestData test_data;
+    auto position = Cabana::slice<0>( test_data.aosoa );
+
+    // Create the neighbor list.
+    Cabana::VerletList<TEST_MEMSPACE, AlgorithmTag, LayoutTag,
+                       Cabana::TeamOpTag>
+        nlist( position, 0, position.size(), test_data.test_radius,
+               test_data.cell_size_ratio, test_data.grid_min,
+               test_data.grid_max );
+
+    // Move some particles and insert new ones. New positions are midpoints
+    // of existing particles so they stay within the grid.
+    int num_moved = 10;
+    int num_insert = 5;
+    int num_particle = test_data.num_particle + num_insert;
+    test_data.aosoa.resize( num_particle );
+    auto aosoa_mirror = Cabana::create_mirror_view_and_copy(
+        Kokkos::HostSpace(), test_data.aosoa );
+    auto position_mirror = Cabana::slice<0>( aosoa_mirror );
+    Kokkos::View<int*, Kokkos::HostSpace> changed_host( "changed",
+                                                       num_moved + num_insert );
+    for ( int m = 0; m < num_moved + num_insert; ++m )
+    {
+        int p = ( m < num_moved ) ? 3 * m + 1
+                                  : test_data.num_particle + m - num_moved;
+        int a = ( 7 * m + 11 ) % test_data.num_particle;
+        int b = ( 13 * m + 5 ) % test_data.num_particle;
+        for ( int d = 0; d < 3; ++d )
+            position_mirror( p, d ) =
+                0.5 * ( position_mirror( a, d ) + position_mirror( b, d ) );
+        changed_host( m ) = p;
+    }
+    Cabana::deep_copy( test_data.aosoa, aosoa_mirror );
+    position = Cabana::slice<0>( test_data.aosoa );
+    auto changed =
+        Kokkos::create_mirror_view_and_copy( TEST_MEMSPACE(), changed_host );
+
+    // Update the list and compare to the updated N^2 list.
+    nlist.update( position, changed, test_data.test_radius,
+                  test_data.cell_size_ratio, test_data.grid_min,
+                  test_data.grid_max );
+    auto N2_list_copy = createTestListHostCopy(
+        computeFullNeighborList( position, test_data.test_radius ) );
+    if ( std::is_same<AlgorithmTag, Cabana::FullNeighborTag>::value )
+        checkFullNeighborList( nlist, N2_list_copy, num_particle );
+    else
+        checkHalfNeighborList( nlist, N2_list_copy, num_particle );
+}
+
 //---------------------------------------------------------------------------//
 template <class LayoutTag>
 void testNeighborParallelFor()
@@ -323,6 +450,161 @@ void testModifyNeighbors()
                 EXPECT_EQ( list_copy.neighbors( p, n ), new_id );
     }
 }
+//---------------------------------------------------------------------------//
+template <class LayoutTag>
+void testTripletList()
+{
+    // Create the AoSoA and fill with random particle positions.
+    NeighborListTestData test_data;
+    auto position = Cabana::slice<0>( test_data.aosoa );
+
+    // Create the neighbor list.
+    using ListType = Cabana::VerletList<TEST_MEMSPACE, Cabana::FullNeighborTag,
+                                        LayoutTag, Cabana::TeamOpTag>;
+    ListType nlist( position, 0, position.size(), test_data.test_radius,
+                    test_data.cell_size_ratio, test_data.grid_min,
+                    test_data.grid_max );
+
+    // With the angular cutoff equal to the list cutoff the triplets are
+    // exactly the second neighbors.
+    Cabana::TripletList<TEST_MEMSPACE> tlist( position, 0, position.size(),
+                                              nlist, test_data.test_radius );
+
+    using memory_space = typename TEST_MEMSPACE::memory_space;
+    Kokkos::View<int*, memory_space> serial_result( "serial_result",
+                                                    test_data.num_particle );
+    Kokkos::View<int*, memory_space> team_result( "team_result",
+                                                  test_data.num_particle );
+    auto serial_count_op =
+        KOKKOS_LAMBDA( const int i, const int j, const int k )
+    {
+        Kokkos::atomic_add( &serial_result( i ), j );
+        Kokkos::atomic_add( &serial_result( i ), k );
+    };
+    auto team_count_op = KOKKOS_LAMBDA( const int i, const int j, const int k )
+    {
+        Kokkos::atomic_add( &team_result( i ), j );
+        Kokkos::atomic_add( &team_result( i ), k );
+    };
+    Kokkos::RangePolicy<TEST_EXECSPACE> policy( 0, test_data.num_particle );
+    Cabana::neighbor_parallel_for( policy, serial_count_op, tlist,
+                                   Cabana::SecondNeighborsTag(),
+                                   Cabana::SerialOpTag(), "test_3b_serial" );
+    Cabana::neighbor_parallel_for( policy, team_count_op, tlist,
+                                   Cabana::SecondNeighborsTag(),
+                                   Cabana::TeamOpTag(), "test_3b_team" );
+    Kokkos::fence();
+    checkSecondNeighborParallelFor( test_data.N2_list_copy, serial_result,
+                                    team_result, team_result, 1 );
+
+    // Check the reduction against the neighbor list version.
+    auto sum_op =
+        KOKKOS_LAMBDA( const int i, const int n, const int a, double& sum )
+    {
+        sum += position( i, 0 ) + position( n, 0 ) + position( a, 0 );
+    };
+    double serial_sum = 0;
+    Cabana::neighbor_parallel_reduce(
+        policy, sum_op, tlist, Cabana::SecondNeighborsTag(),
+        Cabana::SerialOpTag(), serial_sum, "test_3b_reduce_serial" );
+    double team_sum = 0;
+    Cabana::neighbor_parallel_reduce(
+        policy, sum_op, tlist, Cabana::SecondNeighborsTag(),
+        Cabana::TeamOpTag(), team_sum, "test_3b_reduce_team" );
+    Kokkos::fence();
+    checkSecondNeighborParallelReduce( test_data.N2_list_copy, test_data.aosoa,
+                                       serial_sum, team_sum, team_sum, 1 );
+
+    // Rebuild with a shorter angular cutoff and check the number of
+    // triplets against the neighbors within that cutoff.
+    double angular_radius = 0.75 * test_data.test_radius;
+    tlist.build( TEST_EXECSPACE{}, position, 0, position.size(), nlist,
+                 angular_radius );
+    auto counts_mirror = Kokkos::create_mirror_view_and_copy(
+        Kokkos::HostSpace(), tlist.counts );
+    auto aosoa_mirror = Cabana::create_mirror_view_and_copy(
+        Kokkos::HostSpace(), test_data.aosoa );
+    auto position_mirror = Cabana::slice<0>( aosoa_mirror );
+    for ( int p = 0; p < test_data.num_particle; ++p )
+    {
+        int m = 0;
+        for ( int n = 0; n < test_data.N2_list_copy.counts( p ); ++n )
+        {
+            int j = test_data.N2_list_copy.neighbors( p, n );
+            double dsqr = 0.0;
+            for ( int d = 0; d < 3; ++d )
+                dsqr += ( position_mirror( p, d ) - position_mirror( j, d ) ) *
+                        ( position_mirror( p, d ) - position_mirror( j, d ) );
+            if ( dsqr <= angular_radius * angular_radius )
+                ++m;
+        }
+        EXPECT_EQ( counts_mirror( p ), m * ( m - 1 ) / 2 );
+    }
+}
+
+//---------------------------------------------------------------------------//
+void testKNearestNeighborList()
+{
+    // Create the AoSoA and fill with random particle positions.
+    NeighborListTestData test_data;
+    auto position = Cabana::slice<0>( test_data.aosoa );
+
+    // Build the list for a subset of particles with cells small enough that
+    // several shells must be searched.
+    const int k = 12;
+    double grid_delta[3] = { 0.5 * test_data.test_radius,
+                             0.5 * test_data.test_radius,
+                             0.5 * test_data.test_radius };
+    Cabana::KNearestNeighborList<TEST_MEMSPACE> nlist(
+        position, test_data.num_ignore, position.size(), k, grid_delta,
+        test_data.grid_min, test_data.grid_max );
+
+    // Check the results against a brute force search.
+    auto counts_mirror = Kokkos::create_mirror_view_and_copy(
+        Kokkos::HostSpace(), nlist.counts );
+    auto neighbors_mirror = Kokkos::create_mirror_view_and_copy(
+        Kokkos::HostSpace(), nlist.neighbors );
+    auto distances_mirror = Kokkos::create_mirror_view_and_copy(
+        Kokkos::HostSpace(), nlist.distances );
+    auto aosoa_mirror = Cabana::create_mirror_view_and_copy(
+        Kokkos::HostSpace(), test_data.aosoa );
+    auto position_mirror = Cabana::slice<0>( aosoa_mirror );
+
+    using list_type = Cabana::KNearestNeighborList<TEST_MEMSPACE>;
+    EXPECT_EQ(
+        Cabana::NeighborList<list_type>::maxNeighbor( nlist ),
+        static_cast<std::size_t>( k ) );
+    std::vector<std::pair<double, int>> candidates;
+    for ( int p = 0; p < test_data.num_particle; ++p )
+    {
+        if ( p < test_data.num_ignore )
+        {
+            EXPECT_EQ( counts_mirror( p ), 0 );
+            continue;
+        }
+
+        candidates.clear();
+        for ( int n = 0; n < test_data.num_particle; ++n )
+        {
+            if ( n == p )
+                continue;
+            double dsqr = 0.0;
+            for ( int d = 0; d < 3; ++d )
+                dsqr += ( position_mirror( p, d ) - position_mirror( n, d ) ) *
+                        ( position_mirror( p, d ) - position_mirror( n, d ) );
+            candidates.push_back( std::make_pair( dsqr, n ) );
+        }
+        std::sort( candidates.begin(), candidates.end() );
+
+        EXPECT_EQ( counts_mirror( p ), k );
+        for ( int n = 0; n < k; ++n )
+        {
+            EXPECT_EQ( neighbors_mirror( p, n ), candidates[n].second );
+            EXPECT_DOUBLE_EQ( distances_mirror( p, n ), candidates[n].first );
+        }
+    }
+}
+
 //---------------------------------------------------------------------------//
 // TESTS
 //---------------------------------------------------------------------------//
@@ -373,6 +655,33 @@ TEST( TEST_CATEGORY, verlet_list_full_range_test )
                                    Cabana::TeamVectorOpTag>();
 }
 
+//---------------------------------------------------------------------------//
+TEST( TEST_CATEGORY, verlet_list_local_ghost_test )
+{
+#ifndef KOKKOS_ENABLE_OPENMPTARGET // FIXME_OPENMPTARGET
+    testVerletListLocalGhost<Cabana::VerletLayoutCSR, Cabana::TeamOpTag>();
+#endif
+    testVerletListLocalGhost<Cabana::VerletLayout2D, Cabana::TeamOpTag>();
+
+#ifndef KOKKOS_ENABLE_OPENMPTARGET // FIXME_OPENMPTARGET
+    testVerletListLocalGhost<Cabana::VerletLayoutCSR,
+                             Cabana::TeamVectorOpTag>();
+#endif
+    testVerletListLocalGhost<Cabana::VerletLayout2D,
+                             Cabana::TeamVectorOpTag>();
+}
+
+//---------------------------------------------------------------------------//
+TEST( TEST_CATEGORY, verlet_list_update_test )
+{
+#ifndef KOKKOS_ENABLE_OPENMPTARGET // FIXME_OPENMPTARGET
+    testVerletListUpdate<Cabana::FullNeighborTag, Cabana::VerletLayoutCSR>();
+    testVerletListUpdate<Cabana::HalfNeighborTag, Cabana::VerletLayoutCSR>();
+    testVerletListUpdate<Cabana::FullNeighborTag, Cabana::VerletLayout2D>();
+    testVerletListUpdate<Cabana::HalfNeighborTag, Cabana::VerletLayout2D>();
+#endif
+}
+
 //---------------------------------------------------------------------------//
 TEST( TEST_CATEGORY, parallel_for_test )
 {
@@ -391,6 +700,18 @@ TEST( TEST_CATEGORY, parallel_reduce_test )
     testNeighborParallelReduce<Cabana::VerletLayout2D>();
 }
 
+//---------------------------------------------------------------------------//
+TEST( TEST_CATEGORY, triplet_list_test )
+{
+#ifndef KOKKOS_ENABLE_OPENMPTARGET // FIXME_OPENMPTARGET
+    testTripletList<Cabana::VerletLayoutCSR>();
+#endif
+    testTripletList<Cabana::VerletLayout2D>();
+}
+
+//---------------------------------------------------------------------------//
+TEST( TEST_CATEGORY, knn_list_test ) { testKNearestNeighborList(); }
+
 //---------------------------------------------------------------------------//
 TEST( TEST_CATEGORY, modify_list_test )
 {
@@ -306,6 +306,88 @@ void testNeighborArborXParallelReduce()
     }
 }
 
+//---------------------------------------------------------------------------//
+void testArborXNeighborSearch()
+{
+    // Create the AoSoA and fill with random particle positions.
+    NeighborListTestData test_data;
+    auto position = Cabana::slice<0>( test_data.aosoa );
+
+    using device_type = TEST_MEMSPACE; // sigh...
+
+    double skin = 0.5;
+    Cabana::Experimental::NeighborSearch<device_type, Cabana::FullNeighborTag>
+        full_search( Cabana::FullNeighborTag{}, skin );
+    Cabana::Experimental::NeighborSearch<device_type, Cabana::HalfNeighborTag>
+        half_search( Cabana::HalfNeighborTag{}, skin );
+
+    // Check the lists built on the inflated tree.
+    {
+        auto const nlist = full_search.makeNeighborList(
+            position, 0, position.size(), test_data.test_radius );
+        checkFullNeighborList( nlist, test_data.N2_list_copy,
+                               test_data.num_particle );
+    }
+    {
+        auto const nlist = full_search.make2DNeighborList(
+            position, 0, position.size(), test_data.test_radius );
+        checkFullNeighborList( nlist, test_data.N2_list_copy,
+                               test_data.num_particle );
+    }
+    {
+        auto const nlist = half_search.make2DNeighborList(
+            position, 0, position.size(), test_data.test_radius );
+        checkHalfNeighborList( nlist, test_data.N2_list_copy,
+                               test_data.num_particle );
+    }
+    EXPECT_EQ( full_search.numBuild(), 1 );
+    EXPECT_EQ( half_search.numBuild(), 1 );
+    EXPECT_GT( full_search.bufferSize(), 0 );
+
+    // Move the particles by less than half of the skin. The tree is reused
+    // and the lists match the moved positions.
+    Kokkos::parallel_for(
+        "move", Kokkos::RangePolicy<TEST_EXECSPACE>( 0, position.size() ),
+        KOKKOS_LAMBDA( const int i ) {
+            for ( int d = 0; d < 3; ++d )
+                position( i, d ) += 0.1 * ( ( i + d ) % 3 - 1 );
+        } );
+    Kokkos::fence();
+    auto moved_list =
+        computeFullNeighborList( position, test_data.test_radius );
+    auto moved_list_copy = createTestListHostCopy( moved_list );
+    {
+        auto const nlist = full_search.makeNeighborList(
+            position, 0, position.size(), test_data.test_radius );
+        checkFullNeighborList( nlist, moved_list_copy,
+                               test_data.num_particle );
+    }
+    {
+        auto const nlist = half_search.make2DNeighborList(
+            position, 0, position.size(), test_data.test_radius );
+        checkHalfNeighborList( nlist, moved_list_copy,
+                               test_data.num_particle );
+    }
+    EXPECT_EQ( full_search.numBuild(), 1 );
+    EXPECT_EQ( half_search.numBuild(), 1 );
+
+    // Moving further triggers a rebuild.
+    Kokkos::parallel_for(
+        "move", Kokkos::RangePolicy<TEST_EXECSPACE>( 0, position.size() ),
+        KOKKOS_LAMBDA( const int i ) { position( i, 0 ) += 0.3; } );
+    Kokkos::fence();
+    EXPECT_TRUE( full_search.needsRebuild( position ) );
+    moved_list = computeFullNeighborList( position, test_data.test_radius );
+    moved_list_copy = createTestListHostCopy( moved_list );
+    {
+        auto const nlist = full_search.makeNeighborList(
+            position, 0, position.size(), test_data.test_radius );
+        checkFullNeighborList( nlist, moved_list_copy,
+                               test_data.num_particle );
+    }
+    EXPECT_EQ( full_search.numBuild(), 2 );
+}
+
 //---------------------------------------------------------------------------//
 // TESTS
 //---------------------------------------------------------------------------//
@@ -328,6 +410,9 @@ TEST( TEST_CATEGORY, parallel_reduce_test )
 {
     testNeighborArborXParallelReduce();
 }
+
+//---------------------------------------------------------------------------//
+TEST( TEST_CATEGORY, neighbor_search_test ) { testArborXNeighborSearch(); }
 //---------------------------------------------------------------------------//
 
 } // end namespace Test
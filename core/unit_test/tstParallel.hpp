@@ -247,11 +247,84 @@ void runTest2d()
                       ival / 2.0, dim_1, dim_2, dim_3 );
 }
 
+//---------------------------------------------------------------------------//
+// Parallel for test with explicit SIMD types. Explicit SIMD mode is only
+// available on host execution spaces.
+template <class ExecutionSpace>
+std::enable_if_t<
+    !Cabana::is_accessible_from<Kokkos::HostSpace, ExecutionSpace>::value>
+runTestExplicitSimd()
+{
+}
+
+template <class ExecutionSpace>
+std::enable_if_t<
+    Cabana::is_accessible_from<Kokkos::HostSpace, ExecutionSpace>::value>
+runTestExplicitSimd()
+{
+    // Declare the AoSoA type.
+    using DataTypes = Cabana::MemberTypes<double[2], double>;
+    using AoSoA_t = Cabana::AoSoA<DataTypes, TEST_MEMSPACE, 16>;
+
+    // Create an AoSoA.
+    int num_data = 155;
+    AoSoA_t aosoa( "aosoa", num_data );
+    auto x = Cabana::slice<0>( aosoa );
+    auto y = Cabana::slice<1>( aosoa );
+    Kokkos::parallel_for(
+        "fill", Kokkos::RangePolicy<ExecutionSpace>( 0, num_data ),
+        KOKKOS_LAMBDA( const int i ) {
+            x( i, 0 ) = i;
+            x( i, 1 ) = -i;
+            y( i ) = 0.0;
+        } );
+    Kokkos::fence();
+
+    // Compute with SIMD values and a masked branch over a range starting and
+    // ending in the middle of an SoA.
+    int range_begin = 3;
+    int range_end = 148;
+    Cabana::SimdPolicy<AoSoA_t::vector_length, ExecutionSpace> policy(
+        range_begin, range_end );
+    auto simd_op = KOKKOS_LAMBDA( const auto& lanes )
+    {
+        using lanes_type = std::decay_t<decltype( lanes )>;
+        using simd_type = typename lanes_type::template simd_type<double>;
+        auto x0 = Cabana::simdLoad( lanes, x, 0 );
+        auto x1 = Cabana::simdLoad( lanes, x, 1 );
+        simd_type r = x0 * simd_type( 2.0 ) + x1;
+        Kokkos::Experimental::where( r > simd_type( 50.0 ), r ) =
+            simd_type( 50.0 );
+        Cabana::simdStore( lanes, r, y );
+    };
+    Cabana::simd_parallel_for( policy, simd_op, Cabana::ExplicitSimdTag(),
+                               "explicit_simd_test" );
+    Kokkos::fence();
+
+    // Check the result.
+    auto mirror =
+        Cabana::create_mirror_view_and_copy( Kokkos::HostSpace(), aosoa );
+    auto y_mirror = Cabana::slice<1>( mirror );
+    for ( int i = 0; i < num_data; ++i )
+    {
+        if ( i >= range_begin && i < range_end )
+            EXPECT_EQ( y_mirror( i ), ( i > 50 ) ? 50.0 : i );
+        else
+            EXPECT_EQ( y_mirror( i ), 0.0 );
+    }
+}
+
 //---------------------------------------------------------------------------//
 // RUN TESTS
 //---------------------------------------------------------------------------//
 TEST( TEST_CATEGORY, simd_parallel_for_test ) { runTest2d(); }
 
+//---------------------------------------------------------------------------//
+TEST( TEST_CATEGORY, explicit_simd_parallel_for_test )
+{
+    runTestExplicitSimd<TEST_EXECSPACE>();
+}
+
 //---------------------------------------------------------------------------//
 
 } // end namespace Test
@@ -0,0 +1,167 @@
+/****************************************************************************
+ * Copyright (c) 2018-2022 by the Cabana authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the Cabana library. Cabana is distributed under a   *
+ * BSD 3-clause license. For the licensing terms see the LICENSE file in    *
+ * the top-level directory.                                                 *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#include <Cabana_AoSoA.hpp>
+#include <Cabana_DeepCopy.hpp>
+#include <Cabana_ParticleAppender.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+namespace Test
+{
+//---------------------------------------------------------------------------//
+using DataTypes = Cabana::MemberTypes<int, double>;
+using AoSoA_t = Cabana::AoSoA<DataTypes, TEST_MEMSPACE>;
+
+//---------------------------------------------------------------------------//
+// Each source i creates i % 3 particles.
+struct SourceFunctor
+{
+    KOKKOS_INLINE_FUNCTION
+    void operator()( const int i,
+                     const Cabana::ParticleAppender<AoSoA_t>& appender ) const
+    {
+        int n = i % 3;
+        if ( 0 == n )
+            return;
+        typename AoSoA_t::size_type slot;
+        if ( appender.claim( slot, n ) )
+        {
+            for ( int c = 0; c < n; ++c )
+            {
+                typename AoSoA_t::tuple_type tpl;
+                Cabana::get<0>( tpl ) = i;
+                Cabana::get<1>( tpl ) = c;
+                appender.setTuple( slot + c, tpl );
+            }
+        }
+    }
+};
+
+//---------------------------------------------------------------------------//
+// Check the original particles are untouched and each source created its
+// particles.
+void checkAppended( const AoSoA_t& aosoa, const int num_original,
+                    const int num_source )
+{
+    auto aosoa_host =
+        Cabana::create_mirror_view_and_copy( Kokkos::HostSpace(), aosoa );
+    auto id = Cabana::slice<0>( aosoa_host );
+    auto value = Cabana::slice<1>( aosoa_host );
+
+    for ( int p = 0; p < num_original; ++p )
+    {
+        EXPECT_EQ( id( p ), -1 );
+        EXPECT_EQ( value( p ), p );
+    }
+
+    std::vector<int> created( num_source, 0 );
+    for ( std::size_t p = num_original; p < aosoa_host.size(); ++p )
+    {
+        created[id( p )] += 1;
+        EXPECT_LT( value( p ), id( p ) % 3 );
+    }
+    for ( int i = 0; i < num_source; ++i )
+        EXPECT_EQ( created[i], i % 3 );
+}
+
+//---------------------------------------------------------------------------//
+AoSoA_t createOriginal( const int num_original )
+{
+    AoSoA_t aosoa( "aosoa", num_original );
+    auto id = Cabana::slice<0>( aosoa );
+    auto value = Cabana::slice<1>( aosoa );
+    Kokkos::parallel_for(
+        "fill", Kokkos::RangePolicy<TEST_EXECSPACE>( 0, num_original ),
+        KOKKOS_LAMBDA( const int p ) {
+            id( p ) = -1;
+            value( p ) = p;
+        } );
+    Kokkos::fence();
+    return aosoa;
+}
+
+//---------------------------------------------------------------------------//
+void testAppender()
+{
+    int num_original = 67;
+    int num_source = 301;
+    int num_created = 0;
+    for ( int i = 0; i < num_source; ++i )
+        num_created += i % 3;
+
+    auto aosoa = createOriginal( num_original );
+
+    // Overflow with a small headroom.
+    Cabana::ParticleAppender<AoSoA_t> appender( aosoa, 10 );
+    EXPECT_EQ( static_cast<int>( aosoa.size() ), num_original + 10 );
+    SourceFunctor source;
+    auto append_op = KOKKOS_LAMBDA( const int i ) { source( i, appender ); };
+    Kokkos::RangePolicy<TEST_EXECSPACE> policy( 0, num_source );
+    Kokkos::parallel_for( "append", policy, append_op );
+    Kokkos::fence();
+    EXPECT_FALSE( appender.finalize( aosoa ) );
+    EXPECT_EQ( static_cast<int>( aosoa.size() ), num_original );
+    EXPECT_EQ( static_cast<int>( appender.numClaimed() ), num_created );
+
+    // Run again with the required headroom.
+    appender.reset( aosoa, appender.numClaimed() );
+    auto retry_op = KOKKOS_LAMBDA( const int i ) { source( i, appender ); };
+    Kokkos::parallel_for( "append_retry", policy, retry_op );
+    Kokkos::fence();
+    EXPECT_TRUE( appender.finalize( aosoa ) );
+    EXPECT_EQ( static_cast<int>( aosoa.size() ), num_original + num_created );
+    checkAppended( aosoa, num_original, num_source );
+}
+
+//---------------------------------------------------------------------------//
+void testAppendParticles()
+{
+    int num_original = 67;
+    int num_source = 301;
+    int num_created = 0;
+    for ( int i = 0; i < num_source; ++i )
+        num_created += i % 3;
+
+    // Enough headroom for a single pass.
+    {
+        auto aosoa = createOriginal( num_original );
+        auto num_append = Cabana::appendParticles(
+            TEST_EXECSPACE{}, aosoa, num_source, SourceFunctor{}, 1000 );
+        EXPECT_EQ( static_cast<int>( num_append ), num_created );
+        checkAppended( aosoa, num_original, num_source );
+    }
+
+    // Headroom too small so the kernel is run again.
+    {
+        auto aosoa = createOriginal( num_original );
+        auto num_append =
+            Cabana::appendParticles( aosoa, num_source, SourceFunctor{}, 5 );
+        EXPECT_EQ( static_cast<int>( num_append ), num_created );
+        checkAppended( aosoa, num_original, num_source );
+    }
+}
+
+//---------------------------------------------------------------------------//
+// RUN TESTS
+//---------------------------------------------------------------------------//
+TEST( TEST_CATEGORY, appender_test ) { testAppender(); }
+
+//---------------------------------------------------------------------------//
+TEST( TEST_CATEGORY, append_particles_test ) { testAppendParticles(); }
+
+//---------------------------------------------------------------------------//
+
+} // end namespace Test
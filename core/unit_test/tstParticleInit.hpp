@@ -17,6 +17,9 @@
 
 #include <gtest/gtest.h>
 
+#include <cstdint>
+#include <stdexcept>
+
 template <class PositionType>
 void checkRandomParticles( const int num_particle, const double box_min,
                            const double box_max,
@@ -35,14 +38,14 @@ void checkRandomParticles( const int num_particle, const double box_min,
 }
 
 template <class PositionType>
-void checkRandomDistances( const int min_distance,
+void checkRandomDistances( const double min_distance,
                            const PositionType host_positions )
 {
     std::size_t num_particle = host_positions.size();
 
     // Check that none of the particles are are too close.
     for ( std::size_t i = 0; i < num_particle; ++i )
-        for ( std::size_t j = 0; j < num_particle; ++j )
+        for ( std::size_t j = i + 1; j < num_particle; ++j )
         {
             double dsqr = 0.0;
             for ( int d = 0; d < 3; ++d )
@@ -50,7 +53,7 @@ void checkRandomDistances( const int min_distance,
                 double diff = host_positions( i, d ) - host_positions( j, d );
                 dsqr += diff * diff;
             }
-            EXPECT_GE( dsqr, min_distance );
+            EXPECT_GE( dsqr, min_distance * min_distance );
         }
 }
 
@@ -74,6 +77,87 @@ void testRandomCreationMinDistance()
     checkRandomDistances( min_dist, host_positions );
 }
 
+void testRandomCreationMinDistanceDense()
+{
+    // Fill about 60% of the random sequential packing limit.
+    int num_particle = 2000;
+    double min_dist = 0.6;
+    double box_min = 0.0;
+    double box_max = 10.0;
+    using aosoa_type =
+        Cabana::AoSoA<Cabana::MemberTypes<double[3]>, TEST_MEMSPACE>;
+    aosoa_type aosoa( "random", num_particle );
+    auto positions = Cabana::slice<0>( aosoa );
+    Cabana::createRandomParticlesMinDistance(
+        TEST_EXECSPACE{}, positions, positions.size(), box_min, box_max,
+        min_dist, 1234 );
+    auto host_aosoa =
+        Cabana::create_mirror_view_and_copy( Kokkos::HostSpace(), aosoa );
+    auto host_positions = Cabana::slice<0>( host_aosoa );
+
+    checkRandomParticles( num_particle, box_min, box_max, host_positions );
+    checkRandomDistances( min_dist, host_positions );
+
+    // The same seed gives the same particles and another seed does not.
+    aosoa_type same( "same", num_particle );
+    auto same_positions = Cabana::slice<0>( same );
+    Cabana::createRandomParticlesMinDistance(
+        TEST_EXECSPACE{}, same_positions, same_positions.size(), box_min,
+        box_max, min_dist, 1234 );
+    aosoa_type other( "other", num_particle );
+    auto other_positions = Cabana::slice<0>( other );
+    Cabana::createRandomParticlesMinDistance(
+        TEST_EXECSPACE{}, other_positions, other_positions.size(), box_min,
+        box_max, min_dist, 4321 );
+    auto host_same =
+        Cabana::create_mirror_view_and_copy( Kokkos::HostSpace(), same );
+    auto host_other =
+        Cabana::create_mirror_view_and_copy( Kokkos::HostSpace(), other );
+    auto same_host_positions = Cabana::slice<0>( host_same );
+    auto other_host_positions = Cabana::slice<0>( host_other );
+    int num_different = 0;
+    for ( int p = 0; p < num_particle; ++p )
+        for ( int d = 0; d < 3; ++d )
+        {
+            EXPECT_EQ( same_host_positions( p, d ), host_positions( p, d ) );
+            if ( other_host_positions( p, d ) != host_positions( p, d ) )
+                ++num_different;
+        }
+    EXPECT_GT( num_different, 0 );
+
+    // Too many particles for the box cannot be placed.
+    aosoa_type too_many( "too_many", 20 * num_particle );
+    auto too_many_positions = Cabana::slice<0>( too_many );
+    EXPECT_THROW( Cabana::createRandomParticlesMinDistance(
+                      too_many_positions, too_many_positions.size(), box_min,
+                      box_max, min_dist ),
+                  std::runtime_error );
+}
+
+void testRandomCreationMinDistanceCoarse()
+{
+    // A minimum distance slightly larger than two background cells.
+    std::size_t num_particle = 20;
+    double min_dist = 0.34;
+    double box_min = 0.0;
+    double box_max = 1.0;
+    Cabana::AoSoA<Cabana::MemberTypes<double[3]>, TEST_MEMSPACE> aosoa(
+        "random", num_particle );
+    auto positions = Cabana::slice<0>( aosoa );
+    for ( std::uint64_t seed = 1; seed <= 10; ++seed )
+    {
+        Cabana::createRandomParticlesMinDistance(
+            positions, num_particle, box_min, box_max, min_dist, seed );
+        auto host_aosoa =
+            Cabana::create_mirror_view_and_copy( Kokkos::HostSpace(), aosoa );
+        auto host_positions = Cabana::slice<0>( host_aosoa );
+
+        checkRandomParticles( num_particle, box_min, box_max,
+                              host_positions );
+        checkRandomDistances( min_dist, host_positions );
+    }
+}
+
 void testRandomCreation()
 {
     int num_particle = 200;
@@ -95,5 +179,7 @@ void testRandomCreation()
 TEST( TEST_CATEGORY, random_particle_creation_test )
 {
     testRandomCreationMinDistance();
+    testRandomCreationMinDistanceDense();
+    testRandomCreationMinDistanceCoarse();
     testRandomCreation();
 }
@@ -0,0 +1,138 @@
+/****************************************************************************
+ * Copyright (c) 2018-2022 by the Cabana authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the Cabana library. Cabana is distributed under a   *
+ * BSD 3-clause license. For the licensing terms see the LICENSE file in    *
+ * the top-level directory.                                                 *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#include <Cabana_AoSoA.hpp>
+#include <Cabana_DeepCopy.hpp>
+#include <Cabana_ParticleSelection.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+
+namespace Test
+{
+//---------------------------------------------------------------------------//
+// Select particles with even ids.
+template <class SliceType>
+struct EvenIdPredicate
+{
+    SliceType ids;
+
+    KOKKOS_INLINE_FUNCTION
+    bool operator()( const int i ) const { return 0 == ids( i ) % 2; }
+};
+
+//---------------------------------------------------------------------------//
+void selectionTest()
+{
+    // Particles on a line with their index as id.
+    int num_particle = 100;
+    using DataTypes = Cabana::MemberTypes<double[3], int>;
+    Cabana::AoSoA<DataTypes, TEST_MEMSPACE> aosoa( "particles", num_particle );
+    auto aosoa_host = Cabana::create_mirror_view( Kokkos::HostSpace(), aosoa );
+    auto x_host = Cabana::slice<0>( aosoa_host );
+    auto id_host = Cabana::slice<1>( aosoa_host );
+    for ( int p = 0; p < num_particle; ++p )
+    {
+        for ( int d = 0; d < 3; ++d )
+            x_host( p, d ) = 0.01 * p;
+        id_host( p ) = p;
+    }
+    Cabana::deep_copy( aosoa, aosoa_host );
+    auto x = Cabana::slice<0>( aosoa );
+    auto id = Cabana::slice<1>( aosoa );
+
+    // Gather the selected ids and check them against the expected indices.
+    auto check_selection = [&]( const auto& selection, auto expected )
+    {
+        Kokkos::View<int*, TEST_MEMSPACE> selected_id( "selected_id",
+                                                       selection.size() );
+        Cabana::Impl::copySelectionToView( selected_id, id, selection );
+        auto selected_host = Kokkos::create_mirror_view_and_copy(
+            Kokkos::HostSpace(), selected_id );
+        std::size_t count = 0;
+        for ( int p = 0; p < num_particle; ++p )
+            if ( expected( p ) )
+            {
+                ASSERT_LT( count, selection.size() );
+                EXPECT_EQ( selected_host( count ), p );
+                ++count;
+            }
+        EXPECT_EQ( count, selection.size() );
+    };
+
+    // Stride.
+    auto stride =
+        Cabana::createStrideSelection<TEST_MEMSPACE>( num_particle, 7, 3 );
+    check_selection( stride, []( int p ) { return p >= 3 && p % 7 == 3; } );
+    EXPECT_THROW(
+        Cabana::createStrideSelection<TEST_MEMSPACE>( num_particle, 0 ),
+        std::runtime_error );
+
+    // Random selections are reproducible.
+    auto random1 = Cabana::createRandomSelection<TEST_MEMSPACE>( num_particle,
+                                                                 0.3, 1234 );
+    auto random2 = Cabana::createRandomSelection<TEST_MEMSPACE>( num_particle,
+                                                                 0.3, 1234 );
+    ASSERT_EQ( random1.size(), random2.size() );
+    EXPECT_GT( random1.size(), 0u );
+    EXPECT_LT( random1.size(), std::size_t( num_particle ) );
+    auto random1_host = Kokkos::create_mirror_view_and_copy(
+        Kokkos::HostSpace(), random1.indices() );
+    auto random2_host = Kokkos::create_mirror_view_and_copy(
+        Kokkos::HostSpace(), random2.indices() );
+    for ( std::size_t n = 0; n < random1.size(); ++n )
+        EXPECT_EQ( random1_host( n ), random2_host( n ) );
+    EXPECT_EQ( Cabana::createRandomSelection<TEST_MEMSPACE>( num_particle,
+                                                             1.0 )
+                   .size(),
+               std::size_t( num_particle ) );
+
+    // Mask.
+    Kokkos::View<int*, TEST_MEMSPACE> mask( "mask", num_particle );
+    auto mask_host = Kokkos::create_mirror_view( mask );
+    for ( int p = 0; p < num_particle; ++p )
+        mask_host( p ) = ( p % 10 == 0 );
+    Kokkos::deep_copy( mask, mask_host );
+    auto masked = Cabana::createSelection<TEST_MEMSPACE>( num_particle, mask );
+    check_selection( masked, []( int p ) { return p % 10 == 0; } );
+
+    // Predicate.
+    auto even = Cabana::createSelection<TEST_MEMSPACE>(
+        num_particle, EvenIdPredicate<decltype( id )>{ id } );
+    check_selection( even, []( int p ) { return p % 2 == 0; } );
+
+    // Region.
+    auto region = Cabana::createRegionSelection(
+        x, { 0.205, 0.205, 0.205 }, { 0.505, 1.0, 1.0 } );
+    check_selection( region, []( int p ) { return p > 20 && p <= 50; } );
+
+    // Gather vector data of the selection.
+    Kokkos::View<double**, Kokkos::LayoutRight, TEST_MEMSPACE> x_selected(
+        "x_selected", region.size(), 3 );
+    Cabana::Impl::copySelectionToView( x_selected, x, region );
+    auto x_selected_host = Kokkos::create_mirror_view_and_copy(
+        Kokkos::HostSpace(), x_selected );
+    for ( std::size_t n = 0; n < region.size(); ++n )
+        for ( int d = 0; d < 3; ++d )
+            EXPECT_DOUBLE_EQ( x_selected_host( n, d ), 0.01 * ( n + 21 ) );
+}
+
+//---------------------------------------------------------------------------//
+// RUN TESTS
+//---------------------------------------------------------------------------//
+TEST( TEST_CATEGORY, selection_test ) { selectionTest(); }
+
+//---------------------------------------------------------------------------//
+
+} // end namespace Test
@@ -0,0 +1,175 @@
+/****************************************************************************
+ * Copyright (c) 2018-2022 by the Cabana authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the Cabana library. Cabana is distributed under a   *
+ * BSD 3-clause license. For the licensing terms see the LICENSE file in    *
+ * the top-level directory.                                                 *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#include <Cabana_AoSoA.hpp>
+#include <Cabana_DeepCopy.hpp>
+#include <Cabana_Remove.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+namespace Test
+{
+//---------------------------------------------------------------------------//
+using DataTypes = Cabana::MemberTypes<int, double[3], int>;
+using AoSoA_t = Cabana::AoSoA<DataTypes, TEST_MEMSPACE>;
+
+//---------------------------------------------------------------------------//
+// Fill the AoSoA with ids and flag every third particle for removal.
+AoSoA_t createRemoveData( const int num_data )
+{
+    AoSoA_t aosoa( "aosoa", num_data );
+    auto id = Cabana::slice<0>( aosoa );
+    auto x = Cabana::slice<1>( aosoa );
+    auto flag = Cabana::slice<2>( aosoa );
+    Kokkos::parallel_for(
+        "fill", Kokkos::RangePolicy<TEST_EXECSPACE>( 0, num_data ),
+        KOKKOS_LAMBDA( const int p ) {
+            id( p ) = p;
+            for ( int d = 0; d < 3; ++d )
+                x( p, d ) = p + d;
+            flag( p ) = ( p % 3 == 0 ) ? 1 : 0;
+        } );
+    Kokkos::fence();
+    return aosoa;
+}
+
+//---------------------------------------------------------------------------//
+// Check that exactly the particles not divisible by 3 remain.
+void checkRemoved( const AoSoA_t& aosoa, const int num_data,
+                   const bool ordered )
+{
+    auto aosoa_host =
+        Cabana::create_mirror_view_and_copy( Kokkos::HostSpace(), aosoa );
+    auto id = Cabana::slice<0>( aosoa_host );
+    auto x = Cabana::slice<1>( aosoa_host );
+    auto flag = Cabana::slice<2>( aosoa_host );
+
+    int num_keep = num_data - ( num_data + 2 ) / 3;
+    EXPECT_EQ( static_cast<int>( aosoa.size() ), num_keep );
+
+    std::vector<int> found( num_data, 0 );
+    for ( std::size_t p = 0; p < aosoa_host.size(); ++p )
+    {
+        EXPECT_NE( id( p ) % 3, 0 );
+        EXPECT_EQ( flag( p ), 0 );
+        for ( int d = 0; d < 3; ++d )
+            EXPECT_EQ( x( p, d ), id( p ) + d );
+        if ( ordered && p > 0 )
+            EXPECT_GT( id( p ), id( p - 1 ) );
+        ++found[id( p )];
+    }
+    for ( int p = 0; p < num_data; ++p )
+        EXPECT_EQ( found[p], ( p % 3 == 0 ) ? 0 : 1 );
+}
+
+//---------------------------------------------------------------------------//
+void testRemoveMask()
+{
+    int num_data = 1034;
+
+    // Ordered removal with a slice mask.
+    {
+        auto aosoa = createRemoveData( num_data );
+        auto num_remove =
+            Cabana::remove_if( aosoa, Cabana::slice<2>( aosoa ) );
+        EXPECT_EQ( static_cast<int>( num_remove ), ( num_data + 2 ) / 3 );
+        checkRemoved( aosoa, num_data, true );
+    }
+
+    // Unordered removal with a view mask.
+    {
+        auto aosoa = createRemoveData( num_data );
+        Kokkos::View<int*, TEST_MEMSPACE> mask( "mask", num_data );
+        Kokkos::parallel_for(
+            "mask", Kokkos::RangePolicy<TEST_EXECSPACE>( 0, num_data ),
+            KOKKOS_LAMBDA( const int p ) { mask( p ) = ( p % 3 == 0 ); } );
+        Kokkos::fence();
+        auto num_remove = Cabana::remove_if( TEST_EXECSPACE{}, aosoa, mask,
+                                             Cabana::UnorderedRemoveTag{} );
+        EXPECT_EQ( static_cast<int>( num_remove ), ( num_data + 2 ) / 3 );
+        checkRemoved( aosoa, num_data, false );
+    }
+}
+
+//---------------------------------------------------------------------------//
+void testRemovePredicate()
+{
+    int num_data = 1034;
+
+    // The predicate reads the particle data.
+    for ( int ordered = 0; ordered < 2; ++ordered )
+    {
+        auto aosoa = createRemoveData( num_data );
+        auto id = Cabana::slice<0>( aosoa );
+        auto pred = KOKKOS_LAMBDA( const int p ) { return id( p ) % 3 == 0; };
+        if ( ordered )
+            Cabana::remove_if( aosoa, pred, Cabana::OrderedRemoveTag{} );
+        else
+            Cabana::remove_if( aosoa, pred, Cabana::UnorderedRemoveTag{} );
+        checkRemoved( aosoa, num_data, ordered );
+    }
+
+    // Nothing to remove.
+    auto keep_all = KOKKOS_LAMBDA( const int ) { return false; };
+    {
+        auto aosoa = createRemoveData( num_data );
+        auto num_remove = Cabana::remove_if( aosoa, keep_all );
+        EXPECT_EQ( num_remove, 0u );
+        EXPECT_EQ( static_cast<int>( aosoa.size() ), num_data );
+    }
+    {
+        auto aosoa = createRemoveData( num_data );
+        auto num_remove = Cabana::remove_if( aosoa, keep_all,
+                                             Cabana::UnorderedRemoveTag{} );
+        EXPECT_EQ( num_remove, 0u );
+        EXPECT_EQ( static_cast<int>( aosoa.size() ), num_data );
+    }
+
+    // Empty containers.
+    auto remove_all = KOKKOS_LAMBDA( const int ) { return true; };
+    {
+        AoSoA_t aosoa( "empty", 0 );
+        EXPECT_EQ( Cabana::remove_if( aosoa, remove_all ), 0u );
+        EXPECT_EQ( Cabana::remove_if( aosoa, remove_all,
+                                      Cabana::OrderedRemoveTag{} ),
+                   0u );
+        EXPECT_EQ( Cabana::remove_if( aosoa, remove_all,
+                                      Cabana::UnorderedRemoveTag{} ),
+                   0u );
+        EXPECT_EQ( aosoa.size(), 0u );
+    }
+
+    // Remove everything.
+    {
+        auto aosoa = createRemoveData( num_data );
+        auto pred = KOKKOS_LAMBDA( const int ) { return true; };
+        auto num_remove = Cabana::remove_if( aosoa, pred,
+                                             Cabana::UnorderedRemoveTag{} );
+        EXPECT_EQ( static_cast<int>( num_remove ), num_data );
+        EXPECT_EQ( aosoa.size(), 0u );
+    }
+}
+
+//---------------------------------------------------------------------------//
+// RUN TESTS
+//---------------------------------------------------------------------------//
+TEST( TEST_CATEGORY, remove_mask_test ) { testRemoveMask(); }
+
+//---------------------------------------------------------------------------//
+TEST( TEST_CATEGORY, remove_predicate_test ) { testRemovePredicate(); }
+
+//---------------------------------------------------------------------------//
+
+} // end namespace Test
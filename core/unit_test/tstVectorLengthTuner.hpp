@@ -0,0 +1,120 @@
+/****************************************************************************
+ * Copyright (c) 2018-2022 by the Cabana authors                            *
+ * All rights reserved.                                                     *
+ *                                                                          *
+ * This file is part of the Cabana library. Cabana is distributed under a   *
+ * BSD 3-clause license. For the licensing terms see the LICENSE file in    *
+ * the top-level directory.                                                 *
+ *                                                                          *
+ * SPDX-License-Identifier: BSD-3-Clause                                    *
+ ****************************************************************************/
+
+#include <Cabana_AoSoA.hpp>
+#include <Cabana_VectorLengthTuner.hpp>
+
+#include <Kokkos_Core.hpp>
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <stdexcept>
+
+namespace Test
+{
+//---------------------------------------------------------------------------//
+// Stream one member. Device lambdas cannot be defined inside the generic
+// tuning kernel so the loop body is a functor.
+template <class SliceType>
+struct FillFunctor
+{
+    SliceType a;
+
+    KOKKOS_INLINE_FUNCTION
+    void operator()( const int p ) const { a( p ) = p; }
+};
+
+struct TuneKernel
+{
+    int* num_call;
+
+    template <class AoSoAType>
+    void operator()( AoSoAType& aosoa ) const
+    {
+        auto a = Cabana::slice<1>( aosoa );
+        Kokkos::parallel_for(
+            "tune", Kokkos::RangePolicy<TEST_EXECSPACE>( 0, aosoa.size() ),
+            FillFunctor<decltype( a )>{ a } );
+        ++( *num_call );
+    }
+};
+
+//---------------------------------------------------------------------------//
+void testDispatch()
+{
+    using candidates = Cabana::VectorLengthList<1, 8, 16>;
+    static_assert( candidates::size == 3, "" );
+
+    int called = 0;
+    Cabana::dispatchVectorLength( 8, candidates(), [&]( auto vl ) {
+        called = decltype( vl )::value;
+    } );
+    EXPECT_EQ( called, 8 );
+
+    EXPECT_THROW( Cabana::dispatchVectorLength( 4, candidates(),
+                                                [&]( auto ) { called = -1; } ),
+                  std::runtime_error );
+    EXPECT_EQ( called, 8 );
+}
+
+//---------------------------------------------------------------------------//
+void testTuner()
+{
+    using DataTypes = Cabana::MemberTypes<double[3], double, int>;
+    using candidates = Cabana::VectorLengthList<1, 8, 16>;
+    using tuner_type =
+        Cabana::VectorLengthTuner<DataTypes, TEST_MEMSPACE, candidates>;
+
+    tuner_type tuner( "test" );
+    EXPECT_EQ( tuner.vectorLength(), 1 );
+
+    int num_call = 0;
+    TuneKernel kernel{ &num_call };
+    int num_particle = 1000;
+    int num_run = 2;
+    int vl = tuner.tune( num_particle, kernel, num_run );
+
+    // Each candidate is warmed up and then run.
+    EXPECT_EQ( num_call, 3 * ( num_run + 1 ) );
+    EXPECT_EQ( vl, tuner.vectorLength() );
+    EXPECT_TRUE( vl == 1 || vl == 8 || vl == 16 );
+    EXPECT_EQ( static_cast<int>( tuner.times().size() ), 3 );
+    for ( auto t : tuner.times() )
+        EXPECT_GE( t, 0.0 );
+
+    std::stringstream report;
+    tuner.report( report );
+    EXPECT_NE( report.str().find( "selected" ), std::string::npos );
+
+    // Create an AoSoA with the selected vector length.
+    int dispatched = 0;
+    tuner.dispatch( [&]( auto v ) {
+        using aosoa_type =
+            typename tuner_type::template aosoa_type<decltype( v )::value>;
+        aosoa_type aosoa( "aosoa", num_particle );
+        EXPECT_EQ( static_cast<int>( aosoa.size() ), num_particle );
+        dispatched = aosoa_type::vector_length;
+    } );
+    EXPECT_EQ( dispatched, vl );
+}
+
+//---------------------------------------------------------------------------//
+// RUN TESTS
+//---------------------------------------------------------------------------//
+TEST( TEST_CATEGORY, vector_length_dispatch_test ) { testDispatch(); }
+
+//---------------------------------------------------------------------------//
+TEST( TEST_CATEGORY, vector_length_tuner_test ) { testTuner(); }
+
+//---------------------------------------------------------------------------//
+
+} // end namespace Test